@@ -8,6 +8,8 @@
 #include "qv4baselineassembler_p.h"
 #include "qv4assemblercommon_p.h"
 #include <private/qv4function_p.h>
+#include <private/qv4lookup_p.h>
+#include <private/qv4memberdata_p.h>
 #include <private/qv4runtime_p.h>
 #include <private/qv4stackframe_p.h>
 
@@ -343,6 +345,54 @@ public:
         passAsArg(AccumulatorRegister, 0);
         doCall();
     }
+
+    // We can only use a managed value as heap pointer if the value encoding leaves the
+    // pointer bits where they are.
+    static constexpr bool CanInlineObjectLookups = Value::Top1Shift == 0
+            && Value::Upper3Shift == 0 && Value::Lower5Shift == 0;
+
+    // Inline version of Lookup::getter0Inline and Lookup::getter0MemberData. The lookup
+    // is re-checked at run time, so that we bail out to the generic path as soon as it has
+    // been re-targeted to a different shape or a different kind of property.
+    Jump objectLookupFastPath(const Lookup *lookup, bool inlineProperty)
+    {
+        move(TrustedImm64(Value::ManagedMask), ScratchRegister);
+        Jump notManaged = branchTest64(NonZero, AccumulatorRegister, ScratchRegister);
+        Jump isUndefined = branch64(Equal, AccumulatorRegister, TrustedImm64(0));
+
+        move(TrustedImmPtr(lookup), ScratchRegister);
+        loadPtr(Address(ScratchRegister, offsetof(Lookup, getter)), ScratchRegister2);
+        const void *expectedGetter = inlineProperty
+                ? reinterpret_cast<const void *>(&Lookup::getter0Inline)
+                : reinterpret_cast<const void *>(&Lookup::getter0MemberData);
+        Jump lookupChanged = branchPtr(NotEqual, ScratchRegister2, TrustedImmPtr(expectedGetter));
+
+        Q_STATIC_ASSERT(offsetof(Heap::Base, internalClass) == 0);
+        loadPtr(Address(AccumulatorRegister, 0), ScratchRegister2);
+        Jump otherClass = branch64(NotEqual, ScratchRegister2,
+                                   Address(ScratchRegister, offsetof(Lookup, objectLookup.ic)));
+
+        load32(Address(ScratchRegister, offsetof(Lookup, objectLookup.offset)), ScratchRegister);
+        if (inlineProperty) {
+            load64(BaseIndex(AccumulatorRegister, ScratchRegister, TimesEight), AccumulatorRegister);
+        } else {
+            Heap::Object o;
+            Q_UNUSED(o);
+            Heap::MemberData m;
+            Q_UNUSED(m);
+            loadPtr(Address(AccumulatorRegister, o.memberData.offset), AccumulatorRegister);
+            load64(BaseIndex(AccumulatorRegister, ScratchRegister, TimesEight,
+                             m.values.offset + offsetof(ValueArray<0>, values)),
+                   AccumulatorRegister);
+        }
+        Jump done = jump();
+
+        notManaged.link(this);
+        isUndefined.link(this);
+        lookupChanged.link(this);
+        otherClass.link(this);
+        return done;
+    }
 };
 
 typedef PlatformAssembler64 PlatformAssembler;
@@ -782,6 +832,15 @@ public:
         if (ArgInRegCount < 2)
             addPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
     }
+
+    // The accumulator is split over two registers here, and we are short of scratch
+    // registers to keep the base object around. Always take the generic path.
+    static constexpr bool CanInlineObjectLookups = false;
+
+    Jump objectLookupFastPath(const Lookup *, bool)
+    {
+        Q_UNREACHABLE_RETURN(Jump());
+    }
 };
 
 typedef PlatformAssembler32 PlatformAssembler;
@@ -821,9 +880,9 @@ void BaselineAssembler::generateEpilogue()
     pasm()->generateCatchTrampoline();
 }
 
-void BaselineAssembler::link(Function *function)
+void BaselineAssembler::link(Function *function, const char *jitKind)
 {
-    pasm()->link(function, "BaselineJIT");
+    pasm()->link(function, jitKind);
 }
 
 void BaselineAssembler::addLabel(int offset)
@@ -873,16 +932,70 @@ void BaselineAssembler::loadLocal(int index, int level)
     pasm()->loadAccumulator(Address(PlatformAssembler::ScratchRegister, ctx.locals.offset + offsetof(ValueArray<0>, values) + sizeof(Value)*index));
 }
 
+static void writeBarrierHelper(ExecutionEngine *engine, Heap::Base *context, Value *slot,
+                               const Value &value)
+{
+    WriteBarrier::barrier(engine, context, slot->asReturnedValue(), value.asReturnedValue());
+}
+
 void BaselineAssembler::storeLocal(int index, int level)
 {
     Heap::CallContext ctx;
     Q_UNUSED(ctx);
-    pasm()->loadPtr(regAddr(CallData::Context), PlatformAssembler::ScratchRegister);
-    while (level) {
-        pasm()->loadPtr(Address(PlatformAssembler::ScratchRegister, ctx.outer.offset), PlatformAssembler::ScratchRegister);
-        --level;
-    }
-    pasm()->storeAccumulator(Address(PlatformAssembler::ScratchRegister, ctx.locals.offset + offsetof(ValueArray<0>, values) + sizeof(Value)*index));
+    const int slotOffset = ctx.locals.offset + offsetof(ValueArray<0>, values) + sizeof(Value)*index;
+    auto loadContext = [&]() {
+        pasm()->loadPtr(regAddr(CallData::Context), PlatformAssembler::ScratchRegister);
+        for (int i = 0; i < level; ++i)
+            pasm()->loadPtr(Address(PlatformAssembler::ScratchRegister, ctx.outer.offset), PlatformAssembler::ScratchRegister);
+    };
+
+    // The context lives on the GC heap, so this store needs the write barrier.
+    // See qv4writebarrier_p.h.
+    Q_STATIC_ASSERT(sizeof(QV4::EngineBase::isWriteBarrierActive) == 1);
+    auto noBarrier = pasm()->branch8(PlatformAssembler::Equal,
+                                     Address(PlatformAssembler::EngineRegister,
+                                             offsetof(EngineBase, isWriteBarrierActive)),
+                                     TrustedImm32(0));
+    saveAccumulatorInFrame();
+    pasm()->prepareCallWithArgCount(4);
+    pasm()->passAccumulatorAsArg(3);
+    // Passing arguments on the stack goes through the scratch register, so pass the
+    // context before the slot address derived from it.
+    loadContext();
+    pasm()->passAddressAsArg(Address(PlatformAssembler::ScratchRegister, 0), 1);
+    pasm()->passAddressAsArg(Address(PlatformAssembler::ScratchRegister, slotOffset), 2);
+    pasm()->passEngineAsArg(0);
+    pasm()->PlatformAssemblerCommon::callRuntime(reinterpret_cast<void *>(&writeBarrierHelper),
+                                                 "writeBarrierHelper");
+    loadAccumulatorFromFrame();
+    noBarrier.link(pasm());
+
+    loadContext();
+    pasm()->storeAccumulator(Address(PlatformAssembler::ScratchRegister, slotOffset));
+}
+
+bool BaselineAssembler::canInlineObjectLookups()
+{
+    return PlatformAssembler::CanInlineObjectLookups;
+}
+
+void BaselineAssembler::getObjectLookup(int index, const Lookup *lookup, bool inlineProperty)
+{
+    Q_ASSERT(canInlineObjectLookups());
+    auto done = pasm()->objectLookupFastPath(lookup, inlineProperty);
+
+    // slow path:
+    saveAccumulatorInFrame();
+    pasm()->prepareCallWithArgCount(4);
+    pasm()->passInt32AsArg(index, 3);
+    pasm()->passAccumulatorAsArg(2);
+    pasm()->passFunctionAsArg(1);
+    pasm()->passEngineAsArg(0);
+    ASM_GENERATE_RUNTIME_CALL(GetLookup, CallResultDestination::InAccumulator);
+    checkException();
+
+    // done.
+    done.link(pasm());
 }
 
 void BaselineAssembler::loadString(int stringId)
@@ -40,7 +40,7 @@ public:
     // codegen infrastructure
     void generatePrologue();
     void generateEpilogue();
-    void link(Function *function);
+    void link(Function *function, const char *jitKind = "BaselineJIT");
     void addLabel(int offset);
 
     // loads/stores/moves
@@ -56,6 +56,10 @@ public:
     void storeHeapObject(int reg);
     void loadImport(int index);
 
+    // property access
+    static bool canInlineObjectLookups();
+    void getObjectLookup(int index, const Lookup *lookup, bool inlineProperty);
+
     // numeric ops
     void unot();
     void toNumber();
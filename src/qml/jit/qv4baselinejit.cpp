@@ -13,9 +13,10 @@ using namespace QV4;
 using namespace QV4::JIT;
 using namespace QV4::Moth;
 
-BaselineJIT::BaselineJIT(Function *function)
+BaselineJIT::BaselineJIT(Function *function, Tier tier)
     : function(function)
       , as(new BaselineAssembler(&(function->compilationUnit->constants->asValue<Value>())))
+      , tier(tier)
 {}
 
 BaselineJIT::~BaselineJIT()
@@ -36,7 +37,22 @@ void BaselineJIT::generate()
     decode(code, len);
     as->generateEpilogue();
 
-    as->link(function);
+    if (tier == Optimizing) {
+        function->isOptimized = true;
+
+        // Nothing to specialize on. The baseline code is as good as it gets.
+        if (specializedSites == 0)
+            return;
+
+        // The baseline code may still be running further up the stack. Keep it alive until
+        // the function is destroyed.
+        Q_ASSERT(!function->baselineCodeRef);
+        function->baselineCodeRef = function->codeRef;
+        function->codeRef = nullptr;
+        as->link(function, "OptimizingJIT");
+    } else {
+        as->link(function);
+    }
 //    qDebug()<<"done";
 }
 
@@ -254,9 +270,30 @@ void BaselineJIT::generate_LoadOptionalProperty(int name, int offset)
     generate_LoadProperty(name);
 }
 
+bool BaselineJIT::generateSpecializedGetLookup(int index)
+{
+    if (tier != Optimizing || !BaselineAssembler::canInlineObjectLookups())
+        return false;
+
+    // Only monomorphic own-property lookups have a shape we can check inline. Lookups that have
+    // not been resolved yet, or that have seen several shapes, go through the generic path.
+    const Lookup *l = function->executableCompilationUnit()->runtimeLookups + index;
+    if (l->getter == Lookup::getter0Inline)
+        as->getObjectLookup(index, l, true);
+    else if (l->getter == Lookup::getter0MemberData)
+        as->getObjectLookup(index, l, false);
+    else
+        return false;
+
+    ++specializedSites;
+    return true;
+}
+
 void BaselineJIT::generate_GetLookup(int index)
 {
     STORE_IP();
+    if (generateSpecializedGetLookup(index))
+        return;
     STORE_ACC();
     as->prepareCallWithArgCount(4);
     as->passInt32AsArg(index, 3);
@@ -33,7 +33,15 @@ class BaselineAssembler;
 class BaselineJIT final: public Moth::ByteCodeHandler
 {
 public:
-    BaselineJIT(QV4::Function *);
+    enum Tier {
+        // Generic code, emitted when the function is first found to be warm.
+        Baseline,
+        // Recompilation of hot functions, specialized on the type feedback gathered in their
+        // lookups. Any failed guard falls back to the generic code path of the baseline tier.
+        Optimizing
+    };
+
+    BaselineJIT(QV4::Function *, Tier tier = Baseline);
     ~BaselineJIT() override;
 
     void generate();
@@ -177,9 +185,13 @@ public:
     void endInstruction(Moth::Instr::Type instr) override;
 
 private:
+    bool generateSpecializedGetLookup(int index);
+
     QV4::Function *function;
     QScopedPointer<BaselineAssembler> as;
     QSet<int> labels;
+    Tier tier;
+    int specializedSites = 0;
 };
 
 } // namespace JIT
@@ -210,6 +210,9 @@ struct Q_QML_EXPORT SparseArrayData : public ArrayData
     V4_ARRAYDATA(SparseArrayData)
     V4_INTERNALCLASS(SparseArrayData)
     V4_NEEDS_DESTROY
+    enum {
+        IsDestroyThreadSafe = true
+    };
 
     SparseArray *sparse() const { return d()->sparse; }
     void setSparse(SparseArray *s) { d()->sparse = s; }
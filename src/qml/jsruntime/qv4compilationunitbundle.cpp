@@ -0,0 +1,321 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4compilationunitbundle_p.h"
+
+#include <private/qv4compileddata_p.h>
+
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qsavefile.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QV4;
+
+static constexpr quint32 UnitAlignment = 16;
+
+static quint32 alignedOffset(quint64 offset)
+{
+    return quint32((offset + UnitAlignment - 1) & ~quint64(UnitAlignment - 1));
+}
+
+/*!
+    \internal
+
+    FNV-1a with a final avalanche step, so that different seeds give
+    independent distributions. This has to stay stable as it is baked into
+    bundle files.
+*/
+quint32 CompilationUnitBundle::hash(QByteArrayView url, quint32 seed)
+{
+    quint32 h = 0x811c9dc5u ^ seed;
+    for (char c : url) {
+        h ^= quint8(c);
+        h *= 0x01000193u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+/*!
+    \internal
+
+    Maps the bundle \a fileName. The source files of the bundled local files are
+    looked up once here, so that find() can report their modification times without
+    touching the file system again. Callers should not hold any locks.
+*/
+std::unique_ptr<CompilationUnitBundle> CompilationUnitBundle::open(
+        const QString &fileName, QString *errorString)
+{
+    std::unique_ptr<CompilationUnitBundle> bundle(new CompilationUnitBundle);
+    QFile &file = bundle->m_file;
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = file.errorString();
+        return nullptr;
+    }
+
+    const qint64 fileSize = file.size();
+    if (fileSize < qint64(sizeof(BundleHeader))) {
+        *errorString = QStringLiteral("File too small for the header fields");
+        return nullptr;
+    }
+
+    // The bundle is never unmapped, like the .qmlc files mapped with the StaticData flag.
+    const uchar *data = file.map(0, fileSize);
+    if (!data) {
+        *errorString = file.errorString();
+        return nullptr;
+    }
+
+    const BundleHeader *header = reinterpret_cast<const BundleHeader *>(data);
+    if (memcmp(header->magic, BundleHeader::Magic, sizeof(BundleHeader::Magic)) != 0) {
+        *errorString = QStringLiteral("Magic bytes in the header do not match");
+        return nullptr;
+    }
+    if (header->version != BundleHeader::CurrentVersion) {
+        *errorString = QStringLiteral("Bundle format version mismatch. Found %1 expected %2")
+                .arg(quint32(header->version)).arg(BundleHeader::CurrentVersion);
+        return nullptr;
+    }
+    if (header->fileSize != quint64(fileSize)) {
+        *errorString = QStringLiteral("File size does not match the header");
+        return nullptr;
+    }
+
+    const quint64 count = header->entryCount;
+    if (count == 0
+            || header->entryTableOffset + count * sizeof(BundleEntry) > quint64(fileSize)
+            || header->displacementTableOffset + count * sizeof(qint32_le) > quint64(fileSize)) {
+        *errorString = QStringLiteral("Index tables are out of bounds");
+        return nullptr;
+    }
+
+    const BundleEntry *entries
+            = reinterpret_cast<const BundleEntry *>(data + header->entryTableOffset);
+    bundle->m_cachedUnits.resize(count);
+    bundle->m_sourceTimeStamps.resize(count);
+    for (quint32 i = 0; i < count; ++i) {
+        const BundleEntry &entry = entries[i];
+        if (quint64(entry.urlOffset) + entry.urlSize > quint64(fileSize)
+                || quint64(entry.unitOffset) + entry.unitSize > quint64(fileSize)
+                || entry.unitOffset % UnitAlignment != 0
+                || entry.unitSize < sizeof(CompiledData::Unit)) {
+            *errorString = QStringLiteral("Entry %1 is out of bounds").arg(i);
+            return nullptr;
+        }
+
+        const CompiledData::Unit *unit
+                = reinterpret_cast<const CompiledData::Unit *>(data + entry.unitOffset);
+        if (unit->unitSize > entry.unitSize) {
+            *errorString = QStringLiteral("Compilation unit of entry %1 is truncated").arg(i);
+            return nullptr;
+        }
+        bundle->m_cachedUnits[i] = { unit, nullptr, nullptr };
+
+        // Without the source, the bundle is all there is and its unit is current.
+        if (unit->sourceTimeStamp) {
+            const QUrl url(QString::fromUtf8(
+                    reinterpret_cast<const char *>(data + entry.urlOffset), entry.urlSize));
+            if (url.isLocalFile()) {
+                const QFileInfo source(url.toLocalFile());
+                bundle->m_sourceTimeStamps[i] = source.exists()
+                        ? source.lastModified()
+                        : QDateTime::fromMSecsSinceEpoch(unit->sourceTimeStamp);
+            }
+        }
+    }
+
+    bundle->m_data = data;
+    bundle->m_header = header;
+    bundle->m_entries = entries;
+    bundle->m_displacements
+            = reinterpret_cast<const qint32_le *>(data + header->displacementTableOffset);
+    return bundle;
+}
+
+/*!
+    \internal
+
+    Returns the unit stored for \a url, or nullptr if the bundle does not
+    contain it. The header of the unit is not verified here; that's up to the
+    caller, just like for compilation units linked into the binary. If given,
+    \a sourceTimeStamp is set to the time stamp to verify the header with: the
+    modification time of a local source file when the bundle was opened, and an
+    invalid QDateTime otherwise.
+*/
+const QQmlPrivate::CachedQmlUnit *CompilationUnitBundle::find(
+        const QUrl &url, QDateTime *sourceTimeStamp) const
+{
+    const QByteArray key = url.toString().toUtf8();
+    const quint32 count = m_header->entryCount;
+    const qint32 displacement = m_displacements[hash(key, 0) % count];
+    const quint32 index = displacement < 0
+            ? quint32(-displacement - 1)
+            : hash(key, quint32(displacement)) % count;
+    if (index >= count)
+        return nullptr;
+
+    const BundleEntry &entry = m_entries[index];
+    if (QByteArrayView(m_data + entry.urlOffset, entry.urlSize) != key)
+        return nullptr;
+    if (sourceTimeStamp)
+        *sourceTimeStamp = m_sourceTimeStamps[index];
+    return &m_cachedUnits[index];
+}
+
+bool CompilationUnitBundle::write(
+        const QString &fileName, const QList<Unit> &units, QString *errorString)
+{
+    const quint32 count = quint32(units.size());
+    if (count == 0) {
+        *errorString = QStringLiteral("No compilation units to bundle");
+        return false;
+    }
+
+    std::vector<QByteArray> keys;
+    keys.reserve(count);
+    for (const Unit &unit : units)
+        keys.push_back(unit.url.toUtf8());
+
+    std::vector<QByteArray> sortedKeys = keys;
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+    const auto duplicate = std::adjacent_find(sortedKeys.begin(), sortedKeys.end());
+    if (duplicate != sortedKeys.end()) {
+        *errorString = QStringLiteral("Duplicate URL %1").arg(QString::fromUtf8(*duplicate));
+        return false;
+    }
+
+    // Hash and displace: Place the largest buckets first, trying seeds until all
+    // their keys land on free slots. Buckets with a single key take any free slot.
+    std::vector<std::vector<quint32>> buckets(count);
+    for (quint32 i = 0; i < count; ++i)
+        buckets[hash(keys[i], 0) % count].push_back(i);
+
+    std::vector<quint32> order(count);
+    for (quint32 i = 0; i < count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](quint32 a, quint32 b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<qint32> displacements(count, 0);
+    std::vector<qint64> slots(count, -1); // unit index per slot
+    std::vector<quint32> candidate;
+    for (quint32 bucketIndex : order) {
+        const std::vector<quint32> &bucket = buckets[bucketIndex];
+        if (bucket.size() <= 1)
+            break;
+
+        for (qint32 seed = 1;; ++seed) {
+            if (seed == std::numeric_limits<qint32>::max()) {
+                *errorString = QStringLiteral("Cannot build the URL index");
+                return false;
+            }
+
+            candidate.clear();
+            for (quint32 unitIndex : bucket) {
+                const quint32 slot = hash(keys[unitIndex], quint32(seed)) % count;
+                if (slots[slot] != -1
+                        || std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+
+            if (candidate.size() == bucket.size()) {
+                for (size_t i = 0; i < bucket.size(); ++i)
+                    slots[candidate[i]] = bucket[i];
+                displacements[bucketIndex] = seed;
+                break;
+            }
+        }
+    }
+
+    quint32 freeSlot = 0;
+    for (quint32 bucketIndex : order) {
+        const std::vector<quint32> &bucket = buckets[bucketIndex];
+        if (bucket.size() != 1)
+            continue;
+        while (slots[freeSlot] != -1)
+            ++freeSlot;
+        slots[freeSlot] = bucket.front();
+        displacements[bucketIndex] = -qint32(freeSlot) - 1;
+    }
+
+    // Lay out the file
+    const quint64 entryTableOffset = sizeof(BundleHeader);
+    const quint64 displacementTableOffset = entryTableOffset + count * sizeof(BundleEntry);
+    quint64 offset = displacementTableOffset + count * sizeof(qint32_le);
+
+    std::vector<BundleEntry> entries(count);
+    for (quint32 slot = 0; slot < count; ++slot) {
+        const QByteArray &key = keys[slots[slot]];
+        entries[slot].urlOffset = quint32(offset);
+        entries[slot].urlSize = quint32(key.size());
+        offset += key.size();
+    }
+    for (quint32 slot = 0; slot < count; ++slot) {
+        const QByteArray &data = units[slots[slot]].data;
+        if (data.size() < qsizetype(sizeof(CompiledData::Unit))) {
+            *errorString = QStringLiteral("Invalid compilation unit for %1")
+                    .arg(units[slots[slot]].url);
+            return false;
+        }
+        offset = alignedOffset(offset);
+        entries[slot].unitOffset = quint32(offset);
+        entries[slot].unitSize = quint32(data.size());
+        offset += data.size();
+    }
+
+    if (offset > std::numeric_limits<quint32>::max()) {
+        *errorString = QStringLiteral("Bundle exceeds 4GB");
+        return false;
+    }
+
+    BundleHeader header;
+    memcpy(header.magic, BundleHeader::Magic, sizeof(BundleHeader::Magic));
+    header.version = BundleHeader::CurrentVersion;
+    header.entryCount = count;
+    header.entryTableOffset = quint32(entryTableOffset);
+    header.displacementTableOffset = quint32(displacementTableOffset);
+    header.fileSize = offset;
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    QByteArray contents;
+    contents.reserve(offset);
+    contents.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    contents.append(reinterpret_cast<const char *>(entries.data()), count * sizeof(BundleEntry));
+    for (qint32 displacement : displacements) {
+        const qint32_le value = displacement;
+        contents.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    for (quint32 slot = 0; slot < count; ++slot)
+        contents.append(keys[slots[slot]]);
+    for (quint32 slot = 0; slot < count; ++slot) {
+        contents.append(entries[slot].unitOffset - contents.size(), '\0');
+        contents.append(units[slots[slot]].data);
+    }
+    Q_ASSERT(quint64(contents.size()) == offset);
+
+    if (file.write(contents) != contents.size() || !file.commit()) {
+        *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
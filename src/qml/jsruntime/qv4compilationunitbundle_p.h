@@ -0,0 +1,107 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4COMPILATIONUNITBUNDLE_P_H
+#define QV4COMPILATIONUNITBUNDLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4global_p.h>
+#include <qqmlprivate.h>
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qurl.h>
+
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+/*
+    A bundle holds the compilation units of all QML and JavaScript files of a
+    module or an application in a single file, so that they can be mapped into
+    memory at once instead of opening and mapping one .qmlc file per document.
+
+    The file starts with a BundleHeader, followed by the index of BundleEntry
+    structures and the displacement table of a perfect hash over the URLs. The
+    UTF-8 encoded URLs and the units follow, each unit aligned to 16 bytes.
+    A URL is looked up by hashing it with seed 0 to select a displacement. A
+    negative displacement d directly names the index entry -d - 1. Otherwise
+    the URL is hashed again with d as seed to find the entry.
+*/
+struct BundleHeader
+{
+    static constexpr char Magic[8] = { 'q', 'v', '4', 'b', 'n', 'd', 'l', '\0' };
+    static constexpr quint32 CurrentVersion = 1;
+
+    char magic[8];
+    quint32_le version;
+    quint32_le entryCount;
+    quint32_le entryTableOffset;
+    quint32_le displacementTableOffset;
+    quint64_le fileSize;
+};
+static_assert(sizeof(BundleHeader) == 32, "BundleHeader structure needs to have the expected size");
+
+struct BundleEntry
+{
+    quint32_le urlOffset;
+    quint32_le urlSize;
+    quint32_le unitOffset;
+    quint32_le unitSize;
+};
+static_assert(sizeof(BundleEntry) == 16, "BundleEntry structure needs to have the expected size");
+
+class Q_QML_PRIVATE_EXPORT CompilationUnitBundle
+{
+    Q_DISABLE_COPY_MOVE(CompilationUnitBundle)
+public:
+    struct Unit
+    {
+        QString url;
+        QByteArray data;
+    };
+
+    static std::unique_ptr<CompilationUnitBundle> open(
+            const QString &fileName, QString *errorString);
+    static bool write(const QString &fileName, const QList<Unit> &units, QString *errorString);
+
+    static quint32 hash(QByteArrayView url, quint32 seed);
+
+    QString fileName() const { return m_file.fileName(); }
+    int size() const { return int(m_cachedUnits.size()); }
+
+    const QQmlPrivate::CachedQmlUnit *find(const QUrl &url,
+                                           QDateTime *sourceTimeStamp = nullptr) const;
+
+private:
+    CompilationUnitBundle() = default;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    const BundleHeader *m_header = nullptr;
+    const BundleEntry *m_entries = nullptr;
+    const qint32_le *m_displacements = nullptr;
+    std::vector<QQmlPrivate::CachedQmlUnit> m_cachedUnits;
+    std::vector<QDateTime> m_sourceTimeStamps; // of local sources, when opened
+};
+
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QV4COMPILATIONUNITBUNDLE_P_H
@@ -46,6 +46,7 @@
 #include <qv4jsonobject_p.h>
 #include <qv4stringobject_p.h>
 #include <qv4identifiertable_p.h>
+#include <qv4lookup_p.h>
 #include "qv4debugging_p.h"
 #include "qv4profiling_p.h"
 #include "qv4executableallocator_p.h"
@@ -108,6 +109,7 @@ using namespace QV4;
 static QBasicAtomicInt engineSerial = Q_BASIC_ATOMIC_INITIALIZER(1);
 int ExecutionEngine::s_maxCallDepth = -1;
 int ExecutionEngine::s_jitCallCountThreshold = 3;
+int ExecutionEngine::s_jitOptimizeCallCountThreshold = 1000;
 int ExecutionEngine::s_maxJSStackSize = 4 * 1024 * 1024;
 int ExecutionEngine::s_maxGCStackSize = 2 * 1024 * 1024;
 
@@ -316,6 +318,14 @@ void ExecutionEngine::initializeStaticMembers()
     if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER"))
         s_jitCallCountThreshold = std::numeric_limits<int>::max();
 
+    ok = false;
+    s_jitOptimizeCallCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_OPTIMIZE_THRESHOLD",
+                                                                   &ok);
+    if (!ok)
+        s_jitOptimizeCallCountThreshold = 1000;
+    if (s_jitOptimizeCallCountThreshold < 0)
+        s_jitOptimizeCallCountThreshold = std::numeric_limits<int>::max();
+
     qMetaTypeId<QJSValue>();
     qMetaTypeId<QList<int> >();
 
@@ -339,6 +349,7 @@ ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
     , publicEngine(jsEngine)
     , m_engineId(engineSerial.fetchAndAddOrdered(2))
     , regExpCache(nullptr)
+    , megamorphicLookupCache(new MegamorphicLookupCache)
     , m_multiplyWrappedQObjects(nullptr)
 #if QT_CONFIG(qml_jit)
     , m_canAllocateExecutableMemory(OSAllocator::canAllocateExecutableMemory())
@@ -862,8 +873,13 @@ ExecutionEngine::~ExecutionEngine()
     while (!compilationUnits.isEmpty())
         (*compilationUnits.begin())->unlink();
 
+    static const bool lookupStats = qEnvironmentVariableIsSet("QV4_LOOKUP_STATS");
+    if (lookupStats)
+        megamorphicLookupCache->dumpStatistics();
+
     delete bumperPointerAllocator;
     delete regExpCache;
+    delete megamorphicLookupCache;
     delete regExpAllocator;
     delete executableAllocator;
     jsStack->deallocate();
@@ -2204,6 +2220,8 @@ static ExecutionEngine::DiskCacheOptions transFormDiskCache(const char *v)
             result |= DiskCache::QmlcWrite;
         else if (option == "qmlc")
             result |= DiskCache::Qmlc;
+        else if (option == "jit-profile")
+            result |= DiskCache::JitProfile;
         else
             qWarning() << "Ignoring unknown option to QML_DISK_CACHE:" << option;
     }
@@ -145,6 +145,7 @@ public:
         AotNative   = 1 << 1,
         QmlcRead    = 1 << 2,
         QmlcWrite   = 1 << 3,
+        JitProfile  = 1 << 4,
         Aot         = AotByteCode | AotNative,
         Qmlc        = QmlcRead | QmlcWrite,
         Enabled     = Aot | Qmlc,
@@ -493,6 +494,7 @@ public:
     quint32 m_engineId;
 
     RegExpCache *regExpCache;
+    MegamorphicLookupCache *megamorphicLookupCache;
 
     // Scarce resources are "exceptionally high cost" QVariant types where allowing the
     // normal JavaScript GC to clean them up is likely to lead to out-of-memory or other
@@ -690,6 +692,27 @@ public:
 #endif
     }
 
+    // Functions found to be hot in a previous run don't need to warm up in the interpreter again.
+    void markForJIT(Function *f)
+    {
+#if QT_CONFIG(qml_jit)
+        if (s_jitCallCountThreshold != std::numeric_limits<int>::max())
+            f->interpreterCallCount = std::max(f->interpreterCallCount, s_jitCallCountThreshold);
+#else
+        Q_UNUSED(f);
+#endif
+    }
+
+    bool canOptimize(Function *f)
+    {
+#if QT_CONFIG(qml_jit)
+        return f->jittedCallCount >= s_jitOptimizeCallCountThreshold;
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
     QV4::ReturnedValue global();
     void initQmlGlobalObject();
     void initializeGlobal();
@@ -766,6 +789,14 @@ public:
     static void setMaxCallDepth(int maxCallDepth) { s_maxCallDepth = maxCallDepth; }
     static int maxCallDepth() { return s_maxCallDepth; }
 
+    // Initialized from QV4_JIT_OPTIMIZE_THRESHOLD when the first engine is created
+    static void setJitOptimizeCallCountThreshold(int threshold)
+    {
+        s_jitOptimizeCallCountThreshold = threshold < 0 ? std::numeric_limits<int>::max()
+                                                        : threshold;
+    }
+    static int jitOptimizeCallCountThreshold() { return s_jitOptimizeCallCountThreshold; }
+
     template<typename Value>
     static QJSPrimitiveValue createPrimitive(const Value &v)
     {
@@ -827,6 +858,7 @@ private:
 
     static int s_maxCallDepth;
     static int s_jitCallCountThreshold;
+    static int s_jitOptimizeCallCountThreshold;
     static int s_maxJSStackSize;
     static int s_maxGCStackSize;
 
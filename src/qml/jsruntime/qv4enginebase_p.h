@@ -45,7 +45,8 @@ struct Q_QML_EXPORT EngineBase {
 
     quint8 isExecutingInRegExpJIT = false;
     quint8 isInitialized = false;
-    quint8 padding[2];
+    quint8 isGCOngoing = false; // an incremental GC is marking
+    quint8 isWriteBarrierActive = false; // isGCOngoing, or the generational GC records stores
     MemoryManager *memoryManager = nullptr;
 
     union {
@@ -27,6 +27,8 @@
 #include <QtQml/qqmlpropertymap.h>
 
 #include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
 #include <QtCore/qstandardpaths.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qscopeguard.h>
@@ -235,6 +237,9 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
                              ? data->indexOfRootFunction : 0);
     }
 
+    if (engine->diskCacheOptions() & ExecutionEngine::DiskCache::JitProfile)
+        loadJitProfile();
+
     if (data->indexOfRootFunction != -1)
         return runtimeFunctions[data->indexOfRootFunction];
     else
@@ -295,6 +300,9 @@ void ExecutableCompilationUnit::unlink()
     qDeleteAll(resolvedTypes);
     resolvedTypes.clear();
 
+    if (engine && (engine->diskCacheOptions() & ExecutionEngine::DiskCache::JitProfile))
+        saveJitProfile();
+
     engine = nullptr;
     qmlEngine = nullptr;
 
@@ -891,6 +899,134 @@ bool ExecutableCompilationUnit::saveToDisk(const QUrl &unitUrl, QString *errorSt
     });
 }
 
+namespace {
+struct JitProfileHeader
+{
+    enum : quint32 { Magic = 0x7066746a, Version = 1 };
+
+    quint32_le magic;
+    quint32_le version;
+    char md5Checksum[16];
+    quint32_le functionCount;
+};
+static_assert(sizeof(JitProfileHeader) == 28);
+}
+
+QString ExecutableCompilationUnit::jitProfileFilePath(const QUrl &url)
+{
+    return localCacheFilePath(url) + QLatin1String(".jitprofile");
+}
+
+/*!
+    \internal
+    Reads the indices of the functions listed in the JIT profile at \a path into \a indices.
+    Returns \c false, and leaves \a indices alone, if the file cannot be read, is truncated, has a
+    different format, or was written for a compilation unit with a different \a md5Checksum or
+    fewer than \a functionCount functions.
+ */
+bool ExecutableCompilationUnit::readJitProfile(
+        const QString &path, const char *md5Checksum, quint32 functionCount,
+        QList<quint32> *indices)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    JitProfileHeader header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)
+            || header.magic != JitProfileHeader::Magic
+            || header.version != JitProfileHeader::Version
+            || memcmp(header.md5Checksum, md5Checksum, sizeof(header.md5Checksum)) != 0
+            || header.functionCount > functionCount) {
+        return false;
+    }
+
+    QList<quint32_le> listed(header.functionCount);
+    const qint64 size = listed.size() * qint64(sizeof(quint32_le));
+    if (file.read(reinterpret_cast<char *>(listed.data()), size) != size)
+        return false;
+
+    for (quint32 index : std::as_const(listed)) {
+        if (index >= functionCount)
+            return false;
+    }
+
+    *indices = QList<quint32>(listed.cbegin(), listed.cend());
+    return true;
+}
+
+/*!
+    \internal
+    Writes \a indices as the JIT profile of the compilation unit with the given \a md5Checksum
+    to \a path. The file is replaced atomically.
+ */
+bool ExecutableCompilationUnit::writeJitProfile(
+        const QString &path, const char *md5Checksum, const QList<quint32> &indices)
+{
+    JitProfileHeader header;
+    header.magic = JitProfileHeader::Magic;
+    header.version = JitProfileHeader::Version;
+    memcpy(header.md5Checksum, md5Checksum, sizeof(header.md5Checksum));
+    header.functionCount = quint32(indices.size());
+
+    const QList<quint32_le> listed(indices.cbegin(), indices.cend());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(listed.constData()),
+               listed.size() * qint64(sizeof(quint32_le)));
+    return file.commit();
+}
+
+/*!
+    \internal
+    Reads the list of functions that were JIT-compiled in a previous run of the same compilation
+    unit, and lets them skip the interpreter. The profile is only used if the checksum of the
+    compilation unit matches.
+ */
+void ExecutableCompilationUnit::loadJitProfile()
+{
+    if (!engine->canJIT() || !QQmlFile::isLocalFile(url()))
+        return;
+
+    if (!readJitProfile(jitProfileFilePath(url()), data->md5Checksum,
+                        quint32(runtimeFunctions.size()), &jitProfile)) {
+        return;
+    }
+
+    for (quint32 index : std::as_const(jitProfile))
+        engine->markForJIT(runtimeFunctions[index]);
+}
+
+/*!
+    \internal
+    Records which functions have been JIT-compiled so far, in addition to the ones that were
+    already listed in the profile loaded at startup.
+ */
+void ExecutableCompilationUnit::saveJitProfile() const
+{
+    if (!QQmlFile::isLocalFile(url()))
+        return;
+
+    std::vector<bool> hot(runtimeFunctions.size());
+    for (quint32 index : jitProfile)
+        hot[index] = true;
+
+    QList<quint32> indices;
+    for (int i = 0, end = runtimeFunctions.size(); i < end; ++i) {
+        if (hot[i] || runtimeFunctions[i]->codeRef)
+            indices.append(quint32(i));
+    }
+
+    // Nothing new since the profile was loaded
+    if (indices.size() == jitProfile.size())
+        return;
+
+    writeJitProfile(jitProfileFilePath(url()), data->md5Checksum, indices);
+}
+
 /*!
     \internal
     This function creates a temporary key vector and sorts it to guarantuee a stable
@@ -122,6 +122,11 @@ public:
     // lookups by string (property name).
     QVector<BindingPropertyData> bindingPropertyDataPerObject;
 
+    // Literal values of bindings, converted to the types of their properties
+    // when the first object is created, so that later instantiations only
+    // copy them. Filled in by QQmlObjectCreator.
+    QHash<const CompiledData::Binding *, QVariant> convertedLiterals;
+
     // mapping from component object index (CompiledData::Unit object index that points to component) to identifier hash of named objects
     // this is initialized on-demand by QQmlContextData
     QHash<int, IdentifierHash> namedObjectsPerComponentCache;
@@ -153,6 +158,9 @@ public:
 
     std::unique_ptr<CompilationUnitMapper> backingFile;
 
+    // Indices of the functions listed as hot in the JIT profile loaded from disk.
+    QList<quint32> jitProfile;
+
     // --- interface for QQmlPropertyCacheCreator
     using CompiledObject = const CompiledData::Object;
     using CompiledFunction = const CompiledData::Function;
@@ -283,6 +291,14 @@ public:
     static QString localCacheFilePath(const QUrl &url);
     bool saveToDisk(const QUrl &unitUrl, QString *errorString);
 
+    static QString jitProfileFilePath(const QUrl &url);
+    static bool readJitProfile(const QString &path, const char *md5Checksum,
+                               quint32 functionCount, QList<quint32> *indices);
+    static bool writeJitProfile(const QString &path, const char *md5Checksum,
+                                const QList<quint32> &indices);
+    void loadJitProfile();
+    void saveJitProfile() const;
+
     QString bindingValueAsString(const CompiledData::Binding *binding) const;
 
     struct TranslationDataIndex
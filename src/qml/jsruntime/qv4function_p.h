@@ -74,15 +74,19 @@ public:
     typedef ReturnedValue (*JittedCode)(CppStackFrame *, ExecutionEngine *);
     JittedCode jittedCode;
     JSC::MacroAssemblerCodeRef *codeRef;
+    // The baseline code, kept alive once the optimizing JIT has replaced it.
+    JSC::MacroAssemblerCodeRef *baselineCodeRef = nullptr;
     const QQmlPrivate::TypedFunction *typedFunction = nullptr;
 
     // first nArguments names in internalClass are the actual arguments
     Heap::InternalClass *internalClass;
     int interpreterCallCount = 0;
+    int jittedCallCount = 0;
     quint16 nFormals;
     enum Kind : quint8 { JsUntyped, JsTyped, AotCompiled, Eval };
     Kind kind = JsUntyped;
     bool detectedInjectedParameters = false;
+    bool isOptimized = false;
 
     static Function *create(ExecutionEngine *engine, ExecutableCompilationUnit *unit,
                             const CompiledData::Function *function,
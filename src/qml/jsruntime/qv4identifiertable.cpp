@@ -9,6 +9,16 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+// The table holds its entries weakly. An identifier handed out while an incremental
+// collection is marking has to be kept alive, as its new users may not be scanned.
+static inline Heap::StringOrSymbol *markIfGCOngoing(ExecutionEngine *engine,
+                                                   Heap::StringOrSymbol *e)
+{
+    if (Q_UNLIKELY(engine->isGCOngoing))
+        WriteBarrier::markBarrier(engine, e);
+    return e;
+}
+
 IdentifierTable::IdentifierTable(ExecutionEngine *engine, int numBits)
     : engine(engine)
     , size(0)
@@ -116,7 +126,7 @@ Heap::String *IdentifierTable::resolveStringEntry(const QString &s, uint hash, u
     uint idx = hash % alloc;
     while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
         if (e->stringHash == hash && e->toQString() == s)
-            return static_cast<Heap::String *>(e);
+            return static_cast<Heap::String *>(markIfGCOngoing(engine, e));
         ++idx;
         idx %= alloc;
     }
@@ -137,7 +147,7 @@ Heap::Symbol *IdentifierTable::insertSymbol(const QString &s)
     uint idx = hash % alloc;
     while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
         if (e->stringHash == hash && e->toQString() == s)
-            return static_cast<Heap::Symbol *>(e);
+            return static_cast<Heap::Symbol *>(markIfGCOngoing(engine, e));
         ++idx;
         idx %= alloc;
     }
@@ -164,6 +174,7 @@ PropertyKey IdentifierTable::asPropertyKeyImpl(const Heap::String *str)
     uint idx = hash % alloc;
     while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
         if (e->stringHash == hash && e->toQString() == str->toQString()) {
+            markIfGCOngoing(engine, e);
             str->identifier = e->identifier;
             return e->identifier;
         }
@@ -185,8 +196,10 @@ Heap::StringOrSymbol *IdentifierTable::resolveId(PropertyKey i) const
     uint idx = i.id() % alloc;
     while (1) {
         Heap::StringOrSymbol *e = entriesById[idx];
-        if (!e || e->identifier == i)
+        if (!e)
             return e;
+        if (e->identifier == i)
+            return markIfGCOngoing(engine, e);
         ++idx;
         idx %= alloc;
     }
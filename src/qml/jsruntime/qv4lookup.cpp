@@ -240,6 +240,20 @@ ReturnedValue Lookup::getterProto(Lookup *l, ExecutionEngine *engine, const Valu
     return getterTwoClasses(l, engine, object);
 }
 
+static void setupPolymorphicLookup(Lookup *l, bool firstIsInline, bool secondIsInline)
+{
+    PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+    cache->entries[0] = { l->objectLookupTwoClasses.ic, l->objectLookupTwoClasses.offset,
+                          firstIsInline };
+    cache->entries[1] = { l->objectLookupTwoClasses.ic2, l->objectLookupTwoClasses.offset2,
+                          secondIsInline };
+    cache->count = 2;
+
+    l->clear();
+    l->polymorphicLookup.cache = cache;
+    l->getter = Lookup::getterPolymorphic;
+}
+
 ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     // we can safely cast to a QV4::Object here. If object is actually a string,
@@ -251,8 +265,8 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *eng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset2)->asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    setupPolymorphicLookup(l, true, true);
+    return getterPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -266,8 +280,8 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    setupPolymorphicLookup(l, true, false);
+    return getterPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -281,10 +295,119 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEng
         if (l->objectLookupTwoClasses.ic2 == o->internalClass)
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
     }
-    l->getter = getterFallback;
+    setupPolymorphicLookup(l, false, false);
+    return getterPolymorphic(l, engine, object);
+}
+
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    MegamorphicLookupCache::Statistics &statistics = engine->megamorphicLookupCache->statistics;
+
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    PolymorphicLookupCache *cache = l->polymorphicLookup.cache;
+    if (o) {
+        for (uint i = 0; i < cache->count; ++i) {
+            const PolymorphicLookupCache::Entry &entry = cache->entries[i];
+            if (entry.ic == o->internalClass) {
+                ++statistics.polymorphicHits;
+                return entry.isInline
+                        ? o->inlinePropertyDataWithOffset(entry.offset)->asReturnedValue()
+                        : o->memberData->values.data()[entry.offset].asReturnedValue();
+            }
+        }
+    }
+    ++statistics.polymorphicMisses;
+
+    // Too many shapes, or not all of them own data properties.
+    auto toMegamorphic = [l]() {
+        l->releasePropertyCache();
+        l->clear();
+        l->getter = getterMegamorphic;
+    };
+
+    const Object *obj = object.as<Object>();
+    if (!obj || cache->count == PolymorphicLookupCache::MaxEntries) {
+        toMegamorphic();
+        return getterMegamorphic(l, engine, object);
+    }
+
+    // Resolve on a second lookup, and add the result if it's another own data property.
+    Lookup second;
+    memset(&second, 0, sizeof(Lookup));
+    second.nameIndex = l->nameIndex;
+    second.forCall = l->forCall;
+    second.getter = getterGeneric;
+    const ReturnedValue result = second.resolveGetter(engine, obj);
+
+    if (second.getter == getter0Inline || second.getter == getter0MemberData) {
+        cache->entries[cache->count++] = {
+            second.objectLookup.ic, second.objectLookup.offset, second.getter == getter0Inline
+        };
+    } else {
+        second.releasePropertyCache();
+        toMegamorphic();
+    }
+    return result;
+}
+
+ReturnedValue Lookup::getterMegamorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    MegamorphicLookupCache *cache = engine->megamorphicLookupCache;
+
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match any entry, as we only add objects.
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        const PropertyKey name = engine->identifierTable->asPropertyKey(
+                engine->currentStackFrame->v4Function->compilationUnit->runtimeStrings[l->nameIndex]);
+        MegamorphicLookupCache::Entry *entry = cache->entry(o->internalClass, name);
+        if (entry->ic == o->internalClass && entry->key == name.id()) {
+            ++cache->statistics.megamorphicHits;
+            return entry->isInline
+                    ? o->inlinePropertyDataWithOffset(entry->offset)->asReturnedValue()
+                    : o->memberData->values.data()[entry->offset].asReturnedValue();
+        }
+        ++cache->statistics.megamorphicMisses;
+
+        // Only cache plain objects. Objects with their own lookup resolution may not keep
+        // their properties in the internal class.
+        if (object.isObject() && !name.isArrayIndex()
+                && o->vtable()->resolveLookupGetter == Object::virtualResolveLookupGetter) {
+            const auto index = o->internalClass->findValueOrGetter(name);
+            if (index.isValid() && index.attrs.isData()) {
+                const uint nInline = o->vtable()->nInlineProperties;
+                entry->ic = o->internalClass;
+                entry->key = name.id();
+                entry->isInline = index.index < nInline;
+                entry->offset = entry->isInline
+                        ? index.index + o->vtable()->inlinePropertyOffset
+                        : index.index - nInline;
+                return entry->isInline
+                        ? o->inlinePropertyDataWithOffset(entry->offset)->asReturnedValue()
+                        : o->memberData->values.data()[entry->offset].asReturnedValue();
+            }
+        }
+    }
     return getterFallback(l, engine, object);
 }
 
+void Lookup::markPolymorphicCache(MarkStack *stack)
+{
+    const PolymorphicLookupCache *cache = polymorphicLookup.cache;
+    for (uint i = 0; i < cache->count; ++i)
+        cache->entries[i].ic->mark(stack);
+}
+
+void MegamorphicLookupCache::dumpStatistics() const
+{
+    qDebug() << "Lookup caches: polymorphic" << statistics.polymorphicHits << "hits,"
+             << statistics.polymorphicMisses << "misses; megamorphic"
+             << statistics.megamorphicHits << "hits," << statistics.megamorphicMisses
+             << "misses";
+}
+
 ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     // Otherwise we cannot trust the protoIds
@@ -28,6 +28,59 @@ namespace Heap {
     struct QObjectMethod;
 }
 
+// Shapes seen by a property lookup that has outgrown the two-class getters. Only own data
+// properties are cached here. The lookup owns the cache and marks the internal classes in it.
+struct PolymorphicLookupCache
+{
+    enum { MaxEntries = 8 };
+
+    struct Entry {
+        Heap::InternalClass *ic;
+        uint offset;        // as in Lookup::objectLookup
+        bool isInline;
+    };
+
+    Entry entries[MaxEntries];
+    uint count = 0;
+};
+
+// Engine-wide cache for lookups that have seen more shapes than fit into a
+// PolymorphicLookupCache. It maps (internal class, property key) to the location of an own
+// data property. It doesn't keep the internal classes alive and is cleared whenever the GC
+// sweeps internal classes.
+struct MegamorphicLookupCache
+{
+    enum { Size = 1024 };
+
+    struct Entry {
+        Heap::InternalClass *ic;
+        quint64 key;
+        uint offset;
+        bool isInline;
+    };
+
+    struct Statistics {
+        quint64 polymorphicHits = 0;
+        quint64 polymorphicMisses = 0;
+        quint64 megamorphicHits = 0;
+        quint64 megamorphicMisses = 0;
+    };
+
+    Entry entries[Size];
+    Statistics statistics;
+
+    MegamorphicLookupCache() { clear(); }
+
+    Entry *entry(const Heap::InternalClass *ic, PropertyKey key)
+    {
+        const quintptr hash = (quintptr(ic) >> 5) ^ (quintptr(key.id()) >> 5) * 31;
+        return entries + (hash & (Size - 1));
+    }
+
+    void clear() { memset(entries, 0, sizeof(entries)); }
+    void dumpStatistics() const;
+};
+
 // Note: We cannot hide the copy ctor and assignment operator of this class because it needs to
 //       be trivially copyable. But you should never ever copy it. There are refcounted members
 //       in there.
@@ -64,6 +117,11 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             uint offset;
             uint offset2;
         } objectLookupTwoClasses;
+        struct {
+            quintptr unused;
+            quintptr unused2;
+            PolymorphicLookupCache *cache;
+        } polymorphicLookup;
         struct {
             quintptr protoId;
             quintptr protoId2;
@@ -172,6 +230,8 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static ReturnedValue getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterMegamorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessorTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -203,15 +263,22 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             markDef.h1->mark(stack);
         if (markDef.h2 && !(reinterpret_cast<quintptr>(markDef.h2) & 1))
             markDef.h2->mark(stack);
+        if (getter == getterPolymorphic)
+            markPolymorphicCache(stack);
     }
 
+    void markPolymorphicCache(MarkStack *stack);
+
     void clear() {
         memset(&markDef, 0, sizeof(markDef));
     }
 
     void releasePropertyCache()
     {
-        if (getter == getterQObject
+        if (getter == getterPolymorphic) {
+            delete polymorphicLookup.cache;
+            polymorphicLookup.cache = nullptr;
+        } else if (getter == getterQObject
                 || getter == QQmlTypeWrapper::lookupSingletonProperty
                 || setter == setterQObject
                 || qmlContextPropertyGetter == QQmlContextWrapper::lookupScopeObjectProperty
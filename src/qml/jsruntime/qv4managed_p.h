@@ -79,7 +79,10 @@ struct Q_QML_PRIVATE_EXPORT Managed : Value, VTableBase
         IsObject = false,
         IsFunctionObject = false,
         IsErrorObject = false,
-        IsArrayData = false
+        IsArrayData = false,
+        // destroy() only releases memory owned by the object itself and may therefore
+        // run on a worker thread while sweeping
+        IsDestroyThreadSafe = false
     };
 private:
     void *operator new(size_t);
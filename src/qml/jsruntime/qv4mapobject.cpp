@@ -179,6 +179,7 @@ ReturnedValue WeakMapPrototype::method_delete(const FunctionObject *b, const Val
     if (!argc || !argv[0].isObject())
         return Encode(false);
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return Encode(that->d()->esTable->remove(argv[0]));
 
 }
@@ -215,7 +216,9 @@ ReturnedValue WeakMapPrototype::method_set(const FunctionObject *b, const Value
         (!argc || !argv[0].isObject()))
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     that->d()->esTable->set(argv[0], argc > 1 ? argv[1] : Value::undefinedValue());
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return that.asReturnedValue();
 }
 
@@ -227,6 +230,7 @@ ReturnedValue MapPrototype::method_clear(const FunctionObject *b, const Value *t
     if (!that || that->d()->isWeakMap)
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     that->d()->esTable->clear();
     return Encode::undefined();
 }
@@ -238,6 +242,7 @@ ReturnedValue MapPrototype::method_delete(const FunctionObject *b, const Value *
     if (!that || that->d()->isWeakMap)
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return Encode(that->d()->esTable->remove(argc ? argv[0] : Value::undefinedValue()));
 }
 
@@ -318,7 +323,9 @@ ReturnedValue MapPrototype::method_set(const FunctionObject *b, const Value *thi
     if (!that || that->d()->isWeakMap)
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     that->d()->esTable->set(argc ? argv[0] : Value::undefinedValue(), argc > 1 ? argv[1] : Value::undefinedValue());
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return that.asReturnedValue();
 }
 
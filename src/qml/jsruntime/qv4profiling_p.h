@@ -25,6 +25,7 @@
 
 #define Q_V4_PROFILE_ALLOC(engine, size, type) (!engine)
 #define Q_V4_PROFILE_DEALLOC(engine, size, type) (!engine)
+#define Q_V4_PROFILE_GC_STEP(engine, duration, type) (!engine)
 
 QT_BEGIN_NAMESPACE
 
@@ -52,6 +53,11 @@ QT_END_NAMESPACE
             (engine->profiler()->featuresEnabled & (1 << Profiling::FeatureMemoryAllocation)) ?\
         engine->profiler()->trackDealloc(size, type) : false)
 
+#define Q_V4_PROFILE_GC_STEP(engine, duration, type) \
+    (engine->profiler() &&\
+            (engine->profiler()->featuresEnabled & (1 << Profiling::FeatureMemoryAllocation)) ?\
+        engine->profiler()->trackGCStep(duration, type) : false)
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -63,10 +69,13 @@ enum Features {
     FeatureMemoryAllocation
 };
 
+// For the GC steps, the size is the duration of the step in nanoseconds.
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    GCMarkStep,
+    GCSweepStep
 };
 
 struct FunctionCallProperties {
@@ -229,6 +238,14 @@ public:
         }
     }
 
+    bool trackGCStep(qint64 duration, MemoryType type)
+    {
+        Q_ASSERT(type == GCMarkStep || type == GCSweepStep);
+        MemoryAllocationProperties step = {m_timer.nsecsElapsed(), duration, type};
+        m_memory_data.append(step);
+        return true;
+    }
+
     quint64 featuresEnabled;
 
     void stopProfiling();
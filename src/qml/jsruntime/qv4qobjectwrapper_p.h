@@ -235,7 +235,11 @@ inline ReturnedValue QObjectWrapper::wrap(ExecutionEngine *engine, QObject *obje
     auto ddata = QQmlData::get(object);
     if (Q_LIKELY(ddata && ddata->jsEngineId == engine->m_engineId && !ddata->jsWrapper.isUndefined())) {
         // We own the JS object
-        return ddata->jsWrapper.value();
+        const ReturnedValue wrapper = ddata->jsWrapper.value();
+        // The wrapper is held weakly, keep it alive if an incremental GC is marking.
+        if (Q_UNLIKELY(engine->isGCOngoing))
+            WriteBarrier::markBarrier(engine, wrapper);
+        return wrapper;
     }
 
     return wrap_slowPath(engine, object);
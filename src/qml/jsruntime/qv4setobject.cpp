@@ -105,7 +105,9 @@ ReturnedValue WeakSetPrototype::method_add(const FunctionObject *b, const Value
         (!argc || !argv[0].isObject()))
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     that->d()->esTable->set(argv[0], Value::undefinedValue());
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return that.asReturnedValue();
 }
 
@@ -118,6 +120,7 @@ ReturnedValue WeakSetPrototype::method_delete(const FunctionObject *b, const Val
     if (!argc || !argv[0].isObject())
         return Encode(false);
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return Encode(that->d()->esTable->remove(argv[0]));
 }
 
@@ -193,7 +196,9 @@ ReturnedValue SetPrototype::method_add(const FunctionObject *b, const Value *thi
     if (!that || that->d()->isWeakSet)
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     that->d()->esTable->set(argv[0], Value::undefinedValue());
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return that.asReturnedValue();
 }
 
@@ -204,6 +209,7 @@ ReturnedValue SetPrototype::method_clear(const FunctionObject *b, const Value *t
     if (!that || that->d()->isWeakSet)
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     that->d()->esTable->clear();
     return Encode::undefined();
 }
@@ -215,6 +221,7 @@ ReturnedValue SetPrototype::method_delete(const FunctionObject *b, const Value *
     if (!that || that->d()->isWeakSet)
         return scope.engine->throwTypeError();
 
+    WriteBarrier::offHeapWrite(scope.engine, that->d());
     return Encode(that->d()->esTable->remove(argv[0]));
 }
 
@@ -140,7 +140,8 @@ struct Q_QML_PRIVATE_EXPORT StringOrSymbol : public Managed {
     V4_MANAGED(StringOrSymbol, Managed)
     V4_NEEDS_DESTROY
     enum {
-        IsStringOrSymbol = true
+        IsStringOrSymbol = true,
+        IsDestroyThreadSafe = true
     };
 
 private:
@@ -524,6 +524,13 @@ ReturnedValue VME::exec(JSTypesStackFrame *frame, ExecutionEngine *engine)
                 QV4::JIT::BaselineJIT(function).generate();
             else
                 ++function->interpreterCallCount;
+        } else if (function->jittedCode && !function->isOptimized) {
+            // Once the baseline code has run often enough for the lookups to have settled,
+            // recompile with the type feedback they hold.
+            if (engine->canOptimize(function))
+                QV4::JIT::BaselineJIT(function, QV4::JIT::BaselineJIT::Optimizing).generate();
+            else
+                ++function->jittedCallCount;
         }
     }
 #endif // QT_CONFIG(qml_jit)
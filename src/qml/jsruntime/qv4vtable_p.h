@@ -69,7 +69,8 @@ struct VTable
     quint8 isArrayData;
     quint8 isStringOrSymbol;
     quint8 type;
-    quint8 unused[4];
+    quint8 isDestroyThreadSafe;
+    quint8 unused[3];
     const char *className;
 
     Destroy destroy;
@@ -201,7 +202,8 @@ protected:
     classname::IsArrayData,                 \
     classname::IsStringOrSymbol,            \
     classname::MyType,                      \
-    { 0, 0, 0, 0 },                         \
+    classname::IsDestroyThreadSafe,         \
+    { 0, 0, 0 },                            \
     #classname, \
     \
     classname::virtualDestroy,              \
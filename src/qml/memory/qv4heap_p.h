@@ -145,7 +145,13 @@ void Base::mark(QV4::MarkStack *markStack)
     quintptr *bitmap = c->blackBitmap + Chunk::bitmapIndex(index);
     quintptr bit = Chunk::bitForIndex(index);
     if (!(*bitmap & bit)) {
-        *bitmap |= bit;
+        // Other threads may set bits in the same word while marking in parallel.
+        if (Q_UNLIKELY(markStack->isParallel())) {
+            if (Chunk::testAndSetBitAtomic(c->blackBitmap, index))
+                return;
+        } else {
+            *bitmap |= bit;
+        }
         markStack->push(this);
     }
 }
@@ -6,6 +6,7 @@
 #include "qv4mm_p.h"
 #include "qv4qobjectwrapper_p.h"
 #include "qv4identifiertable_p.h"
+#include "qv4lookup_p.h"
 #include <QtCore/qalgorithms.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/qloggingcategory.h>
@@ -16,11 +17,16 @@
 
 #include <QElapsedTimer>
 #include <QMap>
+#include <QMutex>
 #include <QScopedValueRollback>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <atomic>
 #include "qv4profiling_p.h"
 #include "qv4mapobject_p.h"
 #include "qv4setobject_p.h"
@@ -264,7 +270,13 @@ static void increaseFreedCountForClass(const char *className)
 }
 
 //bool Chunk::sweep(ClassDestroyStatsCallback classCountPtr)
-bool Chunk::sweep(ExecutionEngine *engine)
+/*
+    Sweeps the chunk without touching the engine, so that it can run on a worker
+    thread. If \a deferredDestroys is given, only objects whose destroy() is thread
+    safe are destroyed right away; the others are appended to the list and need to be
+    destroyed by the caller on the engine's thread before the freed slots are reused.
+*/
+bool Chunk::sweep(std::vector<Heap::Base *> *deferredDestroys, size_t *freedBytes)
 {
     bool hasUsedSlots = false;
     SDUMP() << "sweeping chunk" << this;
@@ -303,16 +315,19 @@ bool Chunk::sweep(ExecutionEngine *engine)
 //            if (Q_UNLIKELY(classCountPtr))
 //                classCountPtr(v->className);
             if (v->destroy) {
-                v->destroy(b);
-                b->_checkIsDestroyed();
+                if (deferredDestroys && !v->isDestroyThreadSafe) {
+                    deferredDestroys->push_back(b);
+                } else {
+                    v->destroy(b);
+                    b->_checkIsDestroyed();
+                }
             }
 #ifdef V4_USE_HEAPTRACK
             heaptrack_report_free(itemToFree);
 #endif
         }
-        Q_V4_PROFILE_DEALLOC(engine, qPopulationCount((objectBitmap[i] | extendsBitmap[i])
-                                                      - (blackBitmap[i] | e)) * Chunk::SlotSize,
-                             Profiling::SmallItem);
+        *freedBytes += qPopulationCount((objectBitmap[i] | extendsBitmap[i])
+                                        - (blackBitmap[i] | e)) * Chunk::SlotSize;
         objectBitmap[i] = blackBitmap[i];
         hasUsedSlots |= (blackBitmap[i] != 0);
         extendsBitmap[i] = e;
@@ -550,17 +565,96 @@ done:
     return m;
 }
 
-void BlockAllocator::sweep()
+void BlockAllocator::sweepChunk(Chunk *c)
+{
+    size_t freedBytes = 0;
+    c->sweep(nullptr, &freedBytes);
+    Q_V4_PROFILE_DEALLOC(engine, freedBytes, Profiling::SmallItem);
+}
+
+void BlockAllocator::sweep(QThreadPool *threadPool)
+{
+//    qDebug() << "BlockAlloc: sweep";
+    const int nThreads = threadPool ? threadPool->maxThreadCount() : 0;
+    if (nThreads > 0 && chunks.size() > size_t(nThreads)) {
+        parallelSweep(threadPool, nThreads);
+    } else {
+        for (Chunk *c : chunks)
+            sweepChunk(c);
+    }
+
+    finishSweep();
+}
+
+/*
+    Sweeps all chunks using the engine's thread and \a nThreads workers of
+    \a threadPool. The mutator is paused while this happens, so the chunks themselves
+    need no locking. Objects whose destroy() is not marked as thread safe may touch
+    arbitrary engine state, hence they are collected and destroyed here once the
+    workers are done. The freed slots are only handed to the allocator afterwards.
+*/
+void BlockAllocator::parallelSweep(QThreadPool *threadPool, int nThreads)
+{
+    struct SweepResult {
+        std::vector<Heap::Base *> deferredDestroys;
+        size_t freedBytes = 0;
+    };
+
+    std::vector<SweepResult> results(nThreads + 1);
+    std::atomic<size_t> nextChunk = 0;
+    const auto sweepChunks = [this, &nextChunk](SweepResult *result) {
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+            chunks[i]->sweep(&result->deferredDestroys, &result->freedBytes);
+    };
+
+    for (int i = 1; i <= nThreads; ++i)
+        threadPool->start([&sweepChunks, &results, i]() { sweepChunks(&results[i]); });
+    sweepChunks(&results[0]);
+    threadPool->waitForDone();
+
+    for (const SweepResult &result : results) {
+        for (Heap::Base *b : result.deferredDestroys) {
+            b->internalClass->vtable->destroy(b);
+            b->_checkIsDestroyed();
+        }
+        Q_V4_PROFILE_DEALLOC(engine, result.freedBytes, Profiling::SmallItem);
+    }
+}
+
+void BlockAllocator::startIncrementalSweep()
+{
+    sweepIndex = 0;
+    // Chunks allocated while sweeping only contain objects allocated black.
+    sweepEnd = chunks.size();
+}
+
+/*
+    Sweeps chunks until the deadline expires. Freed slots are only handed to the
+    allocator once all chunks are swept, so that destroy() calls can still access
+    dead objects, just like with a non-incremental sweep. Until then, allocations are
+    served from the free bins of the previous collection or from new chunks.
+*/
+bool BlockAllocator::incrementalSweep(QDeadlineTimer deadline)
+{
+    while (sweepIndex < sweepEnd) {
+        sweepChunk(chunks[sweepIndex++]);
+        if (deadline.hasExpired())
+            return false;
+    }
+
+    finishSweep();
+    return true;
+}
+
+void BlockAllocator::finishSweep()
 {
     nextFree = nullptr;
     nFree = 0;
     memset(freeBins, 0, sizeof(freeBins));
-
-//    qDebug() << "BlockAlloc: sweep";
     usedSlotsAfterLastSweep = 0;
 
-    auto firstEmptyChunk = std::partition(chunks.begin(), chunks.end(), [this](Chunk *c) {
-        return c->sweep(engine);
+    auto firstEmptyChunk = std::partition(chunks.begin(), chunks.end(), [](Chunk *c) {
+        return c->nUsedSlots() != 0;
     });
 
     std::for_each(chunks.begin(), firstEmptyChunk, [this](Chunk *c) {
@@ -645,7 +739,6 @@ void HugeItemAllocator::sweep(ClassDestroyStatsCallback classCountPtr)
 {
     auto isBlack = [this, classCountPtr] (const HugeChunk &c) {
         bool b = c.chunk->first()->isBlack();
-        Chunk::clearBit(c.chunk->blackBitmap, c.chunk->first() - c.chunk->realBase());
         if (!b) {
             Q_V4_PROFILE_DEALLOC(engine, c.size, Profiling::LargeItem);
             freeHugeChunk(chunkAllocator, c, classCountPtr);
@@ -685,6 +778,19 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     , gcStats(lcGcStats().isDebugEnabled())
     , gcCollectorStats(lcGcAllocatorStats().isDebugEnabled())
 {
+    bool ok = false;
+    const int timeLimit = qEnvironmentVariableIntValue("QV4_GC_TIMELIMIT", &ok);
+    if (ok)
+        setGCTimeLimit(timeLimit);
+    const int sweepThreads = qEnvironmentVariableIntValue("QV4_GC_SWEEP_THREADS", &ok);
+    if (ok)
+        setSweepThreadCount(sweepThreads);
+    const int markThreads = qEnvironmentVariableIntValue("QV4_GC_MARK_THREADS", &ok);
+    if (ok)
+        setMarkThreadCount(markThreads);
+    if (!qEnvironmentVariableIsEmpty("QV4_GC_GENERATIONAL"))
+        setGenerational(true);
+
 #ifdef V4_USE_VALGRIND
     VALGRIND_CREATE_MEMPOOL(this, 0, true);
 #endif
@@ -700,11 +806,11 @@ Heap::Base *MemoryManager::allocString(std::size_t unmanagedSize)
     lastAllocRequestedSlots = stringSize >> Chunk::SlotSizeShift;
     ++allocationCount;
 #endif
-    unmanagedHeapSize += unmanagedSize;
+    changeUnmanagedHeapSizeUsage(qptrdiff(unmanagedSize));
 
     HeapItem *m = allocate(&blockAllocator, stringSize);
     memset(m, 0, stringSize);
-    if (gcBlocked) {
+    if (allocateBlack()) {
         // If the gc is running right now, it will not have a chance to mark the newly created item
         // and may therefore sweep it right away.
         // Protect the new object from the current GC run to avoid this.
@@ -726,7 +832,7 @@ Heap::Base *MemoryManager::allocData(std::size_t size)
 
     HeapItem *m = allocate(&blockAllocator, size);
     memset(m, 0, size);
-    if (gcBlocked) {
+    if (allocateBlack()) {
         // If the gc is running right now, it will not have a chance to mark the newly created item
         // and may therefore sweep it right away.
         // Protect the new object from the current GC run to avoid this.
@@ -752,7 +858,11 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
         Heap::MemberData *m;
         if (totalSize > Chunk::DataSize) {
             o = static_cast<Heap::Object *>(allocData(size));
-            m = hugeItemAllocator.allocate(memberSize)->as<Heap::MemberData>();
+            HeapItem *mh = hugeItemAllocator.allocate(memberSize);
+            memset(mh, 0, memberSize);
+            m = mh->as<Heap::MemberData>();
+            if (allocateBlack())
+                m->setMarkBit();
         } else {
             HeapItem *mh = reinterpret_cast<HeapItem *>(allocData(totalSize));
             Heap::Base *b = *mh;
@@ -776,7 +886,7 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
     return o;
 }
 
-static uint markStackSize = 0;
+static thread_local uint markStackSize = 0;
 
 MarkStack::MarkStack(ExecutionEngine *engine)
     : m_engine(engine)
@@ -788,14 +898,280 @@ MarkStack::MarkStack(ExecutionEngine *engine)
     m_softLimit = m_base + size * 3 / 4;
 }
 
+MarkStack::MarkStack(ExecutionEngine *engine, Heap::Base **base, size_t size)
+    : m_top(base)
+    , m_base(base)
+    , m_softLimit(base + size * 3 / 4)
+    , m_hardLimit(base + size)
+    , m_engine(engine)
+    , m_parallel(true)
+{
+}
+
+/*
+    Marks in parallel, starting from the objects on a mark stack filled by
+    collectRoots(). Every worker owns a mark stack that it processes without any
+    synchronization. The mark bits are set atomically, see Heap::Base::mark().
+
+    A worker with enough work on its stack moves the oldest entries into its shared
+    queue, unless that is still full. Workers running out of work first take back their
+    own shared queue, and then steal the queues of the other workers. Marking is done
+    once all workers are idle, as only active workers fill shared queues.
+
+    The marker and the memory of its mark stacks are kept by the memory manager and
+    reused by every collection, as long as the number of threads doesn't change.
+*/
+struct ParallelMarker
+{
+    enum {
+        ShareBatchSize = 256,
+        ShareCheckInterval = 64
+    };
+
+    struct Worker {
+        std::unique_ptr<Heap::Base *[]> stackMemory;
+        std::unique_ptr<MarkStack> stack;
+        QMutex mutex;
+        std::vector<Heap::Base *> shared; // guarded by mutex
+        std::atomic<bool> hasShared = false;
+        uint markedObjects = 0;
+    };
+
+    ParallelMarker(ExecutionEngine *engine, int nWorkers)
+    {
+        const size_t stackSize = engine->maxGCStackSize() / sizeof(Heap::Base);
+        for (int i = 0; i < nWorkers; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->stackMemory.reset(new Heap::Base *[stackSize]);
+            worker->stack = std::make_unique<MarkStack>(engine, worker->stackMemory.get(),
+                                                        stackSize);
+            workers.push_back(std::move(worker));
+        }
+    }
+
+    void seed(MarkStack *markStack)
+    {
+        idleWorkers = 0;
+        for (auto &worker : workers) {
+            Q_ASSERT(worker->stack->isEmpty());
+            worker->shared.clear();
+        }
+
+        size_t i = 0;
+        for (Heap::Base **it = markStack->m_base; it != markStack->m_top; ++it)
+            workers[i++ % workers.size()]->shared.push_back(*it);
+        for (auto &worker : workers)
+            worker->hasShared = !worker->shared.empty();
+        markStack->discard();
+    }
+
+    void share(Worker *worker)
+    {
+        MarkStack *stack = worker->stack.get();
+        QMutexLocker locker(&worker->mutex);
+        worker->shared.assign(stack->m_base, stack->m_base + ShareBatchSize);
+        std::move(stack->m_base + ShareBatchSize, stack->m_top, stack->m_base);
+        stack->m_top -= ShareBatchSize;
+        worker->hasShared = true;
+    }
+
+    bool take(Worker *from, Worker *to)
+    {
+        if (!from->hasShared)
+            return false;
+
+        std::vector<Heap::Base *> taken;
+        {
+            QMutexLocker locker(&from->mutex);
+            std::swap(taken, from->shared);
+            from->hasShared = false;
+        }
+        for (Heap::Base *h : taken)
+            to->stack->push(h);
+        return !taken.empty();
+    }
+
+    bool steal(int index)
+    {
+        const int nWorkers = int(workers.size());
+        for (int i = 1; i < nWorkers; ++i) {
+            if (take(workers[(index + i) % nWorkers].get(), workers[index].get()))
+                return true;
+        }
+        return false;
+    }
+
+    bool hasSharedWork() const
+    {
+        for (const auto &worker : workers) {
+            if (worker->hasShared)
+                return true;
+        }
+        return false;
+    }
+
+    void run(int index)
+    {
+        Worker *self = workers[index].get();
+        MarkStack *stack = self->stack.get();
+        const int nWorkers = int(workers.size());
+        const uint markedBefore = markStackSize;
+
+        while (true) {
+            uint n = 0;
+            while (!stack->isEmpty()) {
+                Heap::Base *h = stack->pop();
+                ++markStackSize;
+                h->internalClass->vtable->markObjects(h, stack);
+                if (++n % ShareCheckInterval == 0 && !self->hasShared.load(std::memory_order_relaxed)
+                        && stack->m_top - stack->m_base > 2 * ShareBatchSize) {
+                    share(self);
+                }
+            }
+
+            if (take(self, self) || steal(index))
+                continue;
+
+            ++idleWorkers;
+            while (idleWorkers != nWorkers) {
+                if (hasSharedWork()) {
+                    --idleWorkers;
+                    if (steal(index))
+                        break;
+                    ++idleWorkers;
+                }
+                QThread::yieldCurrentThread();
+            }
+            if (stack->isEmpty())
+                break;
+        }
+
+        self->markedObjects = markStackSize - markedBefore;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> idleWorkers = 0;
+};
+
 void MarkStack::drain()
 {
-    while (m_top > m_base) {
-        Heap::Base *h = pop();
-        ++markStackSize;
-        Q_ASSERT(h); // at this point we should only have Heap::Base objects in this area on the stack. If not, weird things might happen.
-        h->internalClass->vtable->markObjects(h, this);
+    do {
+        while (m_top > m_base) {
+            Heap::Base *h = pop();
+            ++markStackSize;
+            Q_ASSERT(h); // at this point we should only have Heap::Base objects in this area on the stack. If not, weird things might happen.
+            h->internalClass->vtable->markObjects(h, this);
+        }
+    } while (refill());
+}
+
+bool MarkStack::drain(QDeadlineTimer deadline)
+{
+    // Reading the clock is comparatively expensive, only check the deadline every so often.
+    enum { DeadlineCheckInterval = 128 };
+
+    do {
+        while (m_top > m_base) {
+            for (int i = 0; i < DeadlineCheckInterval && m_top > m_base; ++i) {
+                Heap::Base *h = pop();
+                ++markStackSize;
+                Q_ASSERT(h);
+                h->internalClass->vtable->markObjects(h, this);
+            }
+            if (deadline.hasExpired())
+                return isEmpty();
+        }
+    } while (refill());
+    return true;
+}
+
+// Moves the upper half of a full stack aside, see setIncremental().
+void MarkStack::spill()
+{
+    Heap::Base **middle = m_base + (m_softLimit - m_base) / 2;
+    m_overflow.insert(m_overflow.end(), middle, m_top);
+    m_top = middle;
+}
+
+// Moves spilled entries back onto an empty stack. Returns whether there were any.
+bool MarkStack::refill()
+{
+    Q_ASSERT(m_top == m_base);
+    if (m_overflow.empty())
+        return false;
+
+    const size_t count = std::min(m_overflow.size(), size_t(m_softLimit - m_base) / 2);
+    const auto begin = m_overflow.end() - count;
+    m_top = std::copy(begin, m_overflow.end(), m_base);
+    m_overflow.erase(begin, m_overflow.end());
+    return true;
+}
+
+void WriteBarrier::markBarrier(EngineBase *engine, ReturnedValue value)
+{
+    if (Heap::Base *h = Value::fromReturnedValue(value).heapObject())
+        markBarrier(engine, h);
+}
+
+void WriteBarrier::markBarrier(EngineBase *engine, Heap::Base *value)
+{
+    if (!value)
+        return;
+    MemoryManager *mm = engine->memoryManager;
+    Q_ASSERT(mm->m_markStack);
+    value->mark(mm->m_markStack.get());
+}
+
+void WriteBarrier::barrier(EngineBase *engine, Heap::Base *base,
+                           ReturnedValue oldValue, ReturnedValue newValue)
+{
+    barrier(engine, base, Value::fromReturnedValue(oldValue).heapObject(),
+            Value::fromReturnedValue(newValue).heapObject());
+}
+
+void WriteBarrier::barrier(EngineBase *engine, Heap::Base *base,
+                           Heap::Base *oldValue, Heap::Base *newValue)
+{
+    if (engine->isGCOngoing) {
+        markBarrier(engine, oldValue);
+        markBarrier(engine, newValue);
+    } else if (newValue && base->isMarked() && !newValue->isMarked()) {
+        // an old object now references a young one
+        engine->memoryManager->remember(base);
+    }
+}
+
+void WriteBarrier::rescanBarrier(EngineBase *engine, Heap::Base *base)
+{
+    if (engine->isGCOngoing) {
+        MemoryManager *mm = engine->memoryManager;
+        Q_ASSERT(mm->m_markStack);
+        base->internalClass->vtable->markObjects(base, mm->m_markStack.get());
+    } else if (base->isMarked()) {
+        engine->memoryManager->remember(base);
+    }
+}
+
+void MemoryManager::remember(Heap::Base *base)
+{
+    Q_ASSERT(m_generational);
+    const HeapItem *h = reinterpret_cast<const HeapItem *>(base);
+    Chunk *c = h->chunk();
+    const size_t index = h - c->realBase();
+    if (Chunk::testBit(c->rememberedBitmap, index))
+        return;
+    Chunk::setBit(c->rememberedBitmap, index);
+    m_rememberedSet.push_back(base);
+}
+
+void MemoryManager::clearRememberedSet()
+{
+    for (Heap::Base *b : m_rememberedSet) {
+        const HeapItem *h = reinterpret_cast<const HeapItem *>(b);
+        Chunk *c = h->chunk();
+        Chunk::clearBit(c->rememberedBitmap, h - c->realBase());
     }
+    m_rememberedSet.clear();
 }
 
 void MemoryManager::collectRoots(MarkStack *markStack)
@@ -845,10 +1221,29 @@ void MemoryManager::mark()
     markStackSize = 0;
     MarkStack markStack(engine);
     collectRoots(&markStack);
+    if (m_markThreadPool)
+        parallelMark(&markStack);
     // dtor of MarkStack drains
 }
 
-void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr)
+void MemoryManager::parallelMark(MarkStack *markStack)
+{
+    const int nWorkers = m_markThreadPool->maxThreadCount() + 1;
+    if (!m_parallelMarker || int(m_parallelMarker->workers.size()) != nWorkers)
+        m_parallelMarker = std::make_unique<ParallelMarker>(engine, nWorkers);
+    ParallelMarker *marker = m_parallelMarker.get();
+    marker->seed(markStack);
+
+    for (int i = 1; i < nWorkers; ++i)
+        m_markThreadPool->start([marker, i]() { marker->run(i); });
+    marker->run(0);
+    m_markThreadPool->waitForDone();
+
+    for (int i = 1; i < nWorkers; ++i)
+        markStackSize += marker->workers[i]->markedObjects;
+}
+
+void MemoryManager::sweepWeakReferences(bool lastSweep)
 {
     for (PersistentValueStorage::Iterator it = m_weakValues->begin(); it != m_weakValues->end(); ++it) {
         Managed *m = (*it).managed();
@@ -915,13 +1310,18 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
                 ++it;
         }
     }
+}
 
+void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr)
+{
+    sweepWeakReferences(lastSweep);
 
     if (!lastSweep) {
         engine->identifierTable->sweep();
-        blockAllocator.sweep(/*classCountPtr*/);
+        blockAllocator.sweep(m_sweepThreadPool.get());
         hugeItemAllocator.sweep(classCountPtr);
         icAllocator.sweep(/*classCountPtr*/);
+        engine->megamorphicLookupCache->clear();
     }
 }
 
@@ -969,8 +1369,20 @@ void MemoryManager::runGC()
         return;
     }
 
+    // Complete a pending incremental collection first, it holds the mark state.
+    if (m_gcState != GCIdle)
+        gcStep(QDeadlineTimer::Forever);
+
     QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
 //    qDebug() << "runGC";
+    QElapsedTimer gcTimer;
+    gcTimer.start();
+
+    // A major collection treats everything as young.
+    if (m_generational) {
+        clearMarkBits();
+        clearRememberedSet();
+    }
 
     if (gcStats) {
         statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
@@ -982,7 +1394,7 @@ void MemoryManager::runGC()
         sweep();
     } else {
         bool triggeredByUnmanagedHeap = (unmanagedHeapSize > unmanagedHeapSizeGCLimit);
-        size_t oldUnmanagedSize = unmanagedHeapSize;
+        size_t oldUnmanagedSize = unmanagedHeapSize.load();
 
         const size_t totalMem = getAllocatedMem();
         const size_t usedBefore = getUsedMem();
@@ -1014,7 +1426,7 @@ void MemoryManager::runGC()
         if (triggeredByUnmanagedHeap) {
             qDebug(stats) << "triggered by unmanaged heap:";
             qDebug(stats) << "   old unmanaged heap size:" << oldUnmanagedSize;
-            qDebug(stats) << "   new unmanaged heap:" << unmanagedHeapSize;
+            qDebug(stats) << "   new unmanaged heap:" << unmanagedHeapSize.load();
             qDebug(stats) << "   unmanaged heap limit:" << unmanagedHeapSizeGCLimit;
         }
         size_t memInBins = dumpBins(&blockAllocator, "Block")
@@ -1070,12 +1482,316 @@ void MemoryManager::runGC()
 
     usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
 
-    // reset all black bits
+    if (m_generational) {
+        // The survivors form the old generation, see runMinorGC().
+        usedSlotsAfterLastMajorGC = usedSlotsAfterLastFullSweep;
+    } else {
+        clearMarkBits();
+    }
+
+    m_gcTime += gcTimer.nsecsElapsed();
+}
+
+/*
+    Collects the young generation only. Objects that survived a previous collection
+    keep their mark bit and form the old generation. Marking starts from the roots and
+    from the old objects in the remembered set, and stops at old objects, so the work
+    done depends on the amount of live young objects rather than on the heap size.
+    Surviving young objects keep their mark bit as well, which promotes them.
+*/
+void MemoryManager::runMinorGC()
+{
+    if (gcBlocked)
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    QElapsedTimer t;
+    t.start();
+    const size_t rememberedObjects = m_rememberedSet.size();
+
+    markStackSize = 0;
+    {
+        MarkStack markStack(engine);
+        std::vector<Heap::Base *> rememberedSet;
+        std::swap(rememberedSet, m_rememberedSet);
+        for (Heap::Base *b : rememberedSet) {
+            const HeapItem *h = reinterpret_cast<const HeapItem *>(b);
+            Chunk *c = h->chunk();
+            Chunk::clearBit(c->rememberedBitmap, h - c->realBase());
+            b->internalClass->vtable->markObjects(b, &markStack);
+        }
+        collectRoots(&markStack);
+        if (m_markThreadPool)
+            parallelMark(&markStack);
+        // dtor of MarkStack drains
+    }
+    const qint64 markTime = t.nsecsElapsed() / 1000;
+
+    sweep();
+    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+
+    if (gcCollectorStats) {
+        const QLoggingCategory &stats = lcGcAllocatorStats();
+        qDebug(stats) << "Minor GC: marked" << markStackSize << "objects from"
+                      << rememberedObjects << "remembered objects in" << markTime << "us,"
+                      << "took" << t.nsecsElapsed() / 1000 << "us in total";
+    }
+
+    m_gcTime += t.nsecsElapsed();
+}
+
+bool MemoryManager::shouldRunMajorGC() const
+{
+    // Promoted objects accumulate until a major collection checks them again.
+    return usedSlotsAfterLastFullSweep > MinSlotsGCLimit
+            && usedSlotsAfterLastFullSweep * 100 > usedSlotsAfterLastMajorGC * GCOverallocation;
+}
+
+void MemoryManager::clearMarkBits()
+{
     blockAllocator.resetBlackBits();
     hugeItemAllocator.resetBlackBits();
     icAllocator.resetBlackBits();
 }
 
+void MemoryManager::triggerGC()
+{
+    if (m_generational && m_gcState == GCIdle && !shouldRunMajorGC()) {
+        runMinorGC();
+        return;
+    }
+
+    if (!m_gcTimeLimit) {
+        runGC();
+        return;
+    }
+
+    if (gcBlocked)
+        return;
+
+    if (m_gcState == GCIdle) {
+        startIncrementalGC();
+    } else if (m_lastGCStep.isValid() && !m_lastGCStep.hasExpired(m_gcTimeLimit)) {
+        // Give the mutator at least as much time as the collector between steps.
+        return;
+    }
+
+    gcStep(QDeadlineTimer(m_gcTimeLimit));
+}
+
+void MemoryManager::startIncrementalGC()
+{
+    Q_ASSERT(m_gcState == GCIdle);
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    QElapsedTimer t;
+    t.start();
+
+    if (gcStats) {
+        statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
+        statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
+    }
+
+    if (m_generational) {
+        clearMarkBits();
+        clearRememberedSet();
+    }
+
+    markStackSize = 0;
+    m_markStack = std::make_unique<MarkStack>(engine);
+    m_markStack->setIncremental(true);
+    m_gcState = GCMarking;
+    engine->isGCOngoing = true;
+    engine->isWriteBarrierActive = true;
+    collectRoots(m_markStack.get());
+    m_gcTime += t.nsecsElapsed();
+}
+
+void MemoryManager::finishIncrementalMarking()
+{
+    // The roots are not covered by the write barrier. Scan them once more and complete
+    // marking in one go.
+    collectRoots(m_markStack.get());
+    m_markStack->setIncremental(false);
+    m_markStack.reset(); // dtor of MarkStack drains
+    engine->isGCOngoing = false;
+    engine->isWriteBarrierActive = m_generational;
+
+    sweepWeakReferences(false);
+    engine->identifierTable->sweep();
+    blockAllocator.startIncrementalSweep();
+    m_gcState = GCSweeping;
+}
+
+void MemoryManager::finishIncrementalGC()
+{
+    // Dead objects still need their internal classes when being destroyed, so those
+    // go last, as in sweep().
+    hugeItemAllocator.sweep(nullptr);
+    icAllocator.sweep();
+    engine->megamorphicLookupCache->clear();
+
+    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+
+    if (m_generational)
+        usedSlotsAfterLastMajorGC = usedSlotsAfterLastFullSweep;
+    else
+        clearMarkBits();
+    m_gcState = GCIdle;
+
+    if (gcStats)
+        statistics.maxUsedMem = qMax(statistics.maxUsedMem, getUsedMem() + getLargeItemsMem());
+
+    updateUnmanagedHeapSizeGCLimit();
+}
+
+void MemoryManager::abortIncrementalGC()
+{
+    if (m_markStack) {
+        m_markStack->discard();
+        m_markStack.reset();
+    }
+    engine->isGCOngoing = false;
+    engine->isWriteBarrierActive = m_generational;
+
+    // Marking may be incomplete, so not even the generations are known. Start over
+    // with everything being young.
+    clearMarkBits();
+    clearRememberedSet();
+    m_gcState = GCIdle;
+}
+
+/*
+    Performs incremental collection work until \a deadline expires. Returns true if
+    no collection is in progress afterwards. This can be called at convenient points,
+    for example after a frame has been rendered.
+*/
+bool MemoryManager::gcStep(QDeadlineTimer deadline)
+{
+    if (m_gcState == GCIdle)
+        return true;
+    if (gcBlocked)
+        return false;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    const GCState initialState = m_gcState;
+    QElapsedTimer t;
+    t.start();
+
+    do {
+        switch (m_gcState) {
+        case GCMarking:
+            if (m_markStack->drain(deadline))
+                finishIncrementalMarking();
+            break;
+        case GCSweeping:
+            if (blockAllocator.incrementalSweep(deadline))
+                finishIncrementalGC();
+            break;
+        case GCIdle:
+            Q_UNREACHABLE();
+        }
+    } while (m_gcState != GCIdle && !deadline.hasExpired());
+
+    const qint64 stepTime = t.nsecsElapsed();
+    m_gcTime += stepTime;
+    Q_V4_PROFILE_GC_STEP(engine, stepTime, initialState == GCMarking
+                         ? Profiling::GCMarkStep : Profiling::GCSweepStep);
+    if (gcCollectorStats) {
+        qDebug(lcGcAllocatorStats) << "Incremental GC step"
+                                   << (initialState == GCMarking ? "(mark)" : "(sweep)")
+                                   << "took" << stepTime / 1000 << "us";
+        if (m_gcState == GCIdle)
+            qDebug(lcGcAllocatorStats) << "   " << markStackSize << "objects marked";
+    }
+
+    m_lastGCStep.start();
+    if (m_gcState == GCIdle)
+        return true;
+
+    // Continue from the event loop, so that the collection also makes progress when
+    // the application doesn't allocate. Without an event loop, allocations drive it.
+    if (!m_gcStepTimer) {
+        m_gcStepTimer = std::make_unique<QTimer>();
+        m_gcStepTimer->setSingleShot(true);
+        QObject::connect(m_gcStepTimer.get(), &QTimer::timeout, [this]() {
+            gcStep(QDeadlineTimer(m_gcTimeLimit));
+        });
+    }
+    if (m_gcStepTimer->thread() == QThread::currentThread() && !m_gcStepTimer->isActive())
+        m_gcStepTimer->start(m_gcTimeLimit);
+    return false;
+}
+
+/*
+    Enables or disables the generational mode. In this mode, collections triggered by
+    allocations only collect objects allocated since the previous collection, unless
+    the old generation has grown too much. See runMinorGC().
+*/
+void MemoryManager::setGenerational(bool generational)
+{
+    if (generational == m_generational)
+        return;
+
+    // Complete a pending incremental collection, it relies on the current mode.
+    if (m_gcState != GCIdle)
+        gcStep(QDeadlineTimer::Forever);
+    Q_ASSERT(m_gcState == GCIdle);
+
+    // Start over with everything being young.
+    clearMarkBits();
+    clearRememberedSet();
+    usedSlotsAfterLastMajorGC = 0;
+    m_generational = generational;
+    engine->isWriteBarrierActive = generational;
+}
+
+int MemoryManager::markThreadCount() const
+{
+    return m_markThreadPool ? m_markThreadPool->maxThreadCount() : 0;
+}
+
+/*
+    Sets the number of worker threads that help the engine's thread marking the heap
+    in non-incremental collections. 0 marks on the engine's thread only.
+*/
+void MemoryManager::setMarkThreadCount(int threadCount)
+{
+    if (threadCount <= 0) {
+        m_markThreadPool.reset();
+        m_parallelMarker.reset();
+        return;
+    }
+
+    if (!m_markThreadPool) {
+        m_markThreadPool = std::make_unique<QThreadPool>();
+        m_markThreadPool->setObjectName(QStringLiteral("QV4 GC marker"));
+    }
+    m_markThreadPool->setMaxThreadCount(threadCount);
+}
+
+int MemoryManager::sweepThreadCount() const
+{
+    return m_sweepThreadPool ? m_sweepThreadPool->maxThreadCount() : 0;
+}
+
+/*
+    Sets the number of worker threads that help the engine's thread sweeping the
+    chunks of the block allocator. 0 sweeps on the engine's thread only.
+*/
+void MemoryManager::setSweepThreadCount(int threadCount)
+{
+    if (threadCount <= 0) {
+        m_sweepThreadPool.reset();
+        return;
+    }
+
+    if (!m_sweepThreadPool) {
+        m_sweepThreadPool = std::make_unique<QThreadPool>();
+        m_sweepThreadPool->setObjectName(QStringLiteral("QV4 GC sweeper"));
+    }
+    m_sweepThreadPool->setMaxThreadCount(threadCount);
+}
+
 size_t MemoryManager::getUsedMem() const
 {
     return blockAllocator.usedMem() + icAllocator.usedMem();
@@ -1105,6 +1821,9 @@ void MemoryManager::registerWeakSet(Heap::SetObject *set)
 
 MemoryManager::~MemoryManager()
 {
+    abortIncrementalGC();
+    m_gcStepTimer.reset();
+
     delete m_persistentValues;
 
     dumpStats();
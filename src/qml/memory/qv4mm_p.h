@@ -20,16 +20,24 @@
 #include <private/qv4scopedvalue_p.h>
 #include <private/qv4object_p.h>
 #include <private/qv4mmdefs_p.h>
+#include <QElapsedTimer>
 #include <QVector>
 
+#include <atomic>
+#include <memory>
+
 #define MM_DEBUG 0
 
 QT_BEGIN_NAMESPACE
 
+class QThreadPool;
+class QTimer;
+
 namespace QV4 {
 
 struct ChunkAllocator;
 struct MemorySegment;
+struct ParallelMarker;
 
 struct BlockAllocator {
     BlockAllocator(ChunkAllocator *chunkAllocator, ExecutionEngine *engine)
@@ -60,10 +68,16 @@ struct BlockAllocator {
         return used;
     }
 
-    void sweep();
+    void sweep(QThreadPool *threadPool = nullptr);
     void freeAll();
     void resetBlackBits();
 
+    void startIncrementalSweep();
+    bool incrementalSweep(QDeadlineTimer deadline);
+    void parallelSweep(QThreadPool *threadPool, int nThreads);
+    void finishSweep();
+    void sweepChunk(Chunk *c);
+
     // bump allocations
     HeapItem *nextFree = nullptr;
     size_t nFree = 0;
@@ -73,6 +87,8 @@ struct BlockAllocator {
     ExecutionEngine *engine;
     std::vector<Chunk *> chunks;
     uint *allocationStats = nullptr;
+    size_t sweepIndex = 0;
+    size_t sweepEnd = 0;
 };
 
 struct HugeItemAllocator {
@@ -215,6 +231,34 @@ public:
 
     void runGC();
 
+    // Incremental collection. A non-zero time limit (in milliseconds, QV4_GC_TIMELIMIT)
+    // makes allocation triggered collections run as a sequence of bounded steps.
+    enum GCState {
+        GCIdle,
+        GCMarking,
+        GCSweeping
+    };
+
+    int gcTimeLimit() const { return m_gcTimeLimit; }
+    void setGCTimeLimit(int milliseconds) { m_gcTimeLimit = qMax(0, milliseconds); }
+    GCState gcState() const { return m_gcState; }
+    bool gcStep(QDeadlineTimer deadline);
+
+    // The total time spent collecting, in nanoseconds
+    qint64 gcTime() const { return m_gcTime; }
+
+    int markThreadCount() const;
+    void setMarkThreadCount(int threadCount);
+
+    int sweepThreadCount() const;
+    void setSweepThreadCount(int threadCount);
+
+    bool isGenerational() const { return m_generational; }
+    void setGenerational(bool generational);
+
+    // Records an old object that may reference young objects. Called by the write barrier.
+    void remember(Heap::Base *base);
+
     void dumpStats() const;
 
     size_t getUsedMem() const;
@@ -223,12 +267,19 @@ public:
 
     // called when a JS object grows itself. Specifically: Heap::String::append
     // and InternalClassDataPrivate<PropertyAttributes>.
-    void changeUnmanagedHeapSizeUsage(qptrdiff delta) { unmanagedHeapSize += delta; }
+    // May be called from sweeper threads, see BlockAllocator::parallelSweep().
+    void changeUnmanagedHeapSizeUsage(qptrdiff delta)
+    { unmanagedHeapSize.fetch_add(std::size_t(delta), std::memory_order_relaxed); }
 
     template<typename ManagedType>
     typename ManagedType::Data *allocIC()
     {
-        Heap::Base *b = *allocate(&icAllocator, align(sizeof(typename ManagedType::Data)));
+        const std::size_t size = align(sizeof(typename ManagedType::Data));
+        HeapItem *m = allocate(&icAllocator, size);
+        memset(m, 0, size);
+        Heap::Base *b = *m;
+        if (allocateBlack())
+            b->setMarkBit();
         return static_cast<typename ManagedType::Data *>(b);
     }
 
@@ -239,6 +290,7 @@ protected:
     /// expects size to be aligned
     Heap::Base *allocString(std::size_t unmanagedSize);
     Heap::Base *allocData(std::size_t size);
+    Q_ALWAYS_INLINE bool allocateBlack() const { return gcBlocked || m_gcState != GCIdle; }
     Heap::Object *allocObjectWithMemberData(const QV4::VTable *vtable, uint nMembers);
 
 private:
@@ -248,9 +300,33 @@ private:
 
     void collectFromJSStack(MarkStack *markStack) const;
     void mark();
+    void parallelMark(MarkStack *markStack);
+    void sweepWeakReferences(bool lastSweep);
     void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr);
     bool shouldRunGC() const;
+    bool shouldRunMajorGC() const;
     void collectRoots(MarkStack *markStack);
+    void runMinorGC();
+    void clearMarkBits();
+    void clearRememberedSet();
+
+    void triggerGC();
+    void updateUnmanagedHeapSizeGCLimit()
+    {
+        if (3*unmanagedHeapSizeGCLimit <= 4 * unmanagedHeapSize) {
+            // more than 75% full, raise limit
+            unmanagedHeapSizeGCLimit = std::max(unmanagedHeapSizeGCLimit,
+                                                unmanagedHeapSize.load()) * 2;
+        } else if (unmanagedHeapSize * 4 <= unmanagedHeapSizeGCLimit) {
+            // less than 25% full, lower limit
+            unmanagedHeapSizeGCLimit = qMax(std::size_t(MinUnmanagedHeapSizeGCLimit),
+                                            unmanagedHeapSizeGCLimit/2);
+        }
+    }
+    void startIncrementalGC();
+    void finishIncrementalMarking();
+    void finishIncrementalGC();
+    void abortIncrementalGC();
 
     HeapItem *allocate(BlockAllocator *allocator, std::size_t size)
     {
@@ -262,17 +338,11 @@ private:
 
         if (unmanagedHeapSize > unmanagedHeapSizeGCLimit) {
             if (!didGCRun)
-                runGC();
-
-            if (3*unmanagedHeapSizeGCLimit <= 4 * unmanagedHeapSize) {
-                // more than 75% full, raise limit
-                unmanagedHeapSizeGCLimit = std::max(unmanagedHeapSizeGCLimit,
-                                                    unmanagedHeapSize) * 2;
-            } else if (unmanagedHeapSize * 4 <= unmanagedHeapSizeGCLimit) {
-                // less than 25% full, lower limit
-                unmanagedHeapSizeGCLimit = qMax(std::size_t(MinUnmanagedHeapSizeGCLimit),
-                                                unmanagedHeapSizeGCLimit/2);
-            }
+                triggerGC();
+
+            // an incremental collection adjusts the limit once it's done
+            if (m_gcState == GCIdle)
+                updateUnmanagedHeapSizeGCLimit();
             didGCRun = true;
         }
 
@@ -283,7 +353,7 @@ private:
             return m;
 
         if (!didGCRun && shouldRunGC())
-            runGC();
+            triggerGC();
 
         return allocator->allocate(size, true);
     }
@@ -300,9 +370,22 @@ public:
     Heap::MapObject *weakMaps = nullptr;
     Heap::SetObject *weakSets = nullptr;
 
-    std::size_t unmanagedHeapSize = 0; // the amount of bytes of heap that is not managed by the memory manager, but which is held onto by managed items.
+    std::unique_ptr<MarkStack> m_markStack; // only alive during an incremental collection
+    QElapsedTimer m_lastGCStep;
+    GCState m_gcState = GCIdle;
+    int m_gcTimeLimit = 0;
+    qint64 m_gcTime = 0;
+    std::unique_ptr<QTimer> m_gcStepTimer;
+    std::unique_ptr<QThreadPool> m_markThreadPool; // only set if marking in parallel
+    std::unique_ptr<ParallelMarker> m_parallelMarker; // mark stacks of the marker threads
+    std::unique_ptr<QThreadPool> m_sweepThreadPool; // only set if sweeping in parallel
+    std::vector<Heap::Base *> m_rememberedSet; // old objects that may reference young ones
+    bool m_generational = false;
+
+    std::atomic<std::size_t> unmanagedHeapSize = 0; // the amount of bytes of heap that is not managed by the memory manager, but which is held onto by managed items.
     std::size_t unmanagedHeapSizeGCLimit;
     std::size_t usedSlotsAfterLastFullSweep = 0;
+    std::size_t usedSlotsAfterLastMajorGC = 0;
 
     bool gcBlocked = false;
     bool aggressiveGC = false;
@@ -17,8 +17,12 @@
 #include <private/qv4global_p.h>
 #include <private/qv4runtimeapi_p.h>
 #include <QtCore/qalgorithms.h>
+#include <QtCore/qdeadlinetimer.h>
 #include <QtCore/qmath.h>
 
+#include <atomic>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -34,7 +38,9 @@ typedef void(*ClassDestroyStatsCallback)(const char *);
  * is a simple masking operation. Each Chunk has 4 bitmaps for managing purposes,
  * and 32byte wide slots for the objects following afterwards.
  *
- * The gray and black bitmaps are used for mark/sweep.
+ * The black bitmap is used for mark/sweep.
+ * The remembered bitmap is used by the generational collector, it has a bit set for
+ * objects in the remembered set.
  * The object bitmap has a bit set if this location represents the start of a Heap object.
  * The extends bitmap denotes the extend of an object. It has a cleared bit at the start of the object
  * and a set bit for all following slots used by the object.
@@ -59,7 +65,7 @@ struct Chunk {
         SlotSizeShift = 5,
         NumSlots = ChunkSize/SlotSize,
         BitmapSize = NumSlots/8,
-        HeaderSize = 3*BitmapSize,
+        HeaderSize = 4*BitmapSize,
         DataSize = ChunkSize - HeaderSize,
         AvailableSlots = DataSize/SlotSize,
 #if QT_POINTER_SIZE == 8
@@ -74,6 +80,7 @@ struct Chunk {
     quintptr blackBitmap[BitmapSize/sizeof(quintptr)];
     quintptr objectBitmap[BitmapSize/sizeof(quintptr)];
     quintptr extendsBitmap[BitmapSize/sizeof(quintptr)];
+    quintptr rememberedBitmap[BitmapSize/sizeof(quintptr)];
     char data[ChunkSize - HeaderSize];
 
     HeapItem *realBase();
@@ -98,6 +105,13 @@ struct Chunk {
         quintptr bit = bitForIndex(index);
         *bitmap &= ~bit;
     }
+    // Returns whether the bit was set before. Used by the parallel marker.
+    static bool testAndSetBitAtomic(quintptr *bitmap, size_t index) {
+        Q_STATIC_ASSERT(sizeof(std::atomic<quintptr>) == sizeof(quintptr));
+        auto *word = reinterpret_cast<std::atomic<quintptr> *>(bitmap + bitmapIndex(index));
+        const quintptr bit = bitForIndex(index);
+        return word->fetch_or(bit, std::memory_order_relaxed) & bit;
+    }
     static bool testBit(quintptr *bitmap, size_t index) {
 //        Q_ASSERT(index >= HeaderSize/SlotSize && index < ChunkSize/SlotSize);
         bitmap += bitmapIndex(index);
@@ -151,7 +165,7 @@ struct Chunk {
 
     bool sweep(ClassDestroyStatsCallback classCountPtr);
     void resetBlackBits();
-    bool sweep(ExecutionEngine *engine);
+    bool sweep(std::vector<Heap::Base *> *deferredDestroys, size_t *freedBytes);
     void freeAll(ExecutionEngine *engine);
 
     void sortIntoBins(HeapItem **bins, uint nBins);
@@ -229,6 +243,8 @@ Q_STATIC_ASSERT((1 << Chunk::BitShift) == Chunk::Bits);
 
 struct Q_QML_PRIVATE_EXPORT MarkStack {
     MarkStack(ExecutionEngine *engine);
+    // A mark stack of a parallel marker thread, using the given memory.
+    MarkStack(ExecutionEngine *engine, Heap::Base **base, size_t size);
     ~MarkStack() { drain(); }
 
     void push(Heap::Base *m) {
@@ -237,6 +253,12 @@ struct Q_QML_PRIVATE_EXPORT MarkStack {
         if (m_top < m_softLimit)
             return;
 
+        // Draining here would not respect the deadline of an incremental step
+        if (m_incremental) {
+            spill();
+            return;
+        }
+
         // If at or above soft limit, partition the remaining space into at most 64 segments and
         // allow one C++ recursion of drain() per segment, plus one for the fence post.
         const quintptr segmentSize = qNextPowerOfTwo(quintptr(m_hardLimit - m_softLimit) / 64u);
@@ -252,9 +274,25 @@ struct Q_QML_PRIVATE_EXPORT MarkStack {
 
     ExecutionEngine *engine() const { return m_engine; }
 
+    // Used by the incremental collector. Returns true once the stack is empty.
+    bool drain(QDeadlineTimer deadline);
+    bool isEmpty() const { return m_top == m_base && m_overflow.empty(); }
+    void discard() { m_top = m_base; m_overflow.clear(); }
+
+    // Set for the stack of the incremental collector. Instead of draining the stack
+    // when it runs full, the entries are moved aside and marked by later steps.
+    void setIncremental(bool incremental) { m_incremental = incremental; }
+
+    // Set if other threads mark at the same time, see ParallelMarker.
+    bool isParallel() const { return m_parallel; }
+
 private:
+    friend struct ParallelMarker;
+
     Heap::Base *pop() { return *(--m_top); }
     void drain();
+    void spill();
+    bool refill();
 
     Heap::Base **m_top = nullptr;
     Heap::Base **m_base = nullptr;
@@ -262,6 +300,9 @@ private:
     Heap::Base **m_hardLimit = nullptr;
     ExecutionEngine *m_engine = nullptr;
     quintptr m_drainRecursion = 0;
+    std::vector<Heap::Base *> m_overflow; // spilled entries, only if incremental
+    bool m_parallel = false;
+    bool m_incremental = false;
 };
 
 // Some helper to automate the generation of our
@@ -15,15 +15,15 @@
 //
 
 #include <private/qv4global_p.h>
+#include <private/qv4enginebase_p.h>
 
 QT_BEGIN_NAMESPACE
 
-#define WRITEBARRIER_none 1
+#define WRITEBARRIER_yuasa 1
 
 #define WRITEBARRIER(x) (1/WRITEBARRIER_##x == 1)
 
 namespace QV4 {
-struct EngineBase;
 
 namespace WriteBarrier {
 
@@ -41,24 +41,56 @@ enum NewValueType {
 // ### this needs to be filled with a real memory fence once marking is concurrent
 Q_ALWAYS_INLINE void fence() {}
 
-#if WRITEBARRIER(none)
+// Slow path of the barrier, only taken while an incremental collection is marking.
+// Greys the given value on the collector's mark stack.
+Q_QML_PRIVATE_EXPORT void markBarrier(EngineBase *engine, ReturnedValue value);
+Q_QML_PRIVATE_EXPORT void markBarrier(EngineBase *engine, Heap::Base *value);
+
+// Slow path of write(), taken while isWriteBarrierActive is set.
+Q_QML_PRIVATE_EXPORT void barrier(EngineBase *engine, Heap::Base *base,
+                                  ReturnedValue oldValue, ReturnedValue newValue);
+Q_QML_PRIVATE_EXPORT void barrier(EngineBase *engine, Heap::Base *base,
+                                  Heap::Base *oldValue, Heap::Base *newValue);
+
+// Some objects keep references in memory they own outside of the GC heap, for
+// example the hash table of a Map. Stores into such memory can't be tracked per
+// slot. Call this before and after mutating it; the collector then rescans \a base.
+Q_QML_PRIVATE_EXPORT void rescanBarrier(EngineBase *engine, Heap::Base *base);
+
+inline void offHeapWrite(EngineBase *engine, Heap::Base *base)
+{
+    if (Q_UNLIKELY(engine->isWriteBarrierActive))
+        rescanBarrier(engine, base);
+}
+
+#if WRITEBARRIER(yuasa)
+
+/*
+ * Snapshot-at-the-beginning barrier for the incremental collector: while marking is
+ * in progress, the value being overwritten is greyed, so that everything reachable
+ * when marking started gets marked. The new value is greyed as well, as objects
+ * allocated during the collection are black and will not be scanned again.
+ *
+ * With the generational collector, the barrier additionally records old objects
+ * that get a reference to a young object stored into them in the remembered set.
+ */
 
 template <NewValueType type>
 static constexpr inline bool isRequired() {
-    return false;
+    return true;
 }
 
 inline void write(EngineBase *engine, Heap::Base *base, ReturnedValue *slot, ReturnedValue value)
 {
-    Q_UNUSED(engine);
-    Q_UNUSED(base);
+    if (Q_UNLIKELY(engine->isWriteBarrierActive))
+        barrier(engine, base, *slot, value);
     *slot = value;
 }
 
 inline void write(EngineBase *engine, Heap::Base *base, Heap::Base **slot, Heap::Base *value)
 {
-    Q_UNUSED(engine);
-    Q_UNUSED(base);
+    if (Q_UNLIKELY(engine->isWriteBarrierActive))
+        barrier(engine, base, *slot, value);
     *slot = value;
 }
 
@@ -26,6 +26,7 @@
 #include <QVariant>
 #include <QtCore/qdebug.h>
 #include <QVector>
+#include <QtCore/qvarlengtharray.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -597,7 +598,124 @@ QVariant QQmlBinding::evaluate()
 
 void QQmlBinding::expressionChanged()
 {
-    update();
+    QQmlEngine *qmlEngine = engine();
+    QQmlEnginePrivate *ep = qmlEngine ? QQmlEnginePrivate::get(qmlEngine) : nullptr;
+    if (!ep || !ep->coalesceBindingUpdates) {
+        update();
+        return;
+    }
+
+    // Queue the binding, so that it is updated once even if several of its
+    // dependencies change before the queue is flushed.
+    if (m_error.tag() == UpdatePending)
+        return;
+    m_error.setTag(UpdatePending);
+    ep->pendingBindingUpdates.append({ QQmlAbstractBinding::Ptr(this), targetObject() });
+    ep->postBindingUpdates();
+}
+
+/*
+    Orders \a bindings so that each binding comes after the bindings that
+    write a property it depends on. Dependencies on QProperty based properties
+    are not considered, and the bindings of a dependency cycle keep their
+    order. Bindings whose target was deleted are not looked at.
+*/
+void QQmlBinding::sortByDependencies(QList<QQmlPendingBindingUpdate> &bindings)
+{
+    const qsizetype count = bindings.size();
+    if (count < 2)
+        return;
+
+    // The bindings writing each notifying property, by object and signal index
+    QMultiHash<std::pair<QObject *, int>, qsizetype> writers;
+    for (qsizetype i = 0; i < count; ++i) {
+        QQmlBinding *binding = static_cast<QQmlBinding *>(bindings.at(i).binding.data());
+        if (!bindings.at(i).target || !binding->enabledFlag()
+                || QQmlData::wasDeleted(binding->targetObject())) {
+            continue;
+        }
+        const QQmlPropertyData *core = nullptr;
+        binding->getPropertyData(&core, nullptr);
+        if (core->notifyIndex() != -1)
+            writers.insert({ binding->targetObject(), core->notifyIndex() }, i);
+    }
+    if (writers.isEmpty())
+        return;
+
+    QVarLengthArray<qsizetype> dependencyCounts(count, 0);
+    QList<QVarLengthArray<qsizetype, 4>> dependents(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        if (!bindings.at(i).target)
+            continue;
+        QQmlBinding *binding = static_cast<QQmlBinding *>(bindings.at(i).binding.data());
+        for (QQmlJavaScriptExpressionGuard *guard = binding->activeGuards.first(); guard;
+             guard = binding->activeGuards.next(guard)) {
+            if (guard->signalIndex() == -1) // guard's sender is a QQmlNotifier, not a QObject*.
+                continue;
+            const auto range = writers.equal_range({ guard->senderAsObject(), guard->signalIndex() });
+            for (auto it = range.first; it != range.second; ++it) {
+                if (*it == i)
+                    continue;
+                dependents[*it].append(i);
+                ++dependencyCounts[i];
+            }
+        }
+    }
+
+    QList<QQmlPendingBindingUpdate> sorted;
+    sorted.reserve(count);
+    QVarLengthArray<qsizetype> ready;
+    for (qsizetype i = 0; i < count; ++i) {
+        if (dependencyCounts[i] == 0)
+            ready.append(i);
+    }
+    for (qsizetype next = 0; next < ready.size(); ++next) {
+        const qsizetype i = ready.at(next);
+        sorted.append(std::move(bindings[i]));
+        for (qsizetype dependent : std::as_const(dependents[i])) {
+            if (--dependencyCounts[dependent] == 0)
+                ready.append(dependent);
+        }
+    }
+
+    if (sorted.size() < count) {
+        for (qsizetype i = 0; i < count; ++i) {
+            if (dependencyCounts[i] > 0)
+                sorted.append(std::move(bindings[i]));
+        }
+    }
+    bindings = std::move(sorted);
+}
+
+void QQmlBinding::updatePendingBindings(QQmlEnginePrivate *engine)
+{
+    // Updating the queued bindings can queue further bindings, which are
+    // updated in the next round. Bindings that keep queueing each other
+    // form a loop.
+    static constexpr int MaximumRounds = 100;
+
+    for (int round = 0; !engine->pendingBindingUpdates.isEmpty(); ++round) {
+        QList<QQmlPendingBindingUpdate> bindings
+                = std::exchange(engine->pendingBindingUpdates, {});
+        if (round < MaximumRounds)
+            sortByDependencies(bindings);
+
+        for (const QQmlPendingBindingUpdate &pending : std::as_const(bindings)) {
+            QQmlBinding *binding = static_cast<QQmlBinding *>(pending.binding.data());
+            binding->m_error.setTag(NoTag);
+            if (!pending.target)
+                continue;
+            if (round < MaximumRounds) {
+                binding->update();
+            } else if (binding->enabledFlag() && !QQmlData::wasDeleted(binding->targetObject())) {
+                const QQmlPropertyData *d = nullptr;
+                QQmlPropertyData vtd;
+                binding->getPropertyData(&d, &vtd);
+                QQmlAbstractBinding::printBindingLoopError(
+                        QQmlPropertyPrivate::restore(binding->targetObject(), *d, &vtd, nullptr));
+            }
+        }
+    }
 }
 
 void QQmlBinding::refresh()
@@ -22,6 +22,7 @@
 #include <QtCore/QMetaProperty>
 
 #include <private/qqmlabstractbinding_p.h>
+#include <private/qqmlbindingarena_p.h>
 #include <private/qqmljavascriptexpression_p.h>
 #include <private/qv4functionobject_p.h>
 #include <private/qqmltranslation_p.h>
@@ -29,6 +30,7 @@
 QT_BEGIN_NAMESPACE
 
 class QQmlContext;
+struct QQmlPendingBindingUpdate;
 class Q_QML_PRIVATE_EXPORT QQmlBinding : public QQmlJavaScriptExpression,
                                          public QQmlAbstractBinding
 {
@@ -66,6 +68,10 @@ public:
 
     ~QQmlBinding() override;
 
+    // Allocated from the binding arena of the creation, if there is one
+    static void *operator new(std::size_t size) { return QQmlBindingArena::allocate(size); }
+    static void operator delete(void *memory) { QQmlBindingArena::free(memory); }
+
     bool mustCaptureBindableProperty() const final {return true;}
     void refresh() override;
 
@@ -86,6 +92,9 @@ public:
 
     void expressionChanged() override;
 
+    // Updates the bindings queued while the engine coalesces binding updates
+    static void updatePendingBindings(QQmlEnginePrivate *engine);
+
     QQmlSourceLocation sourceLocation() const override;
     void setSourceLocation(const QQmlSourceLocation &location);
     void setBoundFunction(QV4::BoundFunction *boundFunction) {
@@ -122,6 +131,8 @@ protected:
     QV4::ReturnedValue evaluate(bool *isUndefined);
 
 private:
+    static void sortByDependencies(QList<QQmlPendingBindingUpdate> &bindings);
+
     static QQmlBinding *newBinding(const QQmlPropertyData *property);
     static QQmlBinding *newBinding(QMetaType propertyType);
 
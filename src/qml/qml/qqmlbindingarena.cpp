@@ -0,0 +1,96 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlbindingarena_p.h"
+
+#include <QtCore/qglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Every allocation starts with the arena it belongs to, or nullptr if it was
+// taken from the heap. The header keeps the object behind it aligned.
+constexpr std::size_t HeaderSize = alignof(std::max_align_t) > sizeof(void *)
+        ? alignof(std::max_align_t) : sizeof(void *);
+
+// Blocks grow from 1 KiB to 16 KiB with the creation, so that small
+// components do not hold on to much unused memory.
+constexpr std::size_t MinimumBlockSize = 1024;
+constexpr std::size_t MaximumBlockGrowth = 4;
+
+// Components with fewer bindings, literal ones included, would leave most of
+// the first block unused. Their bindings are taken from the heap instead.
+constexpr int MinimumBindingCount = 16;
+
+Q_CONSTINIT thread_local QQmlBindingArena *currentArena = nullptr;
+
+}
+
+QQmlBindingArena::Scope::Scope(QQmlBindingArena *arena)
+    : m_previous(currentArena)
+{
+    currentArena = arena;
+}
+
+QQmlBindingArena::Scope::~Scope()
+{
+    currentArena = m_previous;
+}
+
+QQmlRefPointer<QQmlBindingArena> QQmlBindingArena::create(int bindingCount)
+{
+    static const bool disabled = qEnvironmentVariableIntValue("QML_NO_BINDING_ARENA");
+    if (disabled || bindingCount < MinimumBindingCount)
+        return QQmlRefPointer<QQmlBindingArena>();
+    return QQmlRefPointer<QQmlBindingArena>(new QQmlBindingArena,
+                                            QQmlRefPointer<QQmlBindingArena>::Adopt);
+}
+
+QQmlBindingArena::~QQmlBindingArena() = default;
+
+void *QQmlBindingArena::take(std::size_t size)
+{
+    size = (size + HeaderSize - 1) & ~(HeaderSize - 1);
+    if (size > m_available) {
+        const std::size_t blockSize = qMax(
+                size, MinimumBlockSize << qMin(m_blocks.size(), MaximumBlockGrowth));
+        m_blocks.emplace_back(new char[blockSize]);
+        m_next = m_blocks.back().get();
+        m_available = blockSize;
+    }
+
+    void *memory = m_next;
+    m_next += size;
+    m_available -= size;
+    ++m_allocationCount;
+    return memory;
+}
+
+void *QQmlBindingArena::allocate(std::size_t size)
+{
+    QQmlBindingArena *arena = currentArena;
+    char *memory;
+    if (arena) {
+        memory = static_cast<char *>(arena->take(HeaderSize + size));
+        arena->addref();
+    } else {
+        memory = static_cast<char *>(::operator new(HeaderSize + size));
+    }
+    *reinterpret_cast<QQmlBindingArena **>(memory) = arena;
+    return memory + HeaderSize;
+}
+
+void QQmlBindingArena::free(void *memory)
+{
+    if (!memory)
+        return;
+
+    char *start = static_cast<char *>(memory) - HeaderSize;
+    if (QQmlBindingArena *arena = *reinterpret_cast<QQmlBindingArena **>(start))
+        arena->release();
+    else
+        ::operator delete(start);
+}
+
+QT_END_NAMESPACE
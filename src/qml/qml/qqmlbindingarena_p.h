@@ -0,0 +1,77 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLBINDINGARENA_P_H
+#define QQMLBINDINGARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmlrefcount_p.h>
+#include <private/qtqmlglobal_p.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Backs the bindings and bound signals that QQmlObjectCreator creates for a
+    component tree with a few large blocks, instead of one heap allocation
+    each. The arena is owned by the root context of the creation, and every
+    allocation from it holds a reference, so that its memory is freed at once
+    when the context and the last of the bindings are gone.
+
+    Classes opt in by forwarding their operator new and delete to allocate()
+    and free(). Those use the arena of the innermost Scope on the current
+    thread, or the heap outside of any.
+*/
+class Q_QML_PRIVATE_EXPORT QQmlBindingArena : public QQmlRefCount
+{
+    Q_DISABLE_COPY_MOVE(QQmlBindingArena)
+public:
+    class Scope
+    {
+        Q_DISABLE_COPY_MOVE(Scope)
+    public:
+        explicit Scope(QQmlBindingArena *arena);
+        ~Scope();
+
+    private:
+        QQmlBindingArena *m_previous;
+    };
+
+    // Returns nullptr if arenas are disabled with QML_NO_BINDING_ARENA, or if
+    // there are too few bindings to make use of a block.
+    static QQmlRefPointer<QQmlBindingArena> create(int bindingCount);
+
+    static void *allocate(std::size_t size);
+    static void free(void *memory);
+
+    int allocationCount() const { return m_allocationCount; }
+    int blockCount() const { return int(m_blocks.size()); }
+
+private:
+    QQmlBindingArena() = default;
+    ~QQmlBindingArena() override;
+
+    void *take(std::size_t size);
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char *m_next = nullptr;
+    std::size_t m_available = 0;
+    int m_allocationCount = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLBINDINGARENA_P_H
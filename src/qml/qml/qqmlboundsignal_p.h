@@ -17,6 +17,7 @@
 
 #include <QtCore/qmetaobject.h>
 
+#include <private/qqmlbindingarena_p.h>
 #include <private/qqmljavascriptexpression_p.h>
 #include <private/qqmlnotifier_p.h>
 #include <private/qqmlrefcount_p.h>
@@ -36,6 +37,10 @@ public:
             const QObject *target, int index, const QQmlRefPointer<QQmlContextData> &ctxt,
             QObject *scopeObject, QV4::Function *function, QV4::ExecutionContext *scope = nullptr);
 
+    // Allocated from the binding arena of the creation, if there is one
+    static void *operator new(std::size_t size) { return QQmlBindingArena::allocate(size); }
+    static void operator delete(void *memory) { QQmlBindingArena::free(memory); }
+
     // inherited from QQmlJavaScriptExpression.
     QString expressionIdentifier() const override;
     void expressionChanged() override;
@@ -65,6 +70,10 @@ public:
     QQmlBoundSignal(QObject *target, int signal, QObject *owner, QQmlEngine *engine);
     ~QQmlBoundSignal();
 
+    // Allocated from the binding arena of the creation, if there is one
+    static void *operator new(std::size_t size) { return QQmlBindingArena::allocate(size); }
+    static void operator delete(void *memory) { QQmlBindingArena::free(memory); }
+
     void removeFromObject();
 
     QQmlBoundSignalExpression *expression() const;
@@ -16,6 +16,7 @@
 //
 
 #include <QtQml/private/qtqmlglobal_p.h>
+#include <QtQml/private/qqmlbindingarena_p.h>
 #include <QtQml/private/qqmlcontext_p.h>
 #include <QtQml/private/qqmlguard_p.h>
 #include <QtQml/private/qqmltypenamecache_p.h>
@@ -258,6 +259,9 @@ public:
     QQmlRefPointer<QQmlContextData> linkedContext() const { return m_linkedContext; }
     void setLinkedContext(const QQmlRefPointer<QQmlContextData> &context) { m_linkedContext = context; }
 
+    QQmlBindingArena *bindingArena() const { return m_bindingArena.data(); }
+    void setBindingArena(const QQmlRefPointer<QQmlBindingArena> &arena) { m_bindingArena = arena; }
+
     bool hasUnresolvedNames() const { return m_unresolvedNames; }
     void setUnresolvedNames(bool hasUnresolvedNames) { m_unresolvedNames = hasUnresolvedNames; }
 
@@ -418,6 +422,10 @@ private:
     // Linked contexts. this owns linkedContext.
     QQmlRefPointer<QQmlContextData> m_linkedContext;
 
+    // Backs the bindings created with the objects of this context, if it is
+    // the root context of a creation.
+    QQmlRefPointer<QQmlBindingArena> m_bindingArena;
+
     // Linked list of uses of the Component attached property in this context
     QQmlComponentAttached *m_componentAttacheds = nullptr;
 };
@@ -14,6 +14,7 @@
 #include "qqmlabstracturlinterceptor.h"
 
 #include <private/qqmldirparser_p.h>
+#include <private/qqmlbinding_p.h>
 #include <private/qqmlboundsignal_p.h>
 #include <private/qqmljsdiagnosticmessage_p.h>
 #include <private/qqmltype_p_p.h>
@@ -211,6 +212,51 @@ QQmlEnginePrivate::~QQmlEnginePrivate()
     qDeleteAll(cachedValueTypeInstances);
 }
 
+QAtomicInt QQmlEnginePrivate::coalescingEngines;
+
+/*
+    Enables or disables the coalescing of binding updates for this engine.
+    Bindings that are already queued are updated by the next flush.
+*/
+void QQmlEnginePrivate::setCoalesceBindingUpdates(bool coalesce)
+{
+    if (coalesceBindingUpdates == coalesce)
+        return;
+
+    coalesceBindingUpdates = coalesce;
+    if (coalesce)
+        coalescingEngines.ref();
+    else
+        coalescingEngines.deref();
+}
+
+/*
+    Makes sure the pending binding updates are flushed once control returns
+    to the event loop, unless something flushes them earlier.
+*/
+void QQmlEnginePrivate::postBindingUpdates()
+{
+    if (bindingUpdatesPosted)
+        return;
+
+    bindingUpdatesPosted = true;
+    QMetaObject::invokeMethod(q_func(), [this]() {
+        bindingUpdatesPosted = false;
+        flushBindingUpdates();
+    }, Qt::QueuedConnection);
+}
+
+/*
+    Updates the bindings that were queued since the last flush, if the
+    updates of bindings are coalesced. QQuickWindow calls this before
+    polishing its items.
+*/
+void QQmlEnginePrivate::flushBindingUpdates()
+{
+    if (!pendingBindingUpdates.isEmpty())
+        QQmlBinding::updatePendingBindings(this);
+}
+
 void QQmlPrivate::qdeclarativeelement_destructor(QObject *o)
 {
     QObjectPrivate *p = QObjectPrivate::get(o);
@@ -475,7 +521,11 @@ void QQmlEnginePrivate::init()
 
     q->handle()->setQmlEngine(q);
 
+    setCoalesceBindingUpdates(qEnvironmentVariableIntValue("QML_COALESCE_BINDING_UPDATES"));
+
     rootContext = new QQmlContext(q,true);
+
+    typeLoader.initializeStartupProfile();
 }
 
 /*!
@@ -555,6 +605,9 @@ QQmlEngine::~QQmlEngine()
     // XXX TODO: performance -- store list of singleton types separately?
     d->singletonInstances.clear();
 
+    d->setCoalesceBindingUpdates(false);
+    d->pendingBindingUpdates.clear();
+
     delete d->rootContext;
     d->rootContext = nullptr;
 
@@ -21,6 +21,7 @@
 #include <private/qintrusivelist_p.h>
 #include <private/qjsengine_p.h>
 #include <private/qjsvalue_p.h>
+#include <private/qqmlabstractbinding_p.h>
 #include <private/qpodvector_p.h>
 #include <private/qqmldirparser_p.h>
 #include <private/qqmlimport_p.h>
@@ -39,6 +40,7 @@
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qpair.h>
+#include <QtCore/qpointer.h>
 #include <QtCore/qproperty.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qstring.h>
@@ -65,6 +67,15 @@ struct QObjectForeign {
     Q_CLASSINFO("QML.OmitFromQmlTypes", "true")
 };
 
+// A binding queued while its engine coalesces binding updates. The target is
+// guarded, as QQmlData::destroyed() does not disable the bindings of a deleted
+// object.
+struct QQmlPendingBindingUpdate
+{
+    QQmlAbstractBinding::Ptr binding;
+    QPointer<QObject> target;
+};
+
 // This needs to be declared here so that the pool for it can live in QQmlEnginePrivate.
 // The inline method definitions are in qqmljavascriptexpression_p.h
 class QQmlJavaScriptExpressionGuard : public QQmlNotifierEndpoint
@@ -129,6 +140,20 @@ public:
     QQmlDelayedError *erroredBindings = nullptr;
     int inProgressCreations = 0;
 
+    // If set, bindings whose dependencies changed are queued and updated once,
+    // in dependency order, when control returns to the event loop or before
+    // the items of a window are polished. See QQmlBinding::expressionChanged().
+    bool coalesceBindingUpdates = false;
+    bool bindingUpdatesPosted = false;
+    QList<QQmlPendingBindingUpdate> pendingBindingUpdates;
+    void setCoalesceBindingUpdates(bool coalesce);
+    void postBindingUpdates();
+    void flushBindingUpdates();
+
+    // The number of engines that coalesce binding updates, so that windows
+    // only look for their engine when there may be something to flush.
+    static QAtomicInt coalescingEngines;
+
     QV4::ExecutionEngine *v4engine() const { return q_func()->handle(); }
 
 #if QT_CONFIG(qml_worker_script)
@@ -163,8 +188,13 @@ public:
     // qqmlengine_p.h and qqmlincubator_p.h
     struct Incubator {
         QIntrusiveListNode next;
+        // Incubators with a higher priority are processed first, see
+        // QQmlIncubatorPrivate::setPriority()
+        int priority = 0;
     };
     QIntrusiveList<Incubator, &Incubator::next> incubatorList;
+    // Incubators with a negative priority, processed once incubatorList is empty
+    QIntrusiveList<Incubator, &Incubator::next> speculativeIncubatorList;
     unsigned int incubatorCount = 0;
     QQmlIncubationController *incubationController = nullptr;
     void incubate(QQmlIncubator &, const QQmlRefPointer<QQmlContextData> &);
@@ -35,6 +35,7 @@ void QQmlEnginePrivate::incubate(
         if (parentIncubator && parentIncubator->isAsynchronous) {
             mode = QQmlIncubator::Asynchronous;
             p->waitingOnMe = parentIncubator;
+            p->priority = parentIncubator->priority;
             parentIncubator->waitingFor.insert(p.data());
         }
     }
@@ -53,7 +54,10 @@ void QQmlEnginePrivate::incubate(
             p->incubate(i);
         }
     } else {
-        incubatorList.insert(p.data());
+        if (p->priority < QQmlIncubatorPrivate::NormalPriority)
+            speculativeIncubatorList.insert(p.data());
+        else
+            incubatorList.insert(p.data());
         incubatorCount++;
 
         p->vmeGuard.guard(p->creator.data());
@@ -101,6 +105,25 @@ QQmlIncubatorPrivate::~QQmlIncubatorPrivate()
     clear();
 }
 
+/*!
+    \internal
+
+    Sets the priority of the incubator, moving it to the matching queue of the
+    engine if it is queued already.
+*/
+void QQmlIncubatorPrivate::setPriority(int newPriority)
+{
+    const bool wasSpeculative = priority < NormalPriority;
+    priority = newPriority;
+    if (!next.isInList() || wasSpeculative == (newPriority < NormalPriority))
+        return;
+
+    if (wasSpeculative)
+        enginePriv->incubatorList.insert(this);
+    else
+        enginePriv->speculativeIncubatorList.insert(this);
+}
+
 void QQmlIncubatorPrivate::clear()
 {
     // reset the tagged pointer
@@ -407,8 +430,21 @@ void QQmlIncubatorPrivate::incubateCppBasedComponent(QQmlComponent *component, Q
 
 }
 
+// Returns the incubator with the highest priority, and of those the one
+// that was inserted last.
+static QQmlIncubatorPrivate *nextIncubator(QQmlEnginePrivate *enginePriv)
+{
+    QQmlEnginePrivate::Incubator *next = enginePriv->incubatorList.first();
+    if (!next)
+        next = enginePriv->speculativeIncubatorList.first();
+    return static_cast<QQmlIncubatorPrivate *>(next);
+}
+
 /*!
 Incubate objects for \a msecs, or until there are no more objects to incubate.
+
+Objects that are needed soon, like the visible delegates of a view, are
+incubated before the ones that are created ahead of time.
 */
 void QQmlIncubationController::incubateFor(int msecs)
 {
@@ -418,7 +454,7 @@ void QQmlIncubationController::incubateFor(int msecs)
     QDeadlineTimer deadline(msecs);
     QQmlInstantiationInterrupt i(deadline);
     do {
-        static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
+        nextIncubator(d)->incubate(i);
     } while (d && d->incubatorCount != 0 && !i.shouldInterrupt());
 }
 
@@ -441,7 +477,7 @@ void QQmlIncubationController::incubateWhile(std::atomic<bool> *flag, int msecs)
 
     QQmlInstantiationInterrupt i(flag, msecs ? QDeadlineTimer(msecs) : QDeadlineTimer::Forever);
     do {
-        static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
+        nextIncubator(d)->incubate(i);
     } while (d && d->incubatorCount != 0 && !i.shouldInterrupt());
 }
 
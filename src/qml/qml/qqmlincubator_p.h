@@ -36,6 +36,11 @@ public:
 
     inline static QQmlIncubatorPrivate *get(QQmlIncubator *incubator) { return incubator->d; }
 
+    // Objects that are created before they are needed, like the cache buffer
+    // of views, yield to the other asynchronous incubators.
+    enum Priority { SpeculativePriority = -1, NormalPriority = 0 };
+    void setPriority(int priority);
+
     int subComponentToCreate;
     QQmlIncubator *q;
 
@@ -153,9 +153,12 @@ protected:
 
     QForwardFieldList<QQmlJavaScriptExpressionGuard, &QQmlJavaScriptExpressionGuard::next, GuardTag> activeGuards;
 
+    // QQmlPropertyBinding marks itself as InEvaluationLoop while evaluating,
+    // QQmlBinding as UpdatePending while it waits for a coalesced update.
     enum Tag {
         NoTag,
-        InEvaluationLoop
+        InEvaluationLoop,
+        UpdatePending
     };
 
     QTaggedPointer<QQmlDelayedError, Tag> m_error;
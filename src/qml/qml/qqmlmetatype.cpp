@@ -12,8 +12,10 @@
 #include <private/qv4executablecompilationunit_p.h>
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qdir.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qthread.h>
 
 Q_DECLARE_LOGGING_CATEGORY(DBG_DISK_CACHE)
 Q_LOGGING_CATEGORY(lcTypeRegistration, "qt.qml.typeregistration")
@@ -46,8 +48,35 @@ CompositeMetaTypeIds::~CompositeMetaTypeIds()
 }
 
 
+/*
+    The maps most lookups go through, copied out of QQmlMetaTypeData so that
+    they can be read without holding the lock. A snapshot is immutable once
+    published. It is built on demand by the first lookup after a change, and
+    retired by any change to the maps or to the set of types they refer to.
+*/
+struct QQmlMetaTypeSnapshot
+{
+    QQmlMetaTypeData::Ids idToType;
+    QQmlMetaTypeData::Names nameToType;
+    QQmlMetaTypeData::Files urlToType;
+    QQmlMetaTypeData::Files urlToNonFileImportType;
+    QQmlMetaTypeData::MetaObjects metaObjectToType;
+};
+
+static QBasicAtomicPointer<const QQmlMetaTypeSnapshot> currentSnapshot
+        = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+
+// Readers register in the counter of the current epoch's parity. A writer that
+// retires a snapshot advances the epoch, and waits for the readers of the
+// previous one to leave before deleting it.
+static QBasicAtomicInt snapshotEpoch = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicAtomicInt snapshotReaders[2] = {
+    Q_BASIC_ATOMIC_INITIALIZER(0), Q_BASIC_ATOMIC_INITIALIZER(0)
+};
+
 struct LockedData : private QQmlMetaTypeData
 {
+    ~LockedData() { delete currentSnapshot.fetchAndStoreOrdered(nullptr); }
     friend class QQmlMetaTypeDataPtr;
 };
 
@@ -77,11 +106,87 @@ public:
 
     bool isValid() const { return data != nullptr; }
 
+    // Publishes a snapshot of the current maps, unless one is published already.
+    void publishSnapshot() const
+    {
+        if (!data || currentSnapshot.loadAcquire())
+            return;
+        currentSnapshot.storeRelease(new QQmlMetaTypeSnapshot {
+                data->idToType, data->nameToType, data->urlToType,
+                data->urlToNonFileImportType, data->metaObjectToType });
+    }
+
+    // Must be called before the maps change, or a type they refer to is released.
+    void retireSnapshot()
+    {
+        const QQmlMetaTypeSnapshot *snapshot = currentSnapshot.fetchAndStoreOrdered(nullptr);
+        if (!snapshot)
+            return;
+
+        // Readers that entered after the epoch was advanced see the snapshot
+        // cleared. Wait for the ones that may still hold the old one.
+        const int epoch = snapshotEpoch.fetchAndAddOrdered(1);
+        while (snapshotReaders[epoch & 1].loadAcquire() != 0)
+            QThread::yieldCurrentThread();
+        delete snapshot;
+    }
+
 private:
     QMutexLocker<QRecursiveMutex> locker;
     LockedData *data = nullptr;
 };
 
+/*
+    Gives lock-free access to the published snapshot, publishing it first
+    if needed. The types found in it have to be referenced, by wrapping them
+    in a QQmlType, before the QQmlMetaTypeSnapshotPtr goes out of scope.
+*/
+class QQmlMetaTypeSnapshotPtr
+{
+    Q_DISABLE_COPY_MOVE(QQmlMetaTypeSnapshotPtr)
+public:
+    QQmlMetaTypeSnapshotPtr()
+    {
+        enter();
+        while (!(snapshot = currentSnapshot.loadAcquire())) {
+            leave();
+            {
+                const QQmlMetaTypeDataPtr data;
+                if (!data.isValid())
+                    return;
+                data.publishSnapshot();
+            }
+            enter();
+        }
+    }
+
+    ~QQmlMetaTypeSnapshotPtr()
+    {
+        if (snapshot)
+            leave();
+    }
+
+    const QQmlMetaTypeSnapshot *operator->() const { return snapshot; }
+    bool isValid() const { return snapshot != nullptr; }
+
+private:
+    void enter()
+    {
+        for (;;) {
+            epoch = snapshotEpoch.loadAcquire() & 1;
+            snapshotReaders[epoch].ref();
+            if ((snapshotEpoch.loadAcquire() & 1) == epoch)
+                return;
+            snapshotReaders[epoch].deref();
+        }
+    }
+
+    void leave() { snapshotReaders[epoch].deref(); }
+
+    const QQmlMetaTypeSnapshot *snapshot = nullptr;
+    int epoch = 0;
+};
+
 static QQmlTypePrivate *createQQmlType(QQmlMetaTypeData *data,
                                        const QQmlPrivate::RegisterInterface &type)
 {
@@ -307,6 +412,7 @@ void QQmlMetaType::clearTypeRegistrations()
 {
     //Only cleans global static, assumed no running engine
     QQmlMetaTypeDataPtr data;
+    data.retireSnapshot();
 
     data->uriToModule.clear();
     data->types.clear();
@@ -344,6 +450,7 @@ QQmlType QQmlMetaType::registerInterface(const QQmlPrivate::RegisterInterface &t
         qFatal("qmlRegisterType(): Cannot mix incompatible QML versions.");
 
     QQmlMetaTypeDataPtr data;
+    data.retireSnapshot();
     QQmlTypePrivate *priv = createQQmlType(data, type);
     Q_ASSERT(priv);
 
@@ -477,6 +584,7 @@ QQmlType QQmlMetaType::registerType(const QQmlPrivate::RegisterType &type)
         return QQmlType();
     }
 
+    data.retireSnapshot();
     QQmlTypePrivate *priv = createQQmlType(data, elementName, type);
     addTypeToData(priv, data);
 
@@ -496,6 +604,7 @@ QQmlType QQmlMetaType::registerSingletonType(const QQmlPrivate::RegisterSingleto
         return QQmlType();
     }
 
+    data.retireSnapshot();
     QQmlTypePrivate *priv = createQQmlType(data, typeName, type);
 
     addTypeToData(priv, data);
@@ -520,6 +629,7 @@ QQmlType QQmlMetaType::registerCompositeSingletonType(const QQmlPrivate::Registe
         return QQmlType();
     }
 
+    data.retireSnapshot();
     QQmlTypePrivate *priv = createQQmlType(data, typeName, type);
     addTypeToData(priv, data);
 
@@ -546,6 +656,7 @@ QQmlType QQmlMetaType::registerCompositeType(const QQmlPrivate::RegisterComposit
         return QQmlType();
     }
 
+    data.retireSnapshot();
     QQmlTypePrivate *priv = createQQmlType(data, typeName, type);
     addTypeToData(priv, data);
 
@@ -614,6 +725,7 @@ QQmlType QQmlMetaType::registerSequentialContainer(
         return QQmlType();
     }
 
+    data.retireSnapshot();
     QQmlTypePrivate *priv = new QQmlTypePrivate(QQmlType::SequentialContainerType);
 
     data->registerType(priv);
@@ -880,6 +992,18 @@ QQmlType QQmlMetaType::typeForUrl(const QString &urlString,
     // ### unfortunate (costly) conversion
     const QUrl url = QQmlTypeLoader::normalize(QUrl(urlString));
 
+    // Most URLs are registered already. Look them up without the lock first.
+    {
+        const QQmlMetaTypeSnapshotPtr snapshot;
+        if (snapshot.isValid()) {
+            QQmlType ret(snapshot->urlToType.value(url));
+            if (!ret.isValid())
+                ret = QQmlType(snapshot->urlToNonFileImportType.value(url));
+            if (ret.isValid() && ret.sourceUrl() == url)
+                return ret;
+        }
+    }
+
     QQmlMetaTypeDataPtr data;
     {
         QQmlType ret(data->urlToType.value(url));
@@ -921,6 +1045,7 @@ QQmlType QQmlMetaType::typeForUrl(const QString &urlString,
             ? QQmlType::CompositeSingletonType
             : QQmlType::CompositeType;
     if (checkRegistration(registrationType, data, nullptr, typeName, version, {})) {
+        data.retireSnapshot();
         auto *priv = new QQmlTypePrivate(registrationType);
         priv->setName(QString(), typeName);
         priv->version = version;
@@ -1180,11 +1305,13 @@ QQmlType QQmlMetaType::qmlType(const QString &qualifiedName, QTypeRevision versi
 QQmlType QQmlMetaType::qmlType(const QHashedStringRef &name, const QHashedStringRef &module,
                                QTypeRevision version)
 {
-    const QQmlMetaTypeDataPtr data;
+    const QQmlMetaTypeSnapshotPtr snapshot;
+    if (!snapshot.isValid())
+        return QQmlType();
 
     const QHashedString key(QString::fromRawData(name.constData(), name.length()), name.hash());
-    QQmlMetaTypeData::Names::ConstIterator it = data->nameToType.constFind(key);
-    while (it != data->nameToType.cend() && it.key() == name) {
+    QQmlMetaTypeData::Names::ConstIterator it = snapshot->nameToType.constFind(key);
+    while (it != snapshot->nameToType.cend() && it.key() == name) {
         QQmlType t(*it);
         if (module.isEmpty() || t.availableInVersion(module, version))
             return t;
@@ -1200,8 +1327,8 @@ QQmlType QQmlMetaType::qmlType(const QHashedStringRef &name, const QHashedString
 */
 QQmlType QQmlMetaType::qmlType(const QMetaObject *metaObject)
 {
-    const QQmlMetaTypeDataPtr data;
-    return QQmlType(data->metaObjectToType.value(metaObject));
+    const QQmlMetaTypeSnapshotPtr snapshot;
+    return snapshot.isValid() ? QQmlType(snapshot->metaObjectToType.value(metaObject)) : QQmlType();
 }
 
 /*!
@@ -1212,9 +1339,11 @@ QQmlType QQmlMetaType::qmlType(const QMetaObject *metaObject)
 QQmlType QQmlMetaType::qmlType(const QMetaObject *metaObject, const QHashedStringRef &module,
                                QTypeRevision version)
 {
-    const QQmlMetaTypeDataPtr data;
+    const QQmlMetaTypeSnapshotPtr snapshot;
+    if (!snapshot.isValid())
+        return QQmlType();
 
-    const auto range = data->metaObjectToType.equal_range(metaObject);
+    const auto range = snapshot->metaObjectToType.equal_range(metaObject);
     for (auto it = range.first; it != range.second; ++it) {
         QQmlType t(*it);
         if (module.isEmpty() || t.availableInVersion(module, version))
@@ -1243,15 +1372,15 @@ QQmlType QQmlMetaType::qmlTypeById(int qmlTypeId)
 */
 QQmlType QQmlMetaType::qmlType(QMetaType metaType)
 {
-    const QQmlMetaTypeDataPtr data;
-    QQmlTypePrivate *type = data->idToType.value(metaType.id());
+    const QQmlMetaTypeSnapshotPtr snapshot;
+    QQmlTypePrivate *type = snapshot.isValid() ? snapshot->idToType.value(metaType.id()) : nullptr;
     return (type && type->typeId == metaType) ? QQmlType(type) : QQmlType();
 }
 
 QQmlType QQmlMetaType::qmlListType(QMetaType metaType)
 {
-    const QQmlMetaTypeDataPtr data;
-    QQmlTypePrivate *type = data->idToType.value(metaType.id());
+    const QQmlMetaTypeSnapshotPtr snapshot;
+    QQmlTypePrivate *type = snapshot.isValid() ? snapshot->idToType.value(metaType.id()) : nullptr;
     return (type && type->listId == metaType) ? QQmlType(type) : QQmlType();
 }
 
@@ -1264,11 +1393,15 @@ QQmlType QQmlMetaType::qmlListType(QMetaType metaType)
 QQmlType QQmlMetaType::qmlType(const QUrl &unNormalizedUrl, bool includeNonFileImports /* = false */)
 {
     const QUrl url = QQmlTypeLoader::normalize(unNormalizedUrl);
-    const QQmlMetaTypeDataPtr data;
-
-    QQmlType type(data->urlToType.value(url));
-    if (!type.isValid() && includeNonFileImports)
-        type = QQmlType(data->urlToNonFileImportType.value(url));
+    QQmlType type;
+    {
+        const QQmlMetaTypeSnapshotPtr snapshot;
+        if (snapshot.isValid()) {
+            type = QQmlType(snapshot->urlToType.value(url));
+            if (!type.isValid() && includeNonFileImports)
+                type = QQmlType(snapshot->urlToNonFileImportType.value(url));
+        }
+    }
 
     if (type.sourceUrl() == url)
         return type;
@@ -1403,6 +1536,7 @@ void QQmlMetaType::unregisterType(int typeIndex)
     QQmlMetaTypeDataPtr data;
     const QQmlType type = data->types.value(typeIndex);
     if (const QQmlTypePrivate *d = type.priv()) {
+        data.retireSnapshot();
         removeQQmlTypePrivate(data->idToType, d);
         removeQQmlTypePrivate(data->nameToType, d);
         removeQQmlTypePrivate(data->urlToType, d);
@@ -1421,6 +1555,7 @@ void QQmlMetaType::registerMetaObjectForType(const QMetaObject *metaobject, QQml
     Q_ASSERT(type);
 
     QQmlMetaTypeDataPtr data;
+    data.retireSnapshot();
     data->metaObjectToType.insert(metaobject, type);
 }
 
@@ -1442,6 +1577,9 @@ void QQmlMetaType::freeUnusedTypesAndCaches()
     if (!data.isValid())
         return;
 
+    // No lookup may hold a type without a reference while the counts are checked
+    data.retireSnapshot();
+
     bool deletedAtLeastOneType;
     do {
         deletedAtLeastOneType = false;
@@ -1554,35 +1692,76 @@ static bool isFullyTyped(const QQmlPrivate::CachedQmlUnit *unit)
     return numTypedFunctions == unit->qmlData->functionTableSize;
 }
 
+using CompilationUnitBundles = std::vector<std::unique_ptr<QV4::CompilationUnitBundle>>;
+
+static CompilationUnitBundles loadEnvironmentBundles()
+{
+    CompilationUnitBundles bundles;
+    const QString fileNames = qEnvironmentVariable("QML_COMPILATION_UNIT_BUNDLES");
+    for (const QString &fileName : fileNames.split(QDir::listSeparator(), Qt::SkipEmptyParts)) {
+        QString error;
+        if (auto bundle = QV4::CompilationUnitBundle::open(fileName, &error))
+            bundles.push_back(std::move(bundle));
+        else
+            qWarning("Cannot load compilation unit bundle %s: %s", qPrintable(fileName), qPrintable(error));
+    }
+    return bundles;
+}
+
+// Units found in bundles set bundleSourceTimeStamp, see CompilationUnitBundle::find().
+static const QQmlPrivate::CachedQmlUnit *lookupCachedUnit(
+        QQmlMetaTypeData *data, const CompilationUnitBundles &environmentBundles, const QUrl &uri,
+        QDateTime *bundleSourceTimeStamp)
+{
+    for (const auto lookup : std::as_const(data->lookupCachedQmlUnit)) {
+        if (const QQmlPrivate::CachedQmlUnit *unit = lookup(uri))
+            return unit;
+    }
+
+    for (const auto *bundles : { &data->compilationUnitBundles, &environmentBundles }) {
+        for (const auto &bundle : *bundles) {
+            if (const QQmlPrivate::CachedQmlUnit *unit = bundle->find(uri, bundleSourceTimeStamp))
+                return unit;
+        }
+    }
+
+    return nullptr;
+}
+
 const QQmlPrivate::CachedQmlUnit *QQmlMetaType::findCachedCompilationUnit(
         const QUrl &uri, QQmlMetaType::CacheMode mode, CachedUnitLookupError *status)
 {
     Q_ASSERT(mode != RejectAll);
-    const QQmlMetaTypeDataPtr data;
 
-    for (const auto lookup : std::as_const(data->lookupCachedQmlUnit)) {
-        if (const QQmlPrivate::CachedQmlUnit *unit = lookup(uri)) {
-            QString error;
-            if (!QV4::ExecutableCompilationUnit::verifyHeader(unit->qmlData, QDateTime(), &error)) {
-                qCDebug(DBG_DISK_CACHE) << "Error loading pre-compiled file " << uri << ":" << error;
-                if (status)
-                    *status = CachedUnitLookupError::VersionMismatch;
-                return nullptr;
-            }
+    // Mapping the bundles touches the file system. Don't do that with the lock held.
+    static const CompilationUnitBundles environmentBundles = loadEnvironmentBundles();
 
-            if (mode == RequireFullyTyped && !isFullyTyped(unit)) {
-                qCDebug(DBG_DISK_CACHE)
-                        << "Error loading pre-compiled file " << uri
-                        << ": compilation unit contains functions not compiled to native code.";
-                if (status)
-                    *status = CachedUnitLookupError::NotFullyTyped;
-                return nullptr;
-            }
+    QQmlMetaTypeDataPtr data;
 
+    // Bundled units of local files may be older than their sources.
+    QDateTime sourceTimeStamp;
+    if (const QQmlPrivate::CachedQmlUnit *unit
+            = lookupCachedUnit(data, environmentBundles, uri, &sourceTimeStamp)) {
+        QString error;
+        if (!QV4::ExecutableCompilationUnit::verifyHeader(unit->qmlData, sourceTimeStamp, &error)) {
+            qCDebug(DBG_DISK_CACHE) << "Error loading pre-compiled file " << uri << ":" << error;
             if (status)
-                *status = CachedUnitLookupError::NoError;
-            return unit;
+                *status = CachedUnitLookupError::VersionMismatch;
+            return nullptr;
         }
+
+        if (mode == RequireFullyTyped && !isFullyTyped(unit)) {
+            qCDebug(DBG_DISK_CACHE)
+                    << "Error loading pre-compiled file " << uri
+                    << ": compilation unit contains functions not compiled to native code.";
+            if (status)
+                *status = CachedUnitLookupError::NotFullyTyped;
+            return nullptr;
+        }
+
+        if (status)
+            *status = CachedUnitLookupError::NoError;
+        return unit;
     }
 
     if (status)
@@ -1591,6 +1770,23 @@ const QQmlPrivate::CachedQmlUnit *QQmlMetaType::findCachedCompilationUnit(
     return nullptr;
 }
 
+/*!
+    Maps the compilation unit bundle \a fileName, so that the units it contains are
+    found by findCachedCompilationUnit(), after the units linked into the application.
+    Bundles listed in the \c QML_COMPILATION_UNIT_BUNDLES environment variable are
+    added automatically. Bundles are never unloaded.
+*/
+bool QQmlMetaType::addCompilationUnitBundle(const QString &fileName, QString *errorString)
+{
+    auto bundle = QV4::CompilationUnitBundle::open(fileName, errorString);
+    if (!bundle)
+        return false;
+
+    QQmlMetaTypeDataPtr data;
+    data->compilationUnitBundles.push_back(std::move(bundle));
+    return true;
+}
+
 void QQmlMetaType::prependCachedUnitLookupFunction(QQmlPrivate::QmlUnitCacheLookupFunction handler)
 {
     QQmlMetaTypeDataPtr data;
@@ -193,6 +193,8 @@ public:
     static const QQmlPrivate::CachedQmlUnit *findCachedCompilationUnit(
             const QUrl &uri, CacheMode mode, CachedUnitLookupError *status);
 
+    static bool addCompilationUnitBundle(const QString &fileName, QString *errorString);
+
     // used by tst_qqmlcachegen.cpp
     static void prependCachedUnitLookupFunction(QQmlPrivate::QmlUnitCacheLookupFunction handler);
     static void removeCachedUnitLookupFunction(QQmlPrivate::QmlUnitCacheLookupFunction handler);
@@ -19,6 +19,7 @@
 #include <private/qqmlmetatype_p.h>
 #include <private/qhashedstring_p.h>
 #include <private/qqmlvaluetype_p.h>
+#include <private/qv4compilationunitbundle_p.h>
 
 #include <QtCore/qset.h>
 #include <QtCore/qvector.h>
@@ -93,6 +94,7 @@ struct QQmlMetaTypeData
 
     QList<QQmlPrivate::AutoParentFunction> parentFunctions;
     QVector<QQmlPrivate::QmlUnitCacheLookupFunction> lookupCachedQmlUnit;
+    std::vector<std::unique_ptr<QV4::CompilationUnitBundle>> compilationUnitBundles;
 
     QHash<const QMetaObject *, QQmlPropertyCache::ConstPtr> propertyCaches;
 
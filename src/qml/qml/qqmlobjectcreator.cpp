@@ -170,6 +170,8 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
         sharedState->rootContext = context;
         sharedState->rootContext->setIncubator(incubator);
         sharedState->rootContext->setRootObjectInCreation(true);
+        sharedState->rootContext->setBindingArena(
+                QQmlBindingArena::create(compilationUnit->totalBindingsCount()));
     }
 
     QV4::Scope scope(v4);
@@ -282,6 +284,47 @@ void QQmlObjectCreator::finalizePopulateDeferred()
     phase = ObjectsCreated;
 }
 
+// Converts the string of a literal binding to a type that QML spells as a string
+static QVariant literalFromString(const QString &string, QMetaType type)
+{
+    bool ok = false;
+    QVariant value;
+    switch (type.id()) {
+#if QT_CONFIG(datestring)
+    case QMetaType::QDate:
+        value = QQmlStringConverters::dateFromString(string, &ok);
+        break;
+    case QMetaType::QTime:
+        value = QQmlStringConverters::timeFromString(string, &ok);
+        break;
+    case QMetaType::QDateTime:
+        value = QQmlStringConverters::dateTimeFromString(string, &ok);
+        break;
+#endif // datestring
+    case QMetaType::QPoint:
+        value = QQmlStringConverters::pointFFromString(string, &ok).toPoint();
+        break;
+    case QMetaType::QPointF:
+        value = QQmlStringConverters::pointFFromString(string, &ok);
+        break;
+    case QMetaType::QSize:
+        value = QQmlStringConverters::sizeFFromString(string, &ok).toSize();
+        break;
+    case QMetaType::QSizeF:
+        value = QQmlStringConverters::sizeFFromString(string, &ok);
+        break;
+    case QMetaType::QRect:
+        value = QQmlStringConverters::rectFFromString(string, &ok).toRect();
+        break;
+    case QMetaType::QRectF:
+        value = QQmlStringConverters::rectFFromString(string, &ok);
+        break;
+    default:
+        return QQmlValueTypeProvider::createValueType(string, type);
+    }
+    return ok ? value : QVariant();
+}
+
 void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding)
 {
     QQmlPropertyData::WriteFlags propertyWriteFlags = QQmlPropertyData::BypassInterceptor | QQmlPropertyData::RemoveBindingOnAliasWrite;
@@ -391,10 +434,16 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
     case QMetaType::QUrl: {
         assertType(QV4::CompiledData::Binding::Type_String);
         const QString string = compilationUnit->bindingValueAsString(binding);
-        QUrl value = (!string.isEmpty() && QQmlPropertyPrivate::resolveUrlsOnAssignment())
-                ? compilationUnit->finalUrl().resolved(QUrl(string))
-                : QUrl(string);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
+        if (!string.isEmpty() && QQmlPropertyPrivate::resolveUrlsOnAssignment()) {
+            QUrl value = compilationUnit->finalUrl().resolved(QUrl(string));
+            property->writeProperty(_qobject, &value, propertyWriteFlags);
+            break;
+        }
+        // Only unresolved URLs are cached, so that the cache doesn't depend on the setting
+        QVariant value = convertedLiteral(binding, propertyType, [&]() {
+            return QVariant(QUrl(string));
+        });
+        property->writeProperty(_qobject, value.data(), propertyWriteFlags);
     }
     break;
     case QMetaType::UInt: {
@@ -426,77 +475,32 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
     }
     break;
     case QMetaType::QColor: {
-        QVariant data = QQmlValueTypeProvider::createValueType(
-                    compilationUnit->bindingValueAsString(binding), propertyType);
+        QVariant data = convertedLiteral(binding, propertyType, [&]() {
+            return literalFromString(compilationUnit->bindingValueAsString(binding), propertyType);
+        });
         if (data.isValid()) {
             property->writeProperty(_qobject, data.data(), propertyWriteFlags);
         }
     }
     break;
 #if QT_CONFIG(datestring)
-    case QMetaType::QDate: {
-        bool ok = false;
-        QDate value = QQmlStringConverters::dateFromString(compilationUnit->bindingValueAsString(binding), &ok);
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
-    case QMetaType::QTime: {
-        bool ok = false;
-        QTime value = QQmlStringConverters::timeFromString(compilationUnit->bindingValueAsString(binding), &ok);
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
-    case QMetaType::QDateTime: {
-        bool ok = false;
-        QDateTime value = QQmlStringConverters::dateTimeFromString(
-                    compilationUnit->bindingValueAsString(binding), &ok);
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
+    case QMetaType::QDate:
+    case QMetaType::QTime:
+    case QMetaType::QDateTime:
 #endif // datestring
-    case QMetaType::QPoint: {
-        bool ok = false;
-        QPoint value = QQmlStringConverters::pointFFromString(compilationUnit->bindingValueAsString(binding), &ok).toPoint();
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
-    case QMetaType::QPointF: {
-        bool ok = false;
-        QPointF value = QQmlStringConverters::pointFFromString(compilationUnit->bindingValueAsString(binding), &ok);
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
-    case QMetaType::QSize: {
-        bool ok = false;
-        QSize value = QQmlStringConverters::sizeFFromString(compilationUnit->bindingValueAsString(binding), &ok).toSize();
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
-    case QMetaType::QSizeF: {
-        bool ok = false;
-        QSizeF value = QQmlStringConverters::sizeFFromString(compilationUnit->bindingValueAsString(binding), &ok);
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
-    case QMetaType::QRect: {
-        bool ok = false;
-        QRect value = QQmlStringConverters::rectFFromString(compilationUnit->bindingValueAsString(binding), &ok).toRect();
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
-    }
-    break;
+    case QMetaType::QPoint:
+    case QMetaType::QPointF:
+    case QMetaType::QSize:
+    case QMetaType::QSizeF:
+    case QMetaType::QRect:
     case QMetaType::QRectF: {
-        bool ok = false;
-        QRectF value = QQmlStringConverters::rectFFromString(compilationUnit->bindingValueAsString(binding), &ok);
-        assertOrNull(ok);
-        property->writeProperty(_qobject, &value, propertyWriteFlags);
+        QVariant value = convertedLiteral(binding, propertyType, [&]() {
+            return literalFromString(compilationUnit->bindingValueAsString(binding), propertyType);
+        });
+        assertOrNull(value.isValid());
+        if (!value.isValid())
+            value = QVariant(propertyType);
+        property->writeProperty(_qobject, value.data(), propertyWriteFlags);
     }
     break;
     case QMetaType::Bool: {
@@ -509,8 +513,9 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
     case QMetaType::QVector3D:
     case QMetaType::QVector4D:
     case QMetaType::QQuaternion: {
-        QVariant result = QQmlValueTypeProvider::createValueType(
-                    compilationUnit->bindingValueAsString(binding), propertyType);
+        QVariant result = convertedLiteral(binding, propertyType, [&]() {
+            return literalFromString(compilationUnit->bindingValueAsString(binding), propertyType);
+        });
         assertOrNull(result.isValid());
         property->writeProperty(_qobject, result.data(), propertyWriteFlags);
         break;
@@ -576,30 +581,32 @@ void QQmlObjectCreator::setPropertyValue(const QQmlPropertyData *property, const
             property->writeProperty(_qobject, &value, propertyWriteFlags);
             break;
         } else {
-            QVariant source;
-            switch (binding->type()) {
-            case QV4::CompiledData::Binding::Type_Boolean:
-                source = binding->valueAsBoolean();
-                break;
-            case QV4::CompiledData::Binding::Type_Number: {
-                const double n = compilationUnit->bindingValueAsNumber(binding);
-                if (double(int(n)) == n)
-                    source = int(n);
-                else
-                    source = n;
-                break;
-            }
-            case QV4::CompiledData::Binding::Type_Null:
-                source = QVariant::fromValue<std::nullptr_t>(nullptr);
-                break;
-            case QV4::CompiledData::Binding::Type_Invalid:
-                break;
-            default:
-                source = compilationUnit->bindingValueAsString(binding);
-                break;
-            }
+            QVariant target = convertedLiteral(binding, propertyType, [&]() {
+                QVariant source;
+                switch (binding->type()) {
+                case QV4::CompiledData::Binding::Type_Boolean:
+                    source = binding->valueAsBoolean();
+                    break;
+                case QV4::CompiledData::Binding::Type_Number: {
+                    const double n = compilationUnit->bindingValueAsNumber(binding);
+                    if (double(int(n)) == n)
+                        source = int(n);
+                    else
+                        source = n;
+                    break;
+                }
+                case QV4::CompiledData::Binding::Type_Null:
+                    source = QVariant::fromValue<std::nullptr_t>(nullptr);
+                    break;
+                case QV4::CompiledData::Binding::Type_Invalid:
+                    break;
+                default:
+                    source = compilationUnit->bindingValueAsString(binding);
+                    break;
+                }
 
-            QVariant target = QQmlValueTypeProvider::createValueType(source, propertyType);
+                return QQmlValueTypeProvider::createValueType(source, propertyType);
+            });
             if (target.isValid()) {
                 property->writeProperty(_qobject, target.data(), propertyWriteFlags);
                 break;
@@ -757,6 +764,7 @@ void QQmlObjectCreator::setupBindings(BindingSetupFlags mode)
 
 bool QQmlObjectCreator::setPropertyBinding(const QQmlPropertyData *bindingProperty, const QV4::CompiledData::Binding *binding)
 {
+    const QQmlBindingArena::Scope arenaScope(sharedState->rootContext->bindingArena());
     const QV4::CompiledData::Binding::Type bindingType = binding->type();
     if (bindingType == QV4::CompiledData::Binding::Type_AttachedProperty) {
         Q_ASSERT(stringAt(compilationUnit->objectAt(binding->value.objectIndex)->inheritedTypeNameIndex).isEmpty());
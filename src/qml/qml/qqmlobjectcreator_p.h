@@ -177,6 +177,20 @@ private:
     void setPropertyValue(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding);
     void setupFunctions();
 
+    // Returns the literal value of binding converted to type. The conversion
+    // only runs for the first object created from the compilation unit.
+    template<typename Converter>
+    QVariant convertedLiteral(const QV4::CompiledData::Binding *binding, QMetaType type,
+                              Converter convert)
+    {
+        const auto it = compilationUnit->convertedLiterals.constFind(binding);
+        if (it != compilationUnit->convertedLiterals.cend() && it->metaType() == type)
+            return *it;
+        const QVariant literal = convert();
+        compilationUnit->convertedLiterals.insert(binding, literal);
+        return literal;
+    }
+
     QString stringAt(int idx) const { return compilationUnit->stringAt(idx); }
     void recordError(const QV4::CompiledData::Location &location, const QString &description);
 
@@ -272,6 +272,8 @@ QTypeRevision QQmlPluginImporter::importDynamicPlugin(
                     return QTypeRevision();
                 }
 
+                typeLoader->recordStartupProfile(QQmlStartupProfile::Plugin, absoluteFilePath);
+
                 QmlPlugin plugin;
                 plugin.loader = std::make_unique<QPluginLoader>(absoluteFilePath);
                 if (!plugin.loader->load()) {
@@ -54,46 +54,22 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         return;
     }
 
-    QString error;
-    QString source = data.readAll(&error);
-    if (!error.isEmpty()) {
-        setError(error);
-        return;
-    }
-
     QV4::CompiledData::CompilationUnit unit;
-
-    if (m_isModule) {
-        QList<QQmlJS::DiagnosticMessage> diagnostics;
-        unit = QV4::Compiler::Codegen::compileModule(isDebugging(), urlString(), source,
-                                                     data.sourceTimeStamp(), &diagnostics);
-        QList<QQmlError> errors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString(), diagnostics);
-        if (!errors.isEmpty()) {
-            setError(errors);
+    if (!typeLoader()->takePrefetchedScript(this, data, &unit)) {
+        QString error;
+        const QString source = data.readAll(&error);
+        if (!error.isEmpty()) {
+            setError(error);
             return;
         }
-    } else {
-        QmlIR::Document irUnit(isDebugging());
-
-        irUnit.jsModule.sourceTimeStamp = data.sourceTimeStamp();
-
-        QmlIR::ScriptDirectivesCollector collector(&irUnit);
-        irUnit.jsParserEngine.setDirectives(&collector);
 
         QList<QQmlError> errors;
-        irUnit.javaScriptCompilationUnit = QV4::Script::precompile(
-                     &irUnit.jsModule, &irUnit.jsParserEngine, &irUnit.jsGenerator, urlString(), finalUrlString(),
-                     source, &errors, QV4::Compiler::ContextType::ScriptImportedByQML);
-
-        source.clear();
+        unit = compile(source, urlString(), finalUrlString(), data.sourceTimeStamp(), m_isModule,
+                       isDebugging(), &errors);
         if (!errors.isEmpty()) {
             setError(errors);
             return;
         }
-
-        QmlIR::QmlUnitGenerator qmlGenerator;
-        qmlGenerator.generate(irUnit);
-        unit = std::move(irUnit.javaScriptCompilationUnit);
     }
 
     auto executableUnit = QV4::ExecutableCompilationUnit::create(std::move(unit));
@@ -114,6 +90,43 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
     initializeFromCompilationUnit(executableUnit);
 }
 
+/*!
+    \internal
+
+    Compiles the JavaScript \a source of a script or, if \a isModule is set, of an ECMAScript
+    module. This does not touch the type loader or the engine, so that it can also run on the
+    type loader's parse pool.
+*/
+QV4::CompiledData::CompilationUnit QQmlScriptBlob::compile(
+        const QString &source, const QString &urlString, const QString &finalUrlString,
+        const QDateTime &sourceTimeStamp, bool isModule, bool debugging, QList<QQmlError> *errors)
+{
+    if (isModule) {
+        QList<QQmlJS::DiagnosticMessage> diagnostics;
+        QV4::CompiledData::CompilationUnit unit = QV4::Compiler::Codegen::compileModule(
+                debugging, urlString, source, sourceTimeStamp, &diagnostics);
+        *errors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString, diagnostics);
+        return unit;
+    }
+
+    QmlIR::Document irUnit(debugging);
+
+    irUnit.jsModule.sourceTimeStamp = sourceTimeStamp;
+
+    QmlIR::ScriptDirectivesCollector collector(&irUnit);
+    irUnit.jsParserEngine.setDirectives(&collector);
+
+    irUnit.javaScriptCompilationUnit = QV4::Script::precompile(
+                &irUnit.jsModule, &irUnit.jsParserEngine, &irUnit.jsGenerator, urlString,
+                finalUrlString, source, errors, QV4::Compiler::ContextType::ScriptImportedByQML);
+    if (!errors->isEmpty())
+        return QV4::CompiledData::CompilationUnit();
+
+    QmlIR::QmlUnitGenerator qmlGenerator;
+    qmlGenerator.generate(irUnit);
+    return std::move(irUnit.javaScriptCompilationUnit);
+}
+
 void QQmlScriptBlob::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit)
 {
     initializeFromCompilationUnit(QV4::ExecutableCompilationUnit::create(
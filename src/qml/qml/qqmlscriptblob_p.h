@@ -40,6 +40,11 @@ public:
 
     QQmlRefPointer<QQmlScriptData> scriptData() const;
 
+    static QV4::CompiledData::CompilationUnit compile(
+            const QString &source, const QString &urlString, const QString &finalUrlString,
+            const QDateTime &sourceTimeStamp, bool isModule, bool debugging,
+            QList<QQmlError> *errors);
+
 protected:
     void dataReceived(const SourceCodeData &) override;
     void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
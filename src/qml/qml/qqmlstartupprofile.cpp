@@ -0,0 +1,286 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlstartupprofile_p.h"
+
+#include <private/qv4compilationunitmapper_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+
+#include <QtQml/qqmlfile.h>
+
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qsavefile.h>
+#if QT_CONFIG(library)
+#include <QtCore/qpluginloader.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcStartupProfile, "qt.qml.startupprofile")
+
+static const char ProfileHeader[] = "# Qt QML startup profile 1";
+
+static const char *kindName(QQmlStartupProfile::Kind kind)
+{
+    switch (kind) {
+    case QQmlStartupProfile::Document:
+        return "qml";
+    case QQmlStartupProfile::Script:
+        return "js";
+    case QQmlStartupProfile::Qmldir:
+        return "qmldir";
+    case QQmlStartupProfile::Plugin:
+        return "plugin";
+    }
+    Q_UNREACHABLE_RETURN("");
+}
+
+QQmlStartupProfile::QQmlStartupProfile(const QString &fileName, Mode mode)
+    : m_fileName(fileName), m_mode(mode)
+{
+    m_replayThread.setObjectName(QStringLiteral("QQmlStartupProfile replay"));
+    m_replayThread.setMaxThreadCount(1);
+}
+
+QQmlStartupProfile::~QQmlStartupProfile()
+{
+    m_cancelled = true;
+    waitForReplay();
+
+    if (m_mode == Record && !save())
+        qCWarning(lcStartupProfile) << "Cannot write startup profile" << m_fileName;
+}
+
+/*!
+    \internal
+
+    Returns the startup profile for the file given in \c QML_STARTUP_PROFILE. The
+    profile is recorded if \c QML_STARTUP_PROFILE_MODE is \c record, and replayed
+    if it is \c replay. Without a mode, an existing profile is replayed and a
+    missing one is recorded.
+
+    All type loaders of the process that are alive at the same time share one
+    profile. A recording therefore holds the requests of all of their engines,
+    and is written once the last of them is destroyed.
+*/
+std::shared_ptr<QQmlStartupProfile> QQmlStartupProfile::fromEnvironment()
+{
+    const QString fileName = qEnvironmentVariable("QML_STARTUP_PROFILE");
+    if (fileName.isEmpty())
+        return nullptr;
+
+    static QBasicMutex mutex;
+    static std::weak_ptr<QQmlStartupProfile> current;
+    QMutexLocker locker(&mutex);
+    if (std::shared_ptr<QQmlStartupProfile> profile = current.lock()) {
+        if (profile->fileName() == fileName)
+            return profile;
+    }
+
+    Mode mode = QFile::exists(fileName) ? Replay : Record;
+    const QByteArray modeName = qgetenv("QML_STARTUP_PROFILE_MODE");
+    if (modeName == "record")
+        mode = Record;
+    else if (modeName == "replay")
+        mode = Replay;
+    else if (!modeName.isEmpty())
+        qCWarning(lcStartupProfile) << "Unknown QML_STARTUP_PROFILE_MODE" << modeName;
+
+    auto profile = std::make_shared<QQmlStartupProfile>(fileName, mode);
+    current = profile;
+    return profile;
+}
+
+/*!
+    \internal
+
+    Appends \a location to the recording, unless it was recorded before. This is
+    called from both the engine's and the type loader's thread.
+*/
+void QQmlStartupProfile::record(Kind kind, const QString &location)
+{
+    if (m_mode != Record || location.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    const QString key = QLatin1String(kindName(kind)) + QLatin1Char(' ') + location;
+    if (m_recorded.contains(key))
+        return;
+    m_recorded.insert(key);
+    m_entries.append({ kind, location });
+}
+
+QList<QQmlStartupProfile::Entry> QQmlStartupProfile::entries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries;
+}
+
+bool QQmlStartupProfile::save() const
+{
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    file.write(ProfileHeader);
+    file.write("\n");
+    for (const Entry &entry : entries()) {
+        file.write(kindName(entry.kind));
+        file.write(" ");
+        file.write(entry.location.toUtf8());
+        file.write("\n");
+    }
+    return file.commit();
+}
+
+QList<QQmlStartupProfile::Entry> QQmlStartupProfile::load(const QString &fileName)
+{
+    QList<Entry> result;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return result;
+
+    if (file.readLine().trimmed() != ProfileHeader) {
+        qCWarning(lcStartupProfile) << "Ignoring startup profile of unknown format" << fileName;
+        return result;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        const qsizetype separator = line.indexOf(' ');
+        if (separator <= 0)
+            continue;
+
+        const QByteArray kind = line.left(separator);
+        const QString location = QString::fromUtf8(line.mid(separator + 1));
+        for (Kind candidate : { Document, Script, Qmldir, Plugin }) {
+            if (kind == kindName(candidate)) {
+                result.append({ candidate, location });
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/*!
+    \internal
+
+    Starts replaying the profile on a background thread, unless another type loader
+    sharing the profile has started it already. If \a mapCacheFiles is set, the
+    compilation units are mapped from the cache files that the type loader would
+    use; otherwise the sources are read.
+
+    The replay only reads files and never touches a type loader, so that it cannot
+    block on the type loader's lock.
+*/
+void QQmlStartupProfile::startReplay(bool mapCacheFiles)
+{
+    if (m_mode != Replay || m_replayStarted.exchange(true))
+        return;
+
+    QList<Entry> entries = load(m_fileName);
+    if (entries.isEmpty())
+        return;
+
+    qCDebug(lcStartupProfile) << "Replaying" << entries.size() << "entries from" << m_fileName;
+    m_replayThread.start([this, entries = std::move(entries), mapCacheFiles]() {
+        replay(entries, mapCacheFiles);
+    });
+}
+
+void QQmlStartupProfile::waitForReplay()
+{
+    m_replayThread.waitForDone();
+}
+
+static void touchPages(const void *data, size_t size)
+{
+    // Fault the pages in here, rather than when the engine first reads them.
+    const volatile char *bytes = static_cast<const char *>(data);
+    for (size_t offset = 0; offset < size; offset += 4096)
+        (void)bytes[offset];
+}
+
+static bool mapCompilationUnit(const QUrl &url, const QString &sourcePath,
+                               const QDateTime &sourceTimeStamp)
+{
+    // Mapped units carrying the StaticData flag stay in the mapper's cache, so that
+    // ExecutableCompilationUnit::loadFromDisk() picks them up without opening the file.
+    const QStringList cachePaths
+            = { sourcePath + QLatin1Char('c'),
+                QV4::ExecutableCompilationUnit::localCacheFilePath(url) };
+    for (const QString &cachePath : cachePaths) {
+        QV4::CompilationUnitMapper mapper;
+        QString error;
+        if (const QV4::CompiledData::Unit *unit = mapper.get(cachePath, sourceTimeStamp, &error)) {
+            touchPages(unit, unit->unitSize);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const qint64 size = file.size();
+    if (const uchar *data = file.map(0, size)) {
+        touchPages(data, size_t(size));
+        file.unmap(const_cast<uchar *>(data));
+    } else {
+        file.readAll();
+    }
+}
+
+void QQmlStartupProfile::replay(const QList<Entry> &entries, bool mapCacheFiles)
+{
+    for (const Entry &entry : entries) {
+        if (m_cancelled)
+            return;
+
+        switch (entry.kind) {
+        case Document:
+        case Script: {
+            const QUrl url(entry.location);
+            if (url.scheme() != QLatin1String("file"))
+                break; // Resources are compiled in, remote files are not ours to fetch.
+
+            const QString path = QQmlFile::urlToLocalFileOrQrc(url);
+            const QFileInfo info(path);
+            if (!info.exists())
+                break;
+            if (!mapCacheFiles || !mapCompilationUnit(url, path, info.lastModified()))
+                readFile(path);
+            break;
+        }
+        case Qmldir: {
+            // Only warm the page cache. Filling the type loader's qmldir cache would
+            // need the type loader's lock, see startReplay().
+            const QUrl url(entry.location);
+            readFile(url.scheme().size() < 2 ? entry.location
+                                             : QQmlFile::urlToLocalFileOrQrc(url));
+            break;
+        }
+        case Plugin: {
+#if QT_CONFIG(library)
+            // The library stays loaded, so that the plugin importer only has to
+            // look it up. The plugin instance is still created on demand.
+            QPluginLoader loader(entry.location);
+            if (!loader.load())
+                qCDebug(lcStartupProfile) << "Cannot preload" << entry.location << loader.errorString();
+#endif
+            break;
+        }
+        }
+        ++m_replayedEntries;
+    }
+}
+
+QT_END_NAMESPACE
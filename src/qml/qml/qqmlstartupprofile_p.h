@@ -0,0 +1,92 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLSTARTUPPROFILE_P_H
+#define QQMLSTARTUPPROFILE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtqmlglobal_p.h>
+
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qthreadpool.h>
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Records the order in which a type loader requests documents, scripts, qmldir
+    files and plugins, and replays such a recording on a later start: All the
+    files found in the recording are read, their cache files mapped and the
+    plugins loaded on a background thread, ahead of the type loader asking for
+    them. This overlaps the I/O with the parsing and compilation, which would
+    otherwise discover the files one by one.
+*/
+class Q_AUTOTEST_EXPORT QQmlStartupProfile
+{
+    Q_DISABLE_COPY_MOVE(QQmlStartupProfile)
+public:
+    enum Kind { Document, Script, Qmldir, Plugin };
+
+    struct Entry
+    {
+        Kind kind;
+        QString location;
+    };
+
+    enum Mode { Record, Replay };
+
+    QQmlStartupProfile(const QString &fileName, Mode mode);
+    ~QQmlStartupProfile();
+
+    static std::shared_ptr<QQmlStartupProfile> fromEnvironment();
+
+    Mode mode() const { return m_mode; }
+    QString fileName() const { return m_fileName; }
+
+    void record(Kind kind, const QString &location);
+    QList<Entry> entries() const;
+    bool save() const;
+
+    void startReplay(bool mapCacheFiles);
+    void waitForReplay();
+    // The number of entries the replay has worked through so far.
+    int replayedEntries() const { return m_replayedEntries; }
+
+    static QList<Entry> load(const QString &fileName);
+
+private:
+    void replay(const QList<Entry> &entries, bool mapCacheFiles);
+
+    const QString m_fileName;
+    const Mode m_mode;
+
+    mutable QMutex m_mutex;
+    QList<Entry> m_entries;
+    QSet<QString> m_recorded;
+
+    QThreadPool m_replayThread;
+    std::atomic<bool> m_replayStarted = false;
+    std::atomic<bool> m_cancelled = false;
+    std::atomic<int> m_replayedEntries = 0;
+};
+
+Q_DECLARE_TYPEINFO(QQmlStartupProfile::Entry, Q_RELOCATABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QQMLSTARTUPPROFILE_P_H
@@ -647,6 +647,9 @@ void QQmlTypeData::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *un
 
 bool QQmlTypeData::loadFromSource()
 {
+    if (typeLoader()->takePrefetchedDocument(this, m_backupSourceCode, &m_document))
+        return true;
+
     m_document.reset(new QmlIR::Document(isDebugging()));
     m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
     QQmlEngine *qmlEngine = typeLoader()->engine();
@@ -833,6 +836,8 @@ void QQmlTypeData::compile(const QQmlRefPointer<QQmlTypeNameCache> &typeNameCach
 
 void QQmlTypeData::resolveTypes()
 {
+    prefetchDependencies();
+
     // Add any imported scripts to our resolved set
     const auto resolvedScripts = m_importCache->resolvedScripts();
     for (const QQmlImports::ScriptReference &script : resolvedScripts) {
@@ -930,6 +935,46 @@ void QQmlTypeData::resolveTypes()
         loadImplicitImport();
 }
 
+/*!
+    \internal
+
+    Hands the scripts and the composite types this document refers to to the type loader's
+    parse pool, so that they are parsed in parallel while resolveTypes() loads them one by
+    one. Resolution errors are ignored here, they are reported by resolveTypes().
+*/
+void QQmlTypeData::prefetchDependencies()
+{
+    QQmlTypeLoader *loader = typeLoader();
+    if (!loader->canPrefetch())
+        return;
+
+    const auto resolvedScripts = m_importCache->resolvedScripts();
+    for (const QQmlImports::ScriptReference &script : resolvedScripts)
+        loader->prefetchScript(script.location);
+
+    const auto prefetchType = [&](const QString &typeName, QQmlType::RegistrationType registrationType) {
+        QQmlType type;
+        QTypeRevision version;
+        QQmlImportNamespace *typeNamespace = nullptr;
+        QList<QQmlError> errors;
+        if (m_importCache->resolveType(typeName, &type, &version, &typeNamespace, &errors,
+                                       registrationType)
+                && !typeNamespace && type.isComposite()) {
+            loader->prefetchType(type.sourceUrl());
+        }
+    };
+
+    const auto resolvedCompositeSingletons = m_importCache->resolvedCompositeSingletons();
+    for (const QQmlImports::CompositeSingletonReference &csRef : resolvedCompositeSingletons) {
+        prefetchType(csRef.prefix.isEmpty() ? csRef.typeName
+                                            : csRef.prefix + QLatin1Char('.') + csRef.typeName,
+                     QQmlType::CompositeSingletonType);
+    }
+
+    for (auto it = m_typeReferences.constBegin(), end = m_typeReferences.constEnd(); it != end; ++it)
+        prefetchType(stringAt(it.key()), QQmlType::AnyRegistrationType);
+}
+
 QQmlError QQmlTypeData::buildTypeResolutionCaches(
         QQmlRefPointer<QQmlTypeNameCache> *typeNameCache,
         QV4::ResolvedTypeReferenceMap *resolvedTypeCache) const
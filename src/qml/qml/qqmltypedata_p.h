@@ -85,6 +85,7 @@ protected:
 private:
     bool tryLoadFromDiskCache();
     bool loadFromSource();
+    void prefetchDependencies();
     void restoreIR(QV4::CompiledData::CompilationUnit &&unit);
     void continueLoadFromIR();
     void resolveTypes();
@@ -10,6 +10,8 @@
 #include <private/qqmltypeloaderqmldircontent_p.h>
 #include <private/qqmltypeloaderthread_p.h>
 #include <private/qqmlsourcecoordinate_p.h>
+#include <private/qqmlirbuilder_p.h>
+#include <private/qv4executablecompilationunit_p.h>
 
 #include <QtQml/qqmlabstracturlinterceptor.h>
 #include <QtQml/qqmlengine.h>
@@ -21,6 +23,7 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qsemaphore.h>
 #include <QtCore/qthread.h>
 
 #include <functional>
@@ -432,6 +435,212 @@ void QQmlTypeLoader::setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPriv
     blob->tryDone();
 }
 
+/*!
+\internal
+
+A document or script parsed on the parse pool ahead of its blob. The job only
+touches its own members while running, so it can outlive both the blob and the
+type loader.
+*/
+struct QQmlTypeLoader::PrefetchJob
+{
+    enum State { Queued, Running, Cancelled };
+
+    void run();
+
+    QQmlDataBlob::SourceCodeData data;
+    QString urlString;
+    QSet<QString> illegalNames;
+    QQmlDataBlob::Type type = QQmlDataBlob::QmlFile;
+    bool isModule = false;
+    bool debugging = false;
+
+    std::atomic<int> state = Queued;
+    QSemaphore finished;
+
+    // Only valid after finished was acquired
+    bool ok = false;
+    QDateTime sourceTimeStamp;
+    QScopedPointer<QmlIR::Document> document;
+    QV4::CompiledData::CompilationUnit unit;
+};
+
+void QQmlTypeLoader::PrefetchJob::run()
+{
+    int expected = Queued;
+    if (!state.compare_exchange_strong(expected, Running))
+        return;
+
+    // Any error is left for the blob to report when it parses the source itself.
+    QString error;
+    const QString source = (data.exists() && !data.isEmpty()) ? data.readAll(&error) : QString();
+    if (!source.isEmpty() && error.isEmpty()) {
+        sourceTimeStamp = data.sourceTimeStamp();
+        if (type == QQmlDataBlob::QmlFile) {
+            document.reset(new QmlIR::Document(debugging));
+            document->jsModule.sourceTimeStamp = sourceTimeStamp;
+            QmlIR::IRBuilder compiler(illegalNames);
+            ok = compiler.generateFromQml(source, urlString, document.data());
+        } else {
+            QList<QQmlError> errors;
+            unit = QQmlScriptBlob::compile(source, urlString, urlString, sourceTimeStamp,
+                                           isModule, debugging, &errors);
+            ok = errors.isEmpty();
+        }
+    }
+
+    finished.release();
+}
+
+/*!
+Starts parsing the QML document at \a unNormalizedUrl on the parse pool, if it
+is a local file that is not loaded yet and will not be served from a cache.
+A subsequent load of the document picks up the result.
+
+This is meant to be called from the loader thread right before loading several
+documents one by one, so that their parsing overlaps while the dependencies
+are still resolved in order.
+*/
+void QQmlTypeLoader::prefetchType(const QUrl &unNormalizedUrl)
+{
+    prefetch(normalize(unNormalizedUrl), QQmlDataBlob::QmlFile);
+}
+
+/*!
+Like prefetchType(), but for the JavaScript file or ECMAScript module at \a unNormalizedUrl.
+*/
+void QQmlTypeLoader::prefetchScript(const QUrl &unNormalizedUrl)
+{
+    prefetch(normalize(unNormalizedUrl), QQmlDataBlob::JavaScriptFile);
+}
+
+void QQmlTypeLoader::prefetch(const QUrl &url, QQmlDataBlob::Type type)
+{
+    ASSERT_LOADTHREAD();
+
+    if (!m_parsePool || !QQmlFile::isSynchronous(url))
+        return;
+
+    {
+        LockHolder<QQmlTypeLoader> holder(this);
+        if (type == QQmlDataBlob::QmlFile ? m_typeCache.contains(url) : m_scriptCache.contains(url))
+            return;
+    }
+
+    QV4::ExecutionEngine *v4 = engine()->handle();
+    const QV4::ExecutionEngine::DiskCacheOptions options = v4->diskCacheOptions();
+    if (options & QV4::ExecutionEngine::DiskCache::Aot) {
+        const QQmlMetaType::CacheMode cacheMode
+                = (options & QV4::ExecutionEngine::DiskCache::AotByteCode)
+                ? QQmlMetaType::AcceptUntyped
+                : QQmlMetaType::RequireFullyTyped;
+        if (QQmlMetaType::findCachedCompilationUnit(url, cacheMode, nullptr))
+            return;
+    }
+    if ((options & QV4::ExecutionEngine::DiskCache::QmlcRead)
+            && QFile::exists(QV4::ExecutableCompilationUnit::localCacheFilePath(url))) {
+        return;
+    }
+
+    const QString fileName = QQmlFile::urlToLocalFileOrQrc(url);
+    if (!QQml_isFileCaseCorrect(fileName))
+        return;
+
+    auto job = std::make_shared<PrefetchJob>();
+    job->data.fileInfo = QFileInfo(fileName);
+    job->urlString = url.toString();
+    job->type = type;
+    job->isModule = url.path().endsWith(QLatin1String(".mjs"));
+    job->debugging = v4->debugger() != nullptr;
+    if (type == QQmlDataBlob::QmlFile)
+        job->illegalNames = v4->illegalNames();
+
+    {
+        QMutexLocker locker(&m_prefetchMutex);
+        if (m_prefetchJobs.contains(url))
+            return;
+        m_prefetchJobs.insert(url, job);
+    }
+
+    m_parsePool->start([job]() { job->run(); });
+}
+
+/*!
+Removes the prefetch job for \a url, if any. If the job is already running and
+\a wait is set, waits for it to finish and returns it. Jobs that have not
+started yet are cancelled; the caller is faster parsing on its own than waiting
+for a free worker.
+*/
+std::shared_ptr<QQmlTypeLoader::PrefetchJob> QQmlTypeLoader::takePrefetchJob(
+        const QUrl &url, bool wait)
+{
+    std::shared_ptr<PrefetchJob> job;
+    {
+        QMutexLocker locker(&m_prefetchMutex);
+        if (m_prefetchJobs.isEmpty())
+            return nullptr;
+        job = m_prefetchJobs.take(url);
+    }
+
+    if (!job)
+        return nullptr;
+
+    int expected = PrefetchJob::Queued;
+    if (job->state.compare_exchange_strong(expected, PrefetchJob::Cancelled) || !wait)
+        return nullptr;
+
+    job->finished.acquire();
+    return job;
+}
+
+void QQmlTypeLoader::clearPrefetchJobs()
+{
+    QMutexLocker locker(&m_prefetchMutex);
+    for (const std::shared_ptr<PrefetchJob> &job : std::as_const(m_prefetchJobs)) {
+        int expected = PrefetchJob::Queued;
+        job->state.compare_exchange_strong(expected, PrefetchJob::Cancelled);
+    }
+    m_prefetchJobs.clear();
+}
+
+/*!
+Moves the document prefetched for \a blob into \a document and returns true
+if it was parsed successfully from the same source as \a data.
+*/
+bool QQmlTypeLoader::takePrefetchedDocument(
+        const QQmlDataBlob *blob, const QQmlDataBlob::SourceCodeData &data,
+        QScopedPointer<QmlIR::Document> *document)
+{
+    const std::shared_ptr<PrefetchJob> job = takePrefetchJob(blob->url(), true);
+    if (!job || !job->ok || job->type != QQmlDataBlob::QmlFile
+            || job->urlString != blob->finalUrlString()
+            || job->sourceTimeStamp != data.sourceTimeStamp()) {
+        return false;
+    }
+
+    document->reset(job->document.take());
+    return true;
+}
+
+/*!
+Moves the script prefetched for \a blob into \a unit and returns true if it was
+compiled successfully from the same source as \a data.
+*/
+bool QQmlTypeLoader::takePrefetchedScript(
+        const QQmlDataBlob *blob, const QQmlDataBlob::SourceCodeData &data,
+        QV4::CompiledData::CompilationUnit *unit)
+{
+    const std::shared_ptr<PrefetchJob> job = takePrefetchJob(blob->url(), true);
+    if (!job || !job->ok || job->type != QQmlDataBlob::JavaScriptFile
+            || job->urlString != blob->finalUrlString()
+            || job->sourceTimeStamp != data.sourceTimeStamp()) {
+        return false;
+    }
+
+    *unit = std::move(job->unit);
+    return true;
+}
+
 void QQmlTypeLoader::shutdownThread()
 {
     if (m_thread && !m_thread->isShutdown())
@@ -901,6 +1110,30 @@ QQmlTypeLoader::QQmlTypeLoader(QQmlEngine *engine)
     , m_mutex(m_thread->mutex())
     , m_typeCacheTrimThreshold(TYPELOADER_MINIMUM_TRIM_THRESHOLD)
 {
+    bool ok = false;
+    int parseThreads = qEnvironmentVariableIntValue("QML_TYPELOADER_PARSE_THREADS", &ok);
+    if (!ok)
+        parseThreads = qBound(0, QThread::idealThreadCount() - 1, 4);
+    if (parseThreads > 0) {
+        m_parsePool = std::make_unique<QThreadPool>();
+        m_parsePool->setObjectName(QStringLiteral("QQmlTypeLoader parser"));
+        m_parsePool->setMaxThreadCount(parseThreads);
+    }
+
+    m_startupProfile = QQmlStartupProfile::fromEnvironment();
+}
+
+/*!
+Starts replaying the startup profile, if one was requested in the environment.
+This needs the engine's handle and is therefore called once the engine is set up.
+*/
+void QQmlTypeLoader::initializeStartupProfile()
+{
+    if (!m_startupProfile || m_startupProfile->mode() != QQmlStartupProfile::Replay)
+        return;
+
+    m_startupProfile->startReplay(engine()->handle()->diskCacheOptions()
+                                  & QV4::ExecutionEngine::DiskCache::QmlcRead);
 }
 
 /*!
@@ -912,6 +1145,9 @@ QQmlTypeLoader::~QQmlTypeLoader()
     // Stop the loader thread before releasing resources
     shutdownThread();
 
+    // Stops a replay and writes a recording, unless other type loaders share the profile
+    m_startupProfile.reset();
+
     clearCache();
 
     invalidate();
@@ -946,6 +1182,8 @@ QQmlRefPointer<QQmlTypeData> QQmlTypeLoader::getType(const QUrl &unNormalizedUrl
     QQmlTypeData *typeData = m_typeCache.value(url);
 
     if (!typeData) {
+        recordStartupProfile(QQmlStartupProfile::Document, url.toString());
+
         // Trim before adding the new type, so that we don't immediately trim it away
         if (m_typeCache.size() >= m_typeCacheTrimThreshold)
             trimCache();
@@ -964,6 +1202,10 @@ QQmlRefPointer<QQmlTypeData> QQmlTypeLoader::getType(const QUrl &unNormalizedUrl
             typeData->setCachedUnitStatus(error);
             QQmlTypeLoader::load(typeData, mode);
         }
+
+        // Drop what was prefetched if the load did not need it, e.g. on a disk cache hit
+        if (m_thread->isThisThread())
+            takePrefetchJob(url, false);
     } else if ((mode == PreferSynchronous || mode == Synchronous) && QQmlFile::isSynchronous(url)) {
         // this was started Asynchronous, but we need to force Synchronous
         // completion now (if at all possible with this type of URL).
@@ -1011,6 +1253,8 @@ QQmlRefPointer<QQmlScriptBlob> QQmlTypeLoader::getScript(const QUrl &unNormalize
     QQmlScriptBlob *scriptBlob = m_scriptCache.value(url);
 
     if (!scriptBlob) {
+        recordStartupProfile(QQmlStartupProfile::Script, url.toString());
+
         scriptBlob = new QQmlScriptBlob(url, this);
         m_scriptCache.insert(url, scriptBlob);
 
@@ -1024,6 +1268,9 @@ QQmlRefPointer<QQmlScriptBlob> QQmlTypeLoader::getScript(const QUrl &unNormalize
             scriptBlob->setCachedUnitStatus(error);
             QQmlTypeLoader::load(scriptBlob);
         }
+
+        if (m_thread->isThisThread())
+            takePrefetchJob(url, false);
     }
 
     return scriptBlob;
@@ -1253,6 +1500,7 @@ const QQmlTypeLoaderQmldirContent QQmlTypeLoader::qmldirContent(const QString &f
     if (val)
         return **val;
     QQmlTypeLoaderQmldirContent *qmldir = new QQmlTypeLoaderQmldirContent;
+    recordStartupProfile(QQmlStartupProfile::Qmldir, filePathIn);
 
 #define ERROR(description) { QQmlError e; e.setDescription(description); qmldir->setError(e); }
 #define NOT_READABLE_ERROR QString(QLatin1String("module \"$$URI$$\" definition \"%1\" not readable"))
@@ -1313,6 +1561,7 @@ void QQmlTypeLoader::clearCache()
     m_importDirCache.clear();
     m_importQmlDirCache.clear();
     m_checksumCache.clear();
+    clearPrefetchJobs();
     QQmlMetaType::freeUnusedTypesAndCaches();
 }
 
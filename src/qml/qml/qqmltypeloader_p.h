@@ -18,6 +18,7 @@
 #include <private/qqmldatablob_p.h>
 #include <private/qqmlimport_p.h>
 #include <private/qqmlmetatype_p.h>
+#include <private/qqmlstartupprofile_p.h>
 
 #include <QtQml/qtqmlglobal.h>
 #include <QtQml/qqmlerror.h>
@@ -25,6 +26,7 @@
 #include <QtCore/qcache.h>
 #include <QtCore/qmutex.h>
 
+#include <QtCore/qthreadpool.h>
 #include <memory>
 
 QT_BEGIN_NAMESPACE
@@ -38,6 +40,10 @@ class QQmlProfiler;
 class QQmlTypeLoaderThread;
 class QQmlEngine;
 
+namespace QmlIR {
+struct Document;
+}
+
 class Q_QML_PRIVATE_EXPORT QQmlTypeLoader
 {
     Q_DECLARE_TR_FUNCTIONS(QQmlTypeLoader)
@@ -154,6 +160,22 @@ public:
     void loadWithStaticData(QQmlDataBlob *, const QByteArray &, Mode = PreferSynchronous);
     void loadWithCachedUnit(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit, Mode mode = PreferSynchronous);
 
+    bool canPrefetch() const { return m_parsePool != nullptr; }
+    void prefetchType(const QUrl &unNormalizedUrl);
+    void prefetchScript(const QUrl &unNormalizedUrl);
+    bool takePrefetchedDocument(const QQmlDataBlob *blob, const QQmlDataBlob::SourceCodeData &data,
+                                QScopedPointer<QmlIR::Document> *document);
+    bool takePrefetchedScript(const QQmlDataBlob *blob, const QQmlDataBlob::SourceCodeData &data,
+                              QV4::CompiledData::CompilationUnit *unit);
+
+    void initializeStartupProfile();
+    void recordStartupProfile(QQmlStartupProfile::Kind kind, const QString &location)
+    {
+        if (m_startupProfile)
+            m_startupProfile->record(kind, location);
+    }
+    QQmlStartupProfile *startupProfile() const { return m_startupProfile.get(); }
+
     QQmlEngine *engine() const;
     void initializeEngine(QQmlEngineExtensionInterface *, const char *);
     void initializeEngine(QQmlExtensionInterface *, const char *);
@@ -192,6 +214,11 @@ private:
     void setData(const QQmlDataBlob::Ptr &, const QQmlDataBlob::SourceCodeData &);
     void setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPrivate::CachedQmlUnit *unit);
 
+    struct PrefetchJob;
+    void prefetch(const QUrl &url, QQmlDataBlob::Type type);
+    std::shared_ptr<PrefetchJob> takePrefetchJob(const QUrl &url, bool wait);
+    void clearPrefetchJobs();
+
     typedef QHash<QUrl, QQmlTypeData *> TypeCache;
     typedef QHash<QUrl, QQmlScriptBlob *> ScriptCache;
     typedef QHash<QUrl, QQmlQmldirData *> QmldirCache;
@@ -217,6 +244,13 @@ private:
     ImportQmlDirCache m_importQmlDirCache;
     ChecksumCache m_checksumCache;
 
+    // Parses QML documents and scripts ahead of the loader thread, see prefetchType()
+    std::unique_ptr<QThreadPool> m_parsePool;
+    QHash<QUrl, std::shared_ptr<PrefetchJob>> m_prefetchJobs;
+    QMutex m_prefetchMutex;
+
+    std::shared_ptr<QQmlStartupProfile> m_startupProfile;
+
     template<typename Loader>
     void doLoad(const Loader &loader, QQmlDataBlob *blob, Mode mode);
     void updateTypeCacheTrimThreshold();
@@ -87,7 +87,9 @@ enum SceneGraphFrameType {
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    GCMarkStep,  // Duration of an incremental GC step, in nanoseconds
+    GCSweepStep
 };
 
 enum ProfileFeature {
@@ -1173,7 +1173,8 @@ static QQmlRefPointer<QQmlContextData> initProxy(QQmlDelegateModelItem *cacheIte
     return ctxt;
 }
 
-QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, QQmlIncubator::IncubationMode incubationMode)
+QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, QQmlIncubator::IncubationMode incubationMode,
+                                          int incubationPriority)
 {
     if (!m_delegate || index < 0 || index >= m_compositor.count(group)) {
         qWarning() << "DelegateModel::item: index out range" << index << m_compositor.count(group);
@@ -1227,6 +1228,10 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, QQ
         if (sync && cacheItem->incubationTask->incubationMode() == QQmlIncubator::Asynchronous) {
             // previously requested async - now needed immediately
             cacheItem->incubationTask->forceCompletion();
+        } else {
+            // previously requested for the buffer - now needed sooner
+            QQmlIncubatorPrivate *incubator = QQmlIncubatorPrivate::get(cacheItem->incubationTask);
+            incubator->setPriority(qMax(incubator->priority, incubationPriority));
         }
     } else if (!cacheItem->object) {
         QQmlContext *creationContext = cacheItem->delegate->creationContext();
@@ -1235,6 +1240,7 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, QQ
 
         cacheItem->incubationTask = new QQDMIncubationTask(this, incubationMode);
         cacheItem->incubationTask->incubating = cacheItem;
+        QQmlIncubatorPrivate::get(cacheItem->incubationTask)->setPriority(incubationPriority);
         cacheItem->incubationTask->clear();
 
         for (int i = 1; i < m_groupCount; ++i)
@@ -1312,6 +1318,18 @@ QObject *QQmlDelegateModel::object(int index, QQmlIncubator::IncubationMode incu
     return d->object(d->m_compositorGroup, index, incubationMode);
 }
 
+QObject *QQmlDelegateModel::prioritizedObject(int index, QQmlIncubator::IncubationMode incubationMode,
+                                              int incubationPriority)
+{
+    Q_D(QQmlDelegateModel);
+    if (!d->m_delegate || index < 0 || index >= d->m_compositor.count(d->m_compositorGroup)) {
+        qWarning() << "DelegateModel::item: index out range" << index << d->m_compositor.count(d->m_compositorGroup);
+        return nullptr;
+    }
+
+    return d->object(d->m_compositorGroup, index, incubationMode, incubationPriority);
+}
+
 QQmlIncubator::Status QQmlDelegateModel::incubationStatus(int index)
 {
     Q_D(QQmlDelegateModel);
@@ -3653,6 +3671,12 @@ bool QQmlPartsModel::isValid() const
 }
 
 QObject *QQmlPartsModel::object(int index, QQmlIncubator::IncubationMode incubationMode)
+{
+    return prioritizedObject(index, incubationMode, QQmlIncubatorPrivate::NormalPriority);
+}
+
+QObject *QQmlPartsModel::prioritizedObject(int index, QQmlIncubator::IncubationMode incubationMode,
+                                           int incubationPriority)
 {
     QQmlDelegateModelPrivate *model = QQmlDelegateModelPrivate::get(m_model);
 
@@ -3661,7 +3685,7 @@ QObject *QQmlPartsModel::object(int index, QQmlIncubator::IncubationMode incubat
         return nullptr;
     }
 
-    QObject *object = model->object(m_compositorGroup, index, incubationMode);
+    QObject *object = model->object(m_compositorGroup, index, incubationMode, incubationPriority);
 
     if (QQuickPackage *package = qmlobject_cast<QQuickPackage *>(object)) {
         QObject *part = package->part(m_part);
@@ -77,6 +77,7 @@ public:
     int count() const override;
     bool isValid() const override { return delegate() != nullptr; }
     QObject *object(int index, QQmlIncubator::IncubationMode incubationMode = QQmlIncubator::AsynchronousIfNested) override;
+    QObject *prioritizedObject(int index, QQmlIncubator::IncubationMode incubationMode, int incubationPriority) override;
     ReleaseFlags release(QObject *object, ReusableFlag reusableFlag = NotReusable) override;
     void cancel(int index) override;
     QVariant variantValue(int index, const QString &role) override;
@@ -11,6 +11,7 @@
 #include <QtQml/qqmlincubator.h>
 
 #include <private/qqmladaptormodel_p.h>
+#include <private/qqmlincubator_p.h>
 #include <private/qqmlopenmetaobject_p.h>
 
 #include <QtCore/qloggingcategory.h>
@@ -260,7 +261,8 @@ public:
     void disconnectFromAbstractItemModel();
 
     void requestMoreIfNecessary();
-    QObject *object(Compositor::Group group, int index, QQmlIncubator::IncubationMode incubationMode);
+    QObject *object(Compositor::Group group, int index, QQmlIncubator::IncubationMode incubationMode,
+                    int incubationPriority = QQmlIncubatorPrivate::NormalPriority);
     QQmlDelegateModel::ReleaseFlags release(QObject *object, QQmlInstanceModel::ReusableFlag reusable = QQmlInstanceModel::NotReusable);
     QVariant variantValue(Compositor::Group group, int index, const QString &name);
     void emitCreatedPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
@@ -368,6 +370,7 @@ public:
     int count() const override;
     bool isValid() const override;
     QObject *object(int index, QQmlIncubator::IncubationMode incubationMode = QQmlIncubator::AsynchronousIfNested) override;
+    QObject *prioritizedObject(int index, QQmlIncubator::IncubationMode incubationMode, int incubationPriority) override;
     ReleaseFlags release(QObject *item, ReusableFlag reusable = NotReusable) override;
     QVariant variantValue(int index, const QString &role) override;
     QList<QByteArray> watchedRoles() const { return m_watchedRoles; }
@@ -48,6 +48,11 @@ public:
     virtual int count() const = 0;
     virtual bool isValid() const = 0;
     virtual QObject *object(int index, QQmlIncubator::IncubationMode incubationMode = QQmlIncubator::AsynchronousIfNested) = 0;
+    // Like object(), but an asynchronous incubation of the object gets the
+    // given QQmlIncubatorPrivate::Priority. Views request their cache buffer
+    // with a lower priority than the items they show.
+    virtual QObject *prioritizedObject(int index, QQmlIncubator::IncubationMode incubationMode, int incubationPriority)
+    { Q_UNUSED(incubationPriority); return object(index, incubationMode); }
     virtual ReleaseFlags release(QObject *object, ReusableFlag reusableFlag = NotReusable) = 0;
     virtual void cancel(int) {}
     QString stringValue(int index, const QString &role) { return variantValue(index, role).toString(); }
@@ -0,0 +1,296 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qquickframetimings_p.h"
+#include "qquickwindow.h"
+#include "qquickwindow_p.h"
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qmetaobject.h>
+#include <QtQml/qqmlengine.h>
+#include <QtQml/private/qv4engine_p.h>
+#include <QtQml/private/qv4mm_p.h>
+
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype FrameTimings
+    \instantiates QQuickFrameTimings
+    \inqmlmodule QtQuick
+    \ingroup qtquick-visual-utility
+    \since 6.6
+    \brief Provides the durations of the phases of recently rendered frames.
+
+    FrameTimings keeps the durations of the phases of the last 256 frames a
+    window has rendered, and histograms of the durations of all frames since
+    the timings were enabled or reset. It is available through the
+    \l{Window::frameTimings}{Window.frameTimings} attached property.
+
+    Collecting the timings is disabled by default. It can be enabled by
+    setting \l enabled, or for all windows by setting the environment
+    variable \c QSG_FRAME_TIMINGS to \c 1. While enabled, the cost is a few
+    clock reads and one lock per phase of each frame, so the timings can be
+    collected in production, unlike the \c{qt.scenegraph.time} logging
+    categories.
+
+    \qml
+    Timer {
+        interval: 10000
+        repeat: true
+        running: true
+        onTriggered: {
+            const timings = Window.frameTimings
+            console.log("99th percentile frame interval:",
+                        timings.percentile(FrameTimings.FrameInterval, 99), "ms")
+            timings.reset()
+        }
+        Component.onCompleted: Window.frameTimings.enabled = true
+    }
+    \endqml
+
+    Frames are recorded by the \c basic and \c threaded render loops. Windows
+    rendered through QQuickRenderControl, or with the software adaptation,
+    do not record frames.
+*/
+
+/*!
+    \qmlproperty bool QtQuick::FrameTimings::enabled
+
+    Whether the durations of the phases of each frame are measured. Enabling
+    the timings clears the timings of earlier frames.
+*/
+
+/*!
+    \qmlproperty int QtQuick::FrameTimings::capacity
+
+    The number of recent frames that are kept, and returned by
+    recentFrames().
+*/
+
+QQuickFrameTimings::QQuickFrameTimings(QQuickWindow *window)
+    : m_window(window)
+{
+    resetLocked();
+    if (qEnvironmentVariableIntValue("QSG_FRAME_TIMINGS"))
+        setEnabled(true);
+}
+
+void QQuickFrameTimings::setEnabled(bool enabled)
+{
+    if (enabled == isEnabled())
+        return;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        resetLocked();
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    emit enabledChanged();
+}
+
+void QQuickFrameTimings::resetLocked()
+{
+    m_clock.start();
+    m_lastFrameTime = -1;
+    m_lastGCTime = -1;
+    m_frameNumber = 0;
+    m_pending = Frame();
+    m_frames.fill(Frame());
+    for (auto &histogram : m_histograms)
+        histogram.fill(0);
+    m_sampleCounts.fill(0);
+}
+
+/*!
+    \qmlmethod void QtQuick::FrameTimings::reset()
+
+    Clears the recent frames and the histograms.
+*/
+void QQuickFrameTimings::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    resetLocked();
+}
+
+/*!
+    \qmlmethod int QtQuick::FrameTimings::frameCount()
+
+    Returns the number of frames recorded since the timings were enabled or
+    reset.
+*/
+int QQuickFrameTimings::frameCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(qMin(m_frameNumber, quint64(std::numeric_limits<int>::max())));
+}
+
+/*!
+    Returns the recorded frames, oldest first. At most capacity() frames are
+    kept.
+*/
+QList<QQuickFrameTimings::Frame> QQuickFrameTimings::frames() const
+{
+    QMutexLocker locker(&m_mutex);
+    const quint64 count = qMin(m_frameNumber, quint64(Capacity));
+    QList<Frame> result;
+    result.reserve(count);
+    for (quint64 number = m_frameNumber - count; number < m_frameNumber; ++number)
+        result.append(m_frames[number % Capacity]);
+    return result;
+}
+
+/*!
+    \qmlmethod list<object> QtQuick::FrameTimings::recentFrames()
+
+    Returns the recorded frames, oldest first, as objects with the
+    properties \c number, \c timestamp, and one property per phase, named
+    like the phases in lower camel case. The timestamp and the durations
+    are in milliseconds.
+*/
+QVariantList QQuickFrameTimings::recentFrames() const
+{
+    static const QMetaEnum phases = QMetaEnum::fromType<Phase>();
+
+    QVariantList result;
+    const QList<Frame> recorded = frames();
+    result.reserve(recorded.size());
+    for (const Frame &frame : recorded) {
+        QVariantMap map;
+        map.insert(QStringLiteral("number"), frame.number);
+        map.insert(QStringLiteral("timestamp"), frame.timestamp / 1000000.0);
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            QString name = QString::fromLatin1(phases.valueToKey(phase));
+            name[0] = name.at(0).toLower();
+            map.insert(name, frame.durations[phase] / 1000000.0);
+        }
+        result.append(map);
+    }
+    return result;
+}
+
+int QQuickFrameTimings::bucketForDuration(qint64 usecs)
+{
+    if (usecs < SubBucketCount)
+        return int(qMax(usecs, qint64(0)));
+
+    const int exponent = qMin(63 - qCountLeadingZeroBits(quint64(usecs)), MaxExponent + 1);
+    if (exponent > MaxExponent)
+        return BucketCount - 1;
+    const int subBucket = int(usecs >> (exponent - SubBucketBits)) - SubBucketCount;
+    return SubBucketCount * (exponent - SubBucketBits + 1) + subBucket;
+}
+
+qint64 QQuickFrameTimings::bucketUpperBound(int bucket)
+{
+    if (bucket < SubBucketCount)
+        return bucket;
+
+    const int exponent = bucket / SubBucketCount + SubBucketBits - 1;
+    const int subBucket = bucket % SubBucketCount;
+    return (qint64(SubBucketCount + subBucket + 1) << (exponent - SubBucketBits)) - 1;
+}
+
+/*!
+    \qmlmethod real QtQuick::FrameTimings::percentile(enumeration phase, real percent)
+
+    Returns the duration of \a phase, in milliseconds, that the given share
+    of the frames recorded since the timings were enabled or reset did not
+    exceed. \a percent ranges from 0 to 100. The durations are kept in histograms with a resolution
+    of one microsecond below 8 microseconds, and of an eighth of the
+    duration above. The upper bound of the matching histogram bucket is
+    returned. Returns 0 if no frames were recorded.
+
+    \value FrameTimings.FrameInterval The time since the previous frame was completed.
+    \value FrameTimings.Animations Advancing the animations. Only measured by
+           the \c threaded render loop. The \c basic render loop advances the
+           animations on a timer, independently of the frames, and always
+           records 0.
+    \value FrameTimings.Polish Polishing the items.
+    \value FrameTimings.Sync Synchronizing the items with the scene graph.
+    \value FrameTimings.RenderPrepare Preparing the scene graph for rendering,
+           including the upload of vertex data.
+    \value FrameTimings.RenderRecord Recording the rendering commands.
+    \value FrameTimings.Present Submitting the frame and presenting it, which
+           typically includes waiting for vertical sync.
+    \value FrameTimings.GarbageCollection The time the JavaScript garbage
+           collector ran on the GUI thread since the previous frame.
+*/
+qreal QQuickFrameTimings::percentile(QQuickFrameTimings::Phase phase, qreal percent) const
+{
+    if (phase < 0 || phase >= PhaseCount)
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+    const quint32 count = m_sampleCounts[phase];
+    if (count == 0)
+        return 0;
+
+    const quint64 rank = qMax(quint64(1), quint64(std::ceil(qBound(0.0, percent, 100.0) / 100 * count)));
+    const std::array<quint32, BucketCount> &histogram = m_histograms[phase];
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += histogram[bucket];
+        if (seen >= rank)
+            return bucketUpperBound(bucket) / 1000.0;
+    }
+    return bucketUpperBound(BucketCount - 1) / 1000.0;
+}
+
+void QQuickFrameTimings::addPhaseTime(Phase phase, qint64 nsecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pending.durations[phase] += nsecs;
+}
+
+/*
+    Adds the phases of the GUI thread, and the time the garbage collector of
+    the window's engine ran since the previous call.
+*/
+void QQuickFrameTimings::recordGuiThreadPhases(qint64 polishNsecs, qint64 animationsNsecs)
+{
+    qint64 gcTime = -1;
+    if (QQmlEngine *engine = m_window ? QQuickWindowPrivate::get(m_window)->windowEngine() : nullptr)
+        gcTime = engine->handle()->memoryManager->gcTime();
+
+    QMutexLocker locker(&m_mutex);
+    m_pending.durations[Polish] += polishNsecs;
+    m_pending.durations[Animations] += animationsNsecs;
+    if (gcTime >= 0) {
+        if (m_lastGCTime >= 0)
+            m_pending.durations[GarbageCollection] += gcTime - m_lastGCTime;
+        m_lastGCTime = gcTime;
+    }
+}
+
+/*
+    Completes the frame with the phases added since the previous call, and
+    adds it to the recent frames and the histograms.
+*/
+void QQuickFrameTimings::commitFrame()
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 now = m_clock.nsecsElapsed();
+    Frame frame = m_pending;
+    m_pending = Frame();
+    frame.number = m_frameNumber++;
+    frame.timestamp = now;
+    if (m_lastFrameTime >= 0)
+        frame.durations[FrameInterval] = now - m_lastFrameTime;
+    m_lastFrameTime = now;
+    m_frames[frame.number % Capacity] = frame;
+
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        // The first frame has no interval
+        if (phase == FrameInterval && frame.number == 0)
+            continue;
+        ++m_histograms[phase][bucketForDuration(frame.durations[phase] / 1000)];
+        ++m_sampleCounts[phase];
+    }
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qquickframetimings_p.cpp"
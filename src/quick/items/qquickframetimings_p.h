@@ -0,0 +1,114 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQUICKFRAMETIMINGS_P_H
+#define QQUICKFRAMETIMINGS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/private/qtquickglobal_p.h>
+#include <QtQml/qqml.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qvariant.h>
+
+#include <array>
+#include <atomic>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickWindow;
+
+class Q_QUICK_PRIVATE_EXPORT QQuickFrameTimings : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged FINAL)
+    Q_PROPERTY(int capacity READ capacity CONSTANT FINAL)
+    QML_NAMED_ELEMENT(FrameTimings)
+    QML_UNCREATABLE("FrameTimings is only available through the Window.frameTimings attached property.")
+    QML_ADDED_IN_VERSION(6, 6)
+
+public:
+    enum Phase {
+        FrameInterval,
+        Animations,
+        Polish,
+        Sync,
+        RenderPrepare,
+        RenderRecord,
+        Present,
+        GarbageCollection
+    };
+    Q_ENUM(Phase)
+    static constexpr int PhaseCount = GarbageCollection + 1;
+
+    struct Frame
+    {
+        quint64 number = 0;
+        qint64 timestamp = 0; // nanoseconds since the timings were enabled
+        std::array<qint64, PhaseCount> durations = {}; // nanoseconds, indexed by Phase
+    };
+
+    explicit QQuickFrameTimings(QQuickWindow *window);
+
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+    int capacity() const { return Capacity; }
+
+    QList<Frame> frames() const;
+    Q_INVOKABLE int frameCount() const;
+    Q_INVOKABLE qreal percentile(QQuickFrameTimings::Phase phase, qreal percent) const;
+    Q_INVOKABLE QVariantList recentFrames() const;
+    Q_INVOKABLE void reset();
+
+    // Called by the render loops while enabled
+    void addPhaseTime(Phase phase, qint64 nsecs);
+    void recordGuiThreadPhases(qint64 polishNsecs, qint64 animationsNsecs);
+    void commitFrame();
+
+Q_SIGNALS:
+    void enabledChanged();
+
+private:
+    static constexpr int Capacity = 256;
+
+    // Durations in microseconds below 2^SubBucketBits have exact buckets. Larger
+    // ones share a bucket with the durations within 1/2^SubBucketBits of them.
+    static constexpr int SubBucketBits = 3;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int MaxExponent = 26; // about a minute
+    static constexpr int BucketCount = SubBucketCount * (MaxExponent - SubBucketBits + 2);
+
+    static int bucketForDuration(qint64 usecs);
+    static qint64 bucketUpperBound(int bucket);
+
+    void resetLocked();
+
+    QQuickWindow *m_window;
+    std::atomic<bool> m_enabled = false;
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameTime = -1;
+    qint64 m_lastGCTime = -1;
+    quint64 m_frameNumber = 0;
+    Frame m_pending;
+    std::array<Frame, Capacity> m_frames;
+    std::array<std::array<quint32, BucketCount>, PhaseCount> m_histograms;
+    std::array<quint32, PhaseCount> m_sampleCounts;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKFRAMETIMINGS_P_H
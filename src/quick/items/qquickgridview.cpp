@@ -500,10 +500,13 @@ bool QQuickGridViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
     bool changed = false;
 
     QQmlIncubator::IncubationMode incubationMode = doBuffer ? QQmlIncubator::Asynchronous : QQmlIncubator::AsynchronousIfNested;
+    // The buffer yields to the delegates that are shown
+    const int incubationPriority = doBuffer ? QQmlIncubatorPrivate::SpeculativePriority
+                                            : QQmlIncubatorPrivate::NormalPriority;
 
     while (modelIndex < model->count() && rowPos <= fillTo + rowSize()*(columns - colNum)/(columns+1)) {
         qCDebug(lcItemViewDelegateLifecycle) << "refill: append item" << modelIndex << colPos << rowPos;
-        if (!(item = static_cast<FxGridItemSG*>(createItem(modelIndex, incubationMode))))
+        if (!(item = static_cast<FxGridItemSG*>(createItem(modelIndex, incubationMode, incubationPriority))))
             break;
 #if QT_CONFIG(quick_viewtransitions)
         if (!transitioner || !transitioner->canTransition(QQuickItemViewTransitioner::PopulateTransition, true)) // pos will be set by layoutVisibleItems()
@@ -539,7 +542,7 @@ bool QQuickGridViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
     colPos = colNum * colSize();
     while (visibleIndex > 0 && rowPos + rowSize() - 1 >= fillFrom - rowSize()*(colNum+1)/(columns+1)){
         qCDebug(lcItemViewDelegateLifecycle) << "refill: prepend item" << visibleIndex-1 << "top pos" << rowPos << colPos;
-        if (!(item = static_cast<FxGridItemSG*>(createItem(visibleIndex-1, incubationMode))))
+        if (!(item = static_cast<FxGridItemSG*>(createItem(visibleIndex-1, incubationMode, incubationPriority))))
             break;
         --visibleIndex;
 #if QT_CONFIG(quick_viewtransitions)
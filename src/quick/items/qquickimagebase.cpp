@@ -3,6 +3,9 @@
 
 #include "qquickimagebase_p.h"
 #include "qquickimagebase_p_p.h"
+#include "qquickwindow_p.h"
+
+#include <QtQuick/private/qsgrenderloop_p.h>
 
 #include <QtGui/qguiapplication.h>
 #include <QtGui/qscreen.h>
@@ -390,6 +393,14 @@ void QQuickImageBase::requestFinished()
         emit colorSpaceChanged();
     }
 
+    // Lets the render loop upload the texture before the sync needs it
+    if (d->status == Ready && window()) {
+        QSGRenderLoop *renderLoop = QQuickWindowPrivate::get(window())->windowManager;
+        QQuickTextureFactory *factory = d->pix.textureFactory();
+        if (renderLoop && factory)
+            renderLoop->preuploadTexture(window(), factory);
+    }
+
     update();
 }
 
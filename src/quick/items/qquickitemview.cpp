@@ -2343,7 +2343,8 @@ void QQuickItemViewPrivate::viewItemTransitionFinished(QQuickItemViewTransitiona
   When the item becomes available, refill() will be called and the item
   will be returned on the next call to createItem().
 */
-FxViewItem *QQuickItemViewPrivate::createItem(int modelIndex, QQmlIncubator::IncubationMode incubationMode)
+FxViewItem *QQuickItemViewPrivate::createItem(int modelIndex, QQmlIncubator::IncubationMode incubationMode,
+                                              int incubationPriority)
 {
     Q_Q(QQuickItemView);
 
@@ -2364,7 +2365,9 @@ FxViewItem *QQuickItemViewPrivate::createItem(int modelIndex, QQmlIncubator::Inc
 
     // The model will run this same range check internally but produce a warning and return nullptr.
     // Since we handle this result graciously in our code, we preempt this warning by checking the range ourselves.
-    QObject* object = modelIndex < model->count() ? model->object(modelIndex, incubationMode) : nullptr;
+    QObject* object = modelIndex < model->count()
+            ? model->prioritizedObject(modelIndex, incubationMode, incubationPriority)
+            : nullptr;
     QQuickItem *item = qmlobject_cast<QQuickItem*>(object);
 
     if (!item) {
@@ -28,6 +28,7 @@ QT_REQUIRE_CONFIG(quick_itemview);
 #include <QtQmlModels/private/qqmlobjectmodel_p.h>
 #include <QtQmlModels/private/qqmldelegatemodel_p.h>
 #include <QtQmlModels/private/qqmlchangeset_p.h>
+#include <QtQml/private/qqmlincubator_p.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -144,7 +145,8 @@ public:
     void refill(qreal from, qreal to);
     void mirrorChange() override;
 
-    FxViewItem *createItem(int modelIndex,QQmlIncubator::IncubationMode incubationMode = QQmlIncubator::AsynchronousIfNested);
+    FxViewItem *createItem(int modelIndex,QQmlIncubator::IncubationMode incubationMode = QQmlIncubator::AsynchronousIfNested,
+                           int incubationPriority = QQmlIncubatorPrivate::NormalPriority);
     virtual bool releaseItem(FxViewItem *item, QQmlInstanceModel::ReusableFlag reusableFlag);
 
     QQuickItem *createHighlightItem() const;
@@ -750,12 +750,15 @@ bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
     }
 
     QQmlIncubator::IncubationMode incubationMode = doBuffer ? QQmlIncubator::Asynchronous : QQmlIncubator::AsynchronousIfNested;
+    // The buffer yields to the delegates that are shown
+    const int incubationPriority = doBuffer ? QQmlIncubatorPrivate::SpeculativePriority
+                                            : QQmlIncubatorPrivate::NormalPriority;
 
     bool changed = false;
     FxListItemSG *item = nullptr;
     qreal pos = itemEnd;
     while (modelIndex < model->count() && pos <= fillTo) {
-        if (!(item = static_cast<FxListItemSG*>(createItem(modelIndex, incubationMode))))
+        if (!(item = static_cast<FxListItemSG*>(createItem(modelIndex, incubationMode, incubationPriority))))
             break;
         qCDebug(lcItemViewDelegateLifecycle) << "refill: append item" << modelIndex << "pos" << pos << "buffer" << doBuffer << "item" << (QObject *)(item->item);
 #if QT_CONFIG(quick_viewtransitions)
@@ -774,7 +777,7 @@ bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
         return changed;
 
     while (visibleIndex > 0 && visibleIndex <= model->count() && visiblePos > fillFrom) {
-        if (!(item = static_cast<FxListItemSG*>(createItem(visibleIndex-1, incubationMode))))
+        if (!(item = static_cast<FxListItemSG*>(createItem(visibleIndex-1, incubationMode, incubationPriority))))
             break;
         qCDebug(lcItemViewDelegateLifecycle) << "refill: prepend item" << visibleIndex-1 << "current top pos" << visiblePos << "buffer" << doBuffer << "item" << (QObject *)(item->item);
         --visibleIndex;
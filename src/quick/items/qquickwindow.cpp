@@ -30,10 +30,12 @@
 #include <QtGui/private/qpointingdevice_p.h>
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qabstractanimation.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/QLibraryInfo>
 #include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
 #include <QtQml/qqmlinfo.h>
+#include <QtQml/private/qqmlengine_p.h>
 #include <QtQml/private/qqmlmetatype_p.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -74,11 +76,12 @@ class QQuickWindowIncubationController : public QObject, public QQmlIncubationCo
 
 public:
     QQuickWindowIncubationController(QSGRenderLoop *loop)
-        : m_renderLoop(loop), m_timer(0)
+        : m_renderLoop(loop), m_timer(0),
+          // Allow incubation for 1/3 of a frame.
+          m_incubation_time(qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3)),
+          m_budget(qint64(1000000000 / QGuiApplication::primaryScreen()->refreshRate()),
+                   m_incubation_time)
     {
-        // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
-
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
             connect(animationDriver, SIGNAL(stopped()), this, SLOT(animationStopped()));
@@ -102,11 +105,22 @@ protected:
         }
     }
 
+    int frameBudget()
+    {
+        const qint64 guiFrameTime = m_renderLoop->lastGuiFrameTime();
+        const qint64 sinceLastFrame = m_last_frame.isValid() ? m_last_frame.nsecsElapsed() : -1;
+        if (guiFrameTime < 0)
+            m_last_frame.invalidate();
+        else
+            m_last_frame.start();
+        return m_budget.frameBudget(guiFrameTime, sinceLastFrame);
+    }
+
 public slots:
     void incubate() {
         if (m_renderLoop && incubatingObjectCount()) {
             if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+                incubateFor(frameBudget());
             } else {
                 incubateFor(m_incubation_time * 2);
                 if (incubatingObjectCount())
@@ -126,10 +140,39 @@ protected:
 
 private:
     QPointer<QSGRenderLoop> m_renderLoop;
-    int m_incubation_time;
     int m_timer;
+    int m_incubation_time;
+    QQuickIncubationBudget m_budget;
+    QElapsedTimer m_last_frame;
 };
 
+/*
+    Returns the time in milliseconds that is left for incubation before the
+    GUI thread is needed for the next frame. That is the frame interval, less
+    \a guiFrameTime, the time the GUI thread spent on the current frame, and a
+    margin. The budget is halved whenever a frame was late, as told by
+    \a sinceLastFrame, and recovers gradually. Without a measurement of the
+    current frame, the fallback budget is returned.
+
+    All times are in nanoseconds, and negative if they were not measured.
+*/
+int QQuickIncubationBudget::frameBudget(qint64 guiFrameTime, qint64 sinceLastFrame)
+{
+    if (guiFrameTime < 0)
+        return m_fallback;
+
+    if (sinceLastFrame >= 0) {
+        // Longer gaps are pauses in rendering rather than late frames
+        if (sinceLastFrame > m_frameInterval * 3 / 2 && sinceLastFrame < m_frameInterval * 4)
+            m_scale = qMax(qreal(0.125), m_scale / 2);
+        else
+            m_scale = qMin(qreal(1), m_scale + qreal(0.125));
+    }
+
+    const qint64 available = m_frameInterval - m_frameInterval / 4 - guiFrameTime;
+    return qMax(1, int(available * m_scale / 1000000));
+}
+
 #if QT_CONFIG(accessibility)
 /*!
     Returns an accessibility interface for this window, or 0 if such an
@@ -324,8 +367,33 @@ struct PolishLoopDetector
     int numPolishLoopsInSequence = 0;
 };
 
+/*
+    Returns the engine of the window, or of the first of its top-level items
+    that has one. Windows created from C++, such as QQuickView, have no
+    engine of their own.
+*/
+QQmlEngine *QQuickWindowPrivate::windowEngine() const
+{
+    Q_Q(const QQuickWindow);
+    if (QQmlEngine *engine = qmlEngine(q))
+        return engine;
+    const auto items = contentItem->childItems();
+    for (QQuickItem *item : items) {
+        if (QQmlEngine *engine = qmlEngine(item))
+            return engine;
+    }
+    return nullptr;
+}
+
 void QQuickWindowPrivate::polishItems()
 {
+    // Bindings whose updates are coalesced are updated before polishing, as
+    // they may move, resize and schedule more items for polishing.
+    if (QQmlEnginePrivate::coalescingEngines.loadRelaxed() != 0) {
+        if (QQmlEngine *engine = windowEngine())
+            QQmlEnginePrivate::get(engine)->flushBindingUpdates();
+    }
+
     // An item can trigger polish on another item, or itself for that matter,
     // during its updatePolish() call. Because of this, we cannot simply
     // iterate through the set, we must continue pulling items out until it
@@ -656,7 +724,13 @@ void QQuickWindowPrivate::renderSceneGraph()
     renderer->setViewportRect(QRect(QPoint(0, 0), pixelSize));
     renderer->setProjectionMatrixToRect(QRectF(QPointF(0, 0), pixelSize / devicePixelRatio), matrixFlags);
 
+    const bool recordFrameTimings = frameTimings->isEnabled();
+    renderer->setRecordPassTimes(recordFrameTimings);
     context->renderNextFrame(renderer);
+    if (recordFrameTimings) {
+        frameTimings->addPhaseTime(QQuickFrameTimings::RenderPrepare, renderer->lastPrepareTime());
+        frameTimings->addPhaseTime(QQuickFrameTimings::RenderRecord, renderer->lastRecordTime());
+    }
 
     emit q->afterRendering();
     runAndClearJobs(&afterRenderingJobs);
@@ -728,6 +802,7 @@ void QQuickWindowPrivate::init(QQuickWindow *c, QQuickRenderControl *control)
     contentItemPrivate->flags |= QQuickItem::ItemIsFocusScope;
     contentItem->setSize(q->size());
     deliveryAgent = new QQuickDeliveryAgent(contentItem);
+    frameTimings.reset(new QQuickFrameTimings(q));
 
     visualizationMode = qgetenv("QSG_VISUALIZE");
     renderControl = control;
@@ -2586,6 +2661,10 @@ QImage QQuickWindow::grabWindow()
     for this window. QQuickView automatically installs this controller for you,
     otherwise you will need to install it yourself using \l{QQmlEngine::setIncubationController()}.
 
+    With the threaded render loop, the controller incubates in the part of
+    each frame that the GUI thread does not need, as measured on the previous
+    frames, and incubates less after frames that were late.
+
     The controller is owned by the window and will be destroyed when the window
     is deleted.
 */
@@ -3316,6 +3395,18 @@ void QQuickWindow::endExternalCommands()
     The Window attached property can be attached to any Item.
 */
 
+/*!
+    \qmlattachedproperty FrameTimings Window::frameTimings
+    \since 6.6
+
+    This attached property holds the durations of the phases of the frames
+    recently rendered by the item's window, or \c null if the item is not in
+    a window.
+    The Window attached property can be attached to any Item.
+
+    \sa FrameTimings
+*/
+
 /*!
     \qmlattachedproperty int Window::width
     \qmlattachedproperty int Window::height
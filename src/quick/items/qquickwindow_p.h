@@ -22,6 +22,7 @@
 #include <QtQuick/private/qquickrendertarget_p.h>
 #include <QtQuick/private/qquickgraphicsdevice_p.h>
 #include <QtQuick/private/qquickgraphicsconfiguration_p.h>
+#include <QtQuick/private/qquickframetimings_p.h>
 #include <QtQuick/qquickitem.h>
 #include <QtQuick/qquickwindow.h>
 
@@ -45,6 +46,7 @@ class QQuickAnimatorController;
 class QQuickDragGrabber;
 class QQuickItemPrivate;
 class QPointingDevice;
+class QQmlEngine;
 class QQuickRenderControl;
 class QQuickWindowIncubationController;
 class QQuickWindowPrivate;
@@ -83,6 +85,27 @@ public:
     bool owns = false;
 };
 
+/*
+    Decides how long the incubation controller of a window may incubate after
+    a frame of the threaded render loop.
+*/
+class Q_QUICK_PRIVATE_EXPORT QQuickIncubationBudget
+{
+public:
+    QQuickIncubationBudget(qint64 frameInterval, int fallback)
+        : m_frameInterval(frameInterval), m_fallback(fallback) {}
+
+    int frameBudget(qint64 guiFrameTime, qint64 sinceLastFrame);
+
+    qint64 frameInterval() const { return m_frameInterval; }
+    qreal scale() const { return m_scale; }
+
+private:
+    qint64 m_frameInterval; // nanoseconds
+    int m_fallback; // milliseconds
+    qreal m_scale = 1;
+};
+
 class Q_QUICK_PRIVATE_EXPORT QQuickWindowPrivate
     : public QWindowPrivate
     , public QQuickPaletteProviderPrivateBase<QQuickWindow, QQuickWindowPrivate>
@@ -130,6 +153,8 @@ public:
     void ensureCustomRenderTarget();
     void setCustomCommandBuffer(QRhiCommandBuffer *cb);
 
+    QQmlEngine *windowEngine() const;
+
     void polishItems();
     void forcePolish();
     void invalidateFontData(QQuickItem *item);
@@ -186,6 +211,7 @@ public:
     QSGRenderLoop *windowManager;
     QQuickRenderControl *renderControl;
     QScopedPointer<QQuickAnimatorController> animationController;
+    QScopedPointer<QQuickFrameTimings> frameTimings;
 
     QColor clearColor;
 
@@ -21,6 +21,7 @@
 
 QT_BEGIN_NAMESPACE
 
+class QQuickFrameTimings;
 class QQuickItem;
 class QQuickWindow;
 
@@ -35,6 +36,7 @@ class Q_QUICK_PRIVATE_EXPORT QQuickWindowAttached : public QObject
     Q_PROPERTY(int width READ width NOTIFY widthChanged)
     Q_PROPERTY(int height READ height NOTIFY heightChanged)
     Q_PROPERTY(QQuickWindow *window READ window NOTIFY windowChanged)
+    Q_PROPERTY(QQuickFrameTimings *frameTimings READ frameTimings NOTIFY windowChanged REVISION(6, 6))
     QML_ANONYMOUS
     QML_ADDED_IN_VERSION(2, 0)
 
@@ -48,6 +50,7 @@ public:
     int width() const;
     int height() const;
     QQuickWindow *window() const;
+    QQuickFrameTimings *frameTimings() const;
 
 Q_SIGNALS:
 
@@ -9,6 +9,9 @@
 #include "qsgsoftwarerenderablenode_p.h"
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
 #include <QtGui/QWindow>
 #include <QtQuick/QSGSimpleRectNode>
 
@@ -24,6 +27,19 @@ QSGAbstractSoftwareRenderer::QSGAbstractSoftwareRenderer(QSGRenderContext *conte
     // Setup special background node
     auto backgroundRenderable = new QSGSoftwareRenderableNode(QSGSoftwareRenderableNode::SimpleRect, m_background);
     addNodeMapping(m_background, backgroundRenderable);
+
+    const int renderThreads = qEnvironmentVariableIntValue("QSG_SOFTWARE_RENDER_THREADS");
+    if (renderThreads > 1) {
+        m_tilePool.reset(new QThreadPool);
+        m_tilePool->setObjectName(QStringLiteral("QSGSoftwareRenderer tiles"));
+        m_tilePool->setMaxThreadCount(renderThreads);
+
+        bool ok = false;
+        const int tileSize = qEnvironmentVariableIntValue("QSG_SOFTWARE_RENDER_TILE_SIZE", &ok);
+        if (ok && tileSize > 0)
+            m_tileSize = tileSize;
+        qCDebug(lc2DRender) << "Rendering tiles of" << m_tileSize << "pixels on" << renderThreads << "threads";
+    }
 }
 
 QSGAbstractSoftwareRenderer::~QSGAbstractSoftwareRenderer()
@@ -107,6 +123,91 @@ QRegion QSGAbstractSoftwareRenderer::renderNodes(QPainter *painter)
     return dirtyRegion;
 }
 
+// Tiled rendering paints the update region in tiles on a thread pool, each tile
+// through its own QImage sharing the memory of the target image. This requires
+// whole device pixels per logical pixel, and render nodes, which paint through
+// the render context's active painter, force the single threaded path.
+bool QSGAbstractSoftwareRenderer::canRenderTiled(QPaintDevice *device, const QRegion &updateRegion) const
+{
+    if (!m_tilePool || device->devType() != QInternal::Image)
+        return false;
+
+    const QImage *image = static_cast<const QImage *>(device);
+    const qreal dpr = image->devicePixelRatio();
+    if (image->depth() < 8 || !qFuzzyCompare(dpr, qreal(qRound(dpr))))
+        return false;
+
+    // Not worth the overhead for a single tile
+    const QRect bounds = updateRegion.boundingRect();
+    if (bounds.width() <= m_tileSize && bounds.height() <= m_tileSize)
+        return false;
+
+    for (const QSGSoftwareRenderableNode *node : m_renderableNodes) {
+        if (node->type() == QSGSoftwareRenderableNode::RenderNode)
+            return false;
+    }
+    return true;
+}
+
+QRegion QSGAbstractSoftwareRenderer::renderNodesTiled(QImage *image, const QRegion &updateRegion)
+{
+    QRegion dirtyRegion;
+    // If there are no nodes, do nothing
+    if (m_renderableNodes.isEmpty())
+        return dirtyRegion;
+
+    const QRect imageRect(QPoint(0, 0), image->deviceIndependentSize().toSize());
+    const QRect bounds = updateRegion.boundingRect() & imageRect;
+    // Detach here, not in the worker threads
+    uchar *bits = image->bits();
+
+    for (int y = bounds.top(); y <= bounds.bottom(); y += m_tileSize) {
+        for (int x = bounds.left(); x <= bounds.right(); x += m_tileSize) {
+            const QRect tile = QRect(x, y, m_tileSize, m_tileSize) & bounds;
+            if (updateRegion.intersects(tile))
+                m_tilePool->start([this, bits, image, tile]() { renderTile(bits, *image, tile); });
+        }
+    }
+    m_tilePool->waitForDone();
+
+    for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes))
+        dirtyRegion += node->markPainted();
+
+    return dirtyRegion;
+}
+
+void QSGAbstractSoftwareRenderer::renderTile(uchar *bits, const QImage &image, const QRect &tile)
+{
+    const int dpr = qRound(image.devicePixelRatio());
+    const QRect deviceTile(tile.topLeft() * dpr, tile.size() * dpr);
+    QImage tileImage(bits + deviceTile.y() * image.bytesPerLine() + deviceTile.x() * (image.depth() / 8),
+                     deviceTile.width(), deviceTile.height(), image.bytesPerLine(), image.format());
+    tileImage.setDevicePixelRatio(dpr);
+
+    QPainter painter(&tileImage);
+    painter.setRenderHint(QPainter::Antialiasing);
+    // The nodes replace the world transform, so the tile offset goes into the window
+    painter.setWindow(tile);
+    painter.setViewport(QRect(QPoint(0, 0), tile.size()));
+
+    for (int i = 0; i < m_renderableNodes.size(); ++i) {
+        const QSGSoftwareRenderableNode *node = m_renderableNodes.at(i);
+        if (!node->needsPainting() || !node->dirtyRegion().intersects(tile))
+            continue;
+
+        // These update cached pixmaps while painting, or use the glyph caches of
+        // font engines shared with other nodes.
+        const QSGSoftwareRenderableNode::NodeType type = node->type();
+        const bool sharesState = type == QSGSoftwareRenderableNode::Rectangle
+                || type == QSGSoftwareRenderableNode::Glyph
+                || type == QSGSoftwareRenderableNode::SimpleImage;
+        QMutexLocker locker(sharesState ? &m_sharedPaintMutex : nullptr);
+
+        // First node is the background and needs to painted without blending
+        node->paint(&painter, /*force opaque painting*/ i == 0);
+    }
+}
+
 void QSGAbstractSoftwareRenderer::buildRenderList()
 {
     // Clear the previous renderlist
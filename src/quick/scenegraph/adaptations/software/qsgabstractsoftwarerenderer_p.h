@@ -18,10 +18,16 @@
 #include <private/qsgrenderer_p.h>
 
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
+class QImage;
+class QPaintDevice;
 class QSGSimpleRectNode;
+class QThreadPool;
 
 class QSGSoftwareRenderableNode;
 class QSGSoftwareRenderableNodeUpdater;
@@ -42,6 +48,8 @@ public:
 
 protected:
     QRegion renderNodes(QPainter *painter);
+    bool canRenderTiled(QPaintDevice *device, const QRegion &updateRegion) const;
+    QRegion renderNodesTiled(QImage *image, const QRegion &updateRegion);
     void buildRenderList();
     QRegion optimizeRenderList();
 
@@ -60,6 +68,7 @@ private:
     void nodeMaterialUpdated(QSGNode *node);
     void nodeMatrixUpdated(QSGNode *node);
     void nodeOpacityUpdated(QSGNode *node);
+    void renderTile(uchar *bits, const QImage &image, const QRect &tile);
 
     QHash<QSGNode*, QSGSoftwareRenderableNode*> m_nodes;
     QVector<QSGSoftwareRenderableNode*> m_renderableNodes;
@@ -72,6 +81,10 @@ private:
     bool m_isOpaque = false;
 
     QSGSoftwareRenderableNodeUpdater *m_nodeUpdater;
+
+    std::unique_ptr<QThreadPool> m_tilePool;
+    int m_tileSize = 128;
+    QMutex m_sharedPaintMutex;
 };
 
 QT_END_NAMESPACE
@@ -213,11 +213,9 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
 
     // Check for don't paint conditions
     if (m_nodeType != RenderNode) {
-        if (!m_isDirty || qFuzzyIsNull(m_opacity) || m_dirtyRegion.isEmpty()) {
-            m_isDirty = false;
-            m_dirtyRegion = QRegion();
-            return QRegion();
-        }
+        if (needsPainting())
+            paint(painter, forceOpaquePainting);
+        return markPainted();
     } else {
         if (!m_isDirty || qFuzzyIsNull(m_opacity)) {
             m_isDirty = false;
@@ -249,6 +247,22 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
             return br;
         }
     }
+}
+
+// Render nodes are not covered, they do not paint through the painter.
+bool QSGSoftwareRenderableNode::needsPainting() const
+{
+    Q_ASSERT(m_nodeType != RenderNode);
+    return m_isDirty && !qFuzzyIsNull(m_opacity) && !m_dirtyRegion.isEmpty();
+}
+
+// Paints the dirty region without changing the state of the node, so that
+// several painters, each covering a different part of the window, can paint
+// it before markPainted() is called.
+void QSGSoftwareRenderableNode::paint(QPainter *painter, bool forceOpaquePainting) const
+{
+    Q_ASSERT(painter);
+    Q_ASSERT(m_nodeType != RenderNode);
 
     painter->save();
     painter->setOpacity(m_opacity);
@@ -310,6 +324,15 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
     }
 
     painter->restore();
+}
+
+QRegion QSGSoftwareRenderableNode::markPainted()
+{
+    if (!needsPainting()) {
+        m_isDirty = false;
+        m_dirtyRegion = QRegion();
+        return QRegion();
+    }
 
     QRegion areaToBeFlushed = m_dirtyRegion;
     m_previousDirtyRegion = QRegion(m_boundingRectMax);
@@ -62,6 +62,9 @@ public:
     void update();
 
     QRegion renderNode(QPainter *painter, bool forceOpaquePainting = false);
+    bool needsPainting() const;
+    void paint(QPainter *painter, bool forceOpaquePainting = false) const;
+    QRegion markPainted();
     QRect boundingRectMin() const { return m_boundingRectMin; }
     QRect boundingRectMax() const { return m_boundingRectMax; }
     NodeType type() const { return m_nodeType; }
@@ -10,6 +10,7 @@
 
 #include <QtGui/QPaintDevice>
 #include <QtGui/QBackingStore>
+#include <QtGui/QImage>
 #include <QElapsedTimer>
 
 Q_LOGGING_CATEGORY(lcRenderer, "qt.scenegraph.softwarecontext.renderer")
@@ -85,9 +86,11 @@ void QSGSoftwareRenderer::render()
     // and append it to the renderlist.  At this point the RenderableNode object
     // should not need any further updating so it is just a matter of appending
     // RenderableNodes
+    const qint64 passStart = passTime();
     renderTimer.start();
     buildRenderList();
     qint64 buildRenderListTime = renderTimer.restart();
+    const qint64 renderListsDone = passTime();
 
     // Optimize Renderlist
     // This is a pass through the renderlist to determine what actually needs to
@@ -100,6 +103,8 @@ void QSGSoftwareRenderer::render()
     // repainted only paints what is needed, via the use of clip regions.
     const QRegion updateRegion = optimizeRenderList();
     qint64 optimizeRenderListTime = renderTimer.restart();
+    setPreparePhaseTimes(renderListsDone - passStart, passTime() - renderListsDone, 0);
+    markPrepareDone();
 
     // If Rendering to a backingstore, prepare it to be updated
     if (backingStore != nullptr) {
@@ -109,21 +114,29 @@ void QSGSoftwareRenderer::render()
         paintDevice = backingStore->paintDevice();
     }
 
-    QPainter painter(paintDevice);
-    painter.setRenderHint(QPainter::Antialiasing);
-    auto rc = static_cast<QSGSoftwareRenderContext *>(context());
-    QPainter *prevPainter = rc->m_activePainter;
-    rc->m_activePainter = &painter;
-
-    // Render the contents Renderlist
-    m_flushRegion = renderNodes(&painter);
-    qint64 renderTime = renderTimer.elapsed();
+    qint64 renderTime = 0;
+    if (canRenderTiled(paintDevice, updateRegion)) {
+        // Render the contents Renderlist, split into tiles painted in parallel
+        m_flushRegion = renderNodesTiled(static_cast<QImage *>(paintDevice), updateRegion);
+        renderTime = renderTimer.elapsed();
+    } else {
+        QPainter painter(paintDevice);
+        painter.setRenderHint(QPainter::Antialiasing);
+        auto rc = static_cast<QSGSoftwareRenderContext *>(context());
+        QPainter *prevPainter = rc->m_activePainter;
+        rc->m_activePainter = &painter;
+
+        // Render the contents Renderlist
+        m_flushRegion = renderNodes(&painter);
+        renderTime = renderTimer.elapsed();
+
+        painter.end();
+        rc->m_activePainter = prevPainter;
+    }
 
-    painter.end();
     if (backingStore != nullptr)
         backingStore->endPaint();
 
-    rc->m_activePainter = prevPainter;
     qCDebug(lcRenderer) << "render" << m_flushRegion << buildRenderListTime << optimizeRenderListTime << renderTime;
 }
 
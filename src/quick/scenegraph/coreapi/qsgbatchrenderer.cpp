@@ -9,15 +9,23 @@
 
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QtNumeric>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
 
 #include <QtGui/QGuiApplication>
 
 #include <private/qnumeric_p.h>
+#include <private/qsimd_p.h>
 #include "qsgmaterialshader_p.h"
 
 #include "qsgrhivisualizer_p.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -877,10 +885,19 @@ Renderer::Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMod
     m_batchNodeThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_NODE_THRESHOLD", 64);
     m_batchVertexThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_VERTEX_THRESHOLD", 1024);
     m_srbPoolThreshold = qt_sg_envInt("QSG_RENDERER_SRB_POOL_THRESHOLD", 1024);
+    // The 3D plane mode does not project onto the render target in a way the
+    // culling could rely on.
+    m_cullingEnabled = qt_sg_envInt("QSG_RENDERER_CULLING", 0) != 0
+            && m_renderMode != QSGRendererInterface::RenderMode3D;
+    m_uploadThreadCount = qMax(0, qt_sg_envInt("QSG_RENDERER_UPLOAD_THREADS",
+                                               qBound(0, QThread::idealThreadCount() - 1, 4)));
 
     if (Q_UNLIKELY(debug_build() || debug_render())) {
         qDebug("Batch thresholds: nodes: %d vertices: %d Srb pool threshold: %d",
                m_batchNodeThreshold, m_batchVertexThreshold, m_srbPoolThreshold);
+        if (m_cullingEnabled)
+            qDebug("Culling of batches and elements outside the render target enabled");
+        qDebug("Batch upload helper threads: %d", m_uploadThreadCount);
     }
 }
 
@@ -1691,8 +1708,163 @@ void Renderer::prepareOpaqueBatches()
     }
 }
 
+// Ranges shorter than this are scanned rather than looked up in the grid.
+static const int QSG_OVERLAP_GRID_MIN_RANGE = 32;
+// Elements covering more cells than this are not worth entering into each of them.
+static const int QSG_OVERLAP_GRID_MAX_CELLS_PER_ELEMENT = 16;
+
+int OverlapGrid::column(float x) const
+{
+    const float c = (x - left) / cellWidth;
+    return c <= 0 ? 0 : (c >= columns - 1 ? columns - 1 : int(c));
+}
+
+int OverlapGrid::row(float y) const
+{
+    const float r = (y - top) / cellHeight;
+    return r <= 0 ? 0 : (r >= rows - 1 ? rows - 1 : int(r));
+}
+
+static inline bool qsg_hasGridBounds(const Element *e)
+{
+    // Elements without a position attribute or vertices overlap with everything
+    return !e->boundsOutsideFloatRange
+            && e->bounds.tl.x != -FLT_MAX && e->bounds.tl.y != -FLT_MAX
+            && e->bounds.br.x != FLT_MAX && e->bounds.br.y != FLT_MAX;
+}
+
+void OverlapGrid::build(const QDataBuffer<Element *> &list)
+{
+    valid = true;
+    largeIndexes.reset();
+
+    Rect extent;
+    extent.set(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    int count = 0;
+    for (int i = 0; i < list.size(); ++i) {
+        const Element *e = list.at(i);
+        if (!e || e->isRenderNode || !qsg_hasGridBounds(e))
+            continue;
+        extent |= e->bounds;
+        ++count;
+    }
+
+    // Aim for a handful of elements per cell
+    const int side = qBound(1, int(std::sqrt(count / 4.0)), 256);
+    columns = side;
+    rows = side;
+    if (count) {
+        left = extent.tl.x;
+        top = extent.tl.y;
+        cellWidth = qMax((extent.br.x - extent.tl.x) / columns, 1.0f);
+        cellHeight = qMax((extent.br.y - extent.tl.y) / rows, 1.0f);
+    }
+
+    // Count the elements in each cell, turn the counts into start offsets and
+    // then fill the cells in the order of the list, which keeps them sorted.
+    const int cellCount = columns * rows;
+    cellStart.resize(cellCount + 1);
+    int *start = cellStart.data();
+    memset(start, 0, (cellCount + 1) * sizeof(int));
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < list.size(); ++i) {
+            const Element *e = list.at(i);
+            if (!e || e->isRenderNode)
+                continue;
+
+            const int c0 = column(e->bounds.tl.x);
+            const int c1 = column(e->bounds.br.x);
+            const int r0 = row(e->bounds.tl.y);
+            const int r1 = row(e->bounds.br.y);
+            if (!qsg_hasGridBounds(e)
+                    || (c1 - c0 + 1) * (r1 - r0 + 1) > QSG_OVERLAP_GRID_MAX_CELLS_PER_ELEMENT) {
+                if (pass == 0)
+                    largeIndexes.add(i);
+                continue;
+            }
+
+            for (int r = r0; r <= r1; ++r) {
+                for (int c = c0; c <= c1; ++c) {
+                    if (pass == 0)
+                        ++start[r * columns + c + 1];
+                    else
+                        cellIndexes.data()[start[r * columns + c]++] = i;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (int c = 0; c < cellCount; ++c)
+                start[c + 1] += start[c];
+            cellIndexes.resize(start[cellCount]);
+        } else {
+            // Filling advanced each start to the start of the next cell
+            memmove(start + 1, start, cellCount * sizeof(int));
+            start[0] = 0;
+        }
+    }
+}
+
+static inline bool qsg_intersectsInRange(const QDataBuffer<Element *> &list,
+                                         const int *begin, const int *end,
+                                         int first, int last, const Rect &bounds)
+{
+    for (const int *it = std::lower_bound(begin, end, first); it != end && *it <= last; ++it) {
+        Element *e = list.at(*it);
+#if defined(QSGBATCHRENDERER_INVALIDATE_WEDGED_NODES)
+        if (e->batch)
+            continue;
+#endif
+        Q_ASSERT(e->boundsComputed);
+        if (e->bounds.intersects(bounds))
+            return true;
+    }
+    return false;
+}
+
+bool OverlapGrid::intersects(const QDataBuffer<Element *> &list, int first, int last,
+                             const Rect &bounds) const
+{
+    Q_ASSERT(valid);
+
+    const int *large = largeIndexes.data();
+    if (qsg_intersectsInRange(list, large, large + largeIndexes.size(), first, last, bounds))
+        return true;
+
+    const int c0 = column(bounds.tl.x);
+    const int c1 = column(bounds.br.x);
+    const int r0 = row(bounds.tl.y);
+    const int r1 = row(bounds.br.y);
+    const int *start = cellStart.data();
+    const int *indexes = cellIndexes.data();
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cell = r * columns + c;
+            if (qsg_intersectsInRange(list, indexes + start[cell], indexes + start[cell + 1],
+                                      first, last, bounds)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*
+ * Short ranges are scanned, longer ones are looked up in a grid over the
+ * alpha render list, which is built the first time it is needed after the
+ * batches were invalidated. Without the grid, a scene of interleaved
+ * incompatible elements spread over a large area, like text on top of
+ * images, makes prepareAlphaBatches() quadratic in the number of elements.
+ */
 bool Renderer::checkOverlap(int first, int last, const Rect &bounds)
 {
+    if (last - first >= QSG_OVERLAP_GRID_MIN_RANGE) {
+        if (!m_alphaOverlapGrid.valid)
+            m_alphaOverlapGrid.build(m_alphaRenderList);
+        return m_alphaOverlapGrid.intersects(m_alphaRenderList, first, last, bounds);
+    }
+
     for (int i=first; i<=last; ++i) {
         Element *e = m_alphaRenderList.at(i);
 #if defined(QSGBATCHRENDERER_INVALIDATE_WEDGED_NODES)
@@ -1728,6 +1900,7 @@ void Renderer::prepareAlphaBatches()
         Q_ASSERT(!e->removed);
         e->ensureBoundsValid();
     }
+    m_alphaOverlapGrid.invalidate();
 
     for (int i=0; i<m_alphaRenderList.size(); ++i) {
         Element *ei = m_alphaRenderList.at(i);
@@ -1856,39 +2029,128 @@ static inline float calculateElementZOrder(const Element *e, qreal zRange)
  * iBase: The starting index for this element in the batch
  */
 
+/*
+ * Applies the 2D part of matrix to the positions of count vertices, which
+ * are stride bytes apart, in place. This is the plain loop, which
+ * qsg_mapPositions() falls back to for the vertices its vector path does not
+ * cover.
+ */
+void qsg_mapPositionsScalar(char *positions, int count, int stride, const QMatrix4x4 &matrix)
+{
+    const float *m = matrix.constData();
+    if (matrix.flags() == QMatrix4x4::Translation) {
+        for (int i=0; i<count; ++i) {
+            Pt *p = (Pt *) positions;
+            p->x += m[12];
+            p->y += m[13];
+            positions += stride;
+        }
+    } else if (matrix.flags() > QMatrix4x4::Translation) {
+        for (int i=0; i<count; ++i) {
+            ((Pt *) positions)->map(matrix);
+            positions += stride;
+        }
+    }
+}
+
+#if defined(__SSE2__)
+// Two positions fit into one register. For Point2D they are adjacent, for the
+// other layouts they are gathered from two vertices.
+static inline __m128 qsg_loadPositions(const char *p0, const char *p1, bool adjacent)
+{
+    if (adjacent)
+        return _mm_loadu_ps((const float *) p0);
+    return _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) p0), (const __m64 *) p1);
+}
+
+static inline void qsg_storePositions(char *p0, char *p1, bool adjacent, __m128 v)
+{
+    if (adjacent) {
+        _mm_storeu_ps((float *) p0, v);
+    } else {
+        _mm_storel_pi((__m64 *) p0, v);
+        _mm_storeh_pi((__m64 *) p1, v);
+    }
+}
+#endif
+
+/*
+ * Vectorized variant of qsg_mapPositionsScalar(), using SSE2 or NEON when the
+ * target has them. Positions are 8 bytes, so this handles the Point2D (8
+ * byte), ColoredPoint2D (12 byte) and TexturedPoint2D (16 byte) vertices, and
+ * any other layout with the position at a 4 byte aligned offset.
+ */
+void qsg_mapPositions(char *positions, int count, int stride, const QMatrix4x4 &matrix)
+{
+    if (matrix.flags() < QMatrix4x4::Translation)
+        return;
+
+    const bool translateOnly = matrix.flags() == QMatrix4x4::Translation;
+    const float *m = matrix.constData();
+    int done = 0;
+
+#if defined(__SSE2__)
+    const bool adjacent = stride == 2 * sizeof(float);
+    const __m128 translate = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+    if (translateOnly) {
+        for (; done + 2 <= count; done += 2) {
+            char *p0 = positions + done * stride;
+            char *p1 = p0 + stride;
+            const __m128 v = qsg_loadPositions(p0, p1, adjacent);
+            qsg_storePositions(p0, p1, adjacent, _mm_add_ps(v, translate));
+        }
+    } else {
+        const __m128 xColumn = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+        const __m128 yColumn = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+        for (; done + 2 <= count; done += 2) {
+            char *p0 = positions + done * stride;
+            char *p1 = p0 + stride;
+            const __m128 v = qsg_loadPositions(p0, p1, adjacent);
+            const __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+            const __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, xColumn), _mm_mul_ps(y, yColumn)),
+                                        translate);
+            qsg_storePositions(p0, p1, adjacent, r);
+        }
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    // The matrix is column-major, so the columns are adjacent in memory
+    const float32x2_t translate = vld1_f32(m + 12);
+    if (translateOnly) {
+        for (; done < count; ++done) {
+            float *p = (float *) (positions + done * stride);
+            vst1_f32(p, vadd_f32(vld1_f32(p), translate));
+        }
+    } else {
+        const float32x2_t xColumn = vld1_f32(m);
+        const float32x2_t yColumn = vld1_f32(m + 4);
+        for (; done < count; ++done) {
+            float *p = (float *) (positions + done * stride);
+            const float32x2_t v = vld1_f32(p);
+            vst1_f32(p, vmla_lane_f32(vmla_lane_f32(translate, xColumn, v, 0), yColumn, v, 1));
+        }
+    }
+#endif
+
+    qsg_mapPositionsScalar(positions + done * stride, count - done, stride, matrix);
+}
+
 void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, void *iBasePtr, int *indexCount)
 {
     if (Q_UNLIKELY(debug_upload())) qDebug() << "  - uploading element:" << e << e->node << (void *) *vertexData << (qintptr) (*zData - *vertexData) << (qintptr) (*indexData - *vertexData);
     QSGGeometry *g = e->node->geometry();
 
-    const QMatrix4x4 &localx = *e->node->matrix();
-    const float *localxdata = localx.constData();
-
     const int vCount = g->vertexCount();
     const int vSize = g->sizeOfVertex();
     memcpy(*vertexData, g->vertexData(), vSize * vCount);
 
     // apply vertex transform..
-    char *vdata = *vertexData + vaOffset;
-    if (localx.flags() == QMatrix4x4::Translation) {
-        for (int i=0; i<vCount; ++i) {
-            Pt *p = (Pt *) vdata;
-            p->x += localxdata[12];
-            p->y += localxdata[13];
-            vdata += vSize;
-        }
-    } else if (localx.flags() > QMatrix4x4::Translation) {
-        for (int i=0; i<vCount; ++i) {
-            ((Pt *) vdata)->map(localx);
-            vdata += vSize;
-        }
-    }
+    qsg_mapPositions(*vertexData + vaOffset, vCount, vSize, *e->node->matrix());
 
     if (useDepthBuffer()) {
         float *vzorder = (float *) *zData;
         float zorder = calculateElementZOrder(e, m_zRange);
-        for (int i=0; i<vCount; ++i)
-            vzorder[i] = zorder;
+        std::fill_n(vzorder, vCount, zorder);
         *zData += vCount * sizeof(float);
     }
 
@@ -1967,21 +2229,38 @@ QMatrix4x4 qsg_matrixForRoot(Node *node)
 }
 
 void Renderer::uploadBatch(Batch *b)
+{
+    quint32 vertexBytes = 0;
+    quint32 indexBytes = 0;
+    if (!prepareBatchUpload(b, &vertexBytes, &indexBytes))
+        return;
+
+    map(&b->ibo, indexBytes, true);
+    map(&b->vbo, vertexBytes);
+    fillBatchBuffers(b);
+    finishBatchUpload(b);
+}
+
+/*
+ * Decides whether the batch is merged and computes the sizes of its vertex
+ * and index data. Returns false if there is nothing to upload.
+ */
+bool Renderer::prepareBatchUpload(Batch *b, quint32 *vertexBytes, quint32 *indexBytes)
 {
     // Early out if nothing has changed in this batch..
     if (!b->needsUpload) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "already uploaded...";
-        return;
+        return false;
     }
 
     if (!b->first) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "is invalid...";
-        return;
+        return false;
     }
 
     if (b->isRenderNode) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch: " << b << "is a render node...";
-        return;
+        return false;
     }
 
     // Figure out if we can merge or not, if not, then just render the batch as is..
@@ -2026,7 +2305,7 @@ void Renderer::uploadBatch(Batch *b)
     // Abort if there are no vertices in this batch.. We abort this late as
     // this is a broken usecase which we do not care to optimize for...
     if (b->vertexCount == 0 || (b->merged && b->indexCount == 0))
-        return;
+        return false;
 
     /* Allocate memory for this batch. Merged batches are divided into three separate blocks
            1. Vertex data for all elements, as they were in the QSGGeometry object, but
@@ -2050,21 +2329,31 @@ void Renderer::uploadBatch(Batch *b)
         ibufferSize = unmergedIndexSize;
     }
 
-    map(&b->ibo, ibufferSize, true);
-    map(&b->vbo, bufferSize);
+    *vertexBytes = bufferSize;
+    *indexBytes = ibufferSize;
+    return true;
+}
 
+/*
+ * Writes the vertex and index data of the batch to its mapped buffers. This
+ * only touches the batch and reads its nodes, so batches with disjoint
+ * buffers can be filled on different threads.
+ */
+void Renderer::fillBatchBuffers(Batch *b)
+{
     if (Q_UNLIKELY(debug_upload())) qDebug() << " - batch" << b << " first:" << b->first << " root:"
                                              << b->root << " merged:" << b->merged << " positionAttribute" << b->positionAttribute
                                              << " vbo:" << b->vbo.buf << ":" << b->vbo.size;
 
     if (b->merged) {
+        QSGGeometry *g = b->first->node->geometry();
         char *vertexData = b->vbo.data;
         char *zData = vertexData + b->vertexCount * g->sizeOfVertex();
         char *indexData = b->ibo.data;
 
         quint16 iOffset16 = 0;
         quint32 iOffset32 = 0;
-        e = b->first;
+        Element *e = b->first;
         uint verticesInSet = 0;
         // Start a new set already after 65534 vertices because 0xFFFF may be
         // used for an always-on primitive restart with some apis (adapt for
@@ -2135,8 +2424,13 @@ void Renderer::uploadBatch(Batch *b)
             e = e->nextInBatch;
         }
     }
+}
+
+void Renderer::finishBatchUpload(Batch *b)
+{
 #ifndef QT_NO_DEBUG_OUTPUT
     if (Q_UNLIKELY(debug_upload())) {
+        QSGGeometry *g = b->first->node->geometry();
         const char *vd = b->vbo.data;
         qDebug() << "  -- Vertex Data, count:" << b->vertexCount << " - " << g->sizeOfVertex() << "bytes/vertex";
         for (int i=0; i<b->vertexCount; ++i) {
@@ -2211,6 +2505,102 @@ void Renderer::uploadBatch(Batch *b)
         b->uploadedThisFrame = true;
 }
 
+/*
+ * Uploads all batches that need it, filling the vertex and index data of
+ * different batches on helper threads from the global thread pool alongside
+ * the render thread. Each batch gets its own range of the upload pools, which
+ * are sized for the whole frame up front so that they are not reallocated
+ * while the data is written. Creating the QRhiBuffers and queuing their
+ * updates happens on the render thread afterwards.
+ */
+void Renderer::uploadBatchesConcurrently(quint32 *largestVBO, quint32 *largestIBO)
+{
+    // Below this amount of data per thread the helpers cost more than they save
+    static constexpr qsizetype MinBytesPerThread = 64 * 1024;
+
+    struct Upload
+    {
+        Batch *batch;
+        quint32 vertexOffset;
+        quint32 indexOffset;
+    };
+
+    QVarLengthArray<Upload, 64> uploads;
+    quint32 vertexPoolSize = 0;
+    quint32 indexPoolSize = 0;
+    const auto collect = [&](const QDataBuffer<Batch *> &batches) {
+        for (int i = 0; i < batches.size(); ++i) {
+            Batch *b = batches.at(i);
+            *largestVBO = qMax(b->vbo.size, *largestVBO);
+            *largestIBO = qMax(b->ibo.size, *largestIBO);
+            quint32 vertexBytes = 0;
+            quint32 indexBytes = 0;
+            if (!prepareBatchUpload(b, &vertexBytes, &indexBytes))
+                continue;
+            // Keep every batch's data aligned, as with a separate allocation
+            uploads.append({ b, vertexPoolSize, indexPoolSize });
+            b->vbo.size = vertexBytes;
+            b->ibo.size = indexBytes;
+            vertexPoolSize = aligned(vertexPoolSize + vertexBytes, 16u);
+            indexPoolSize = aligned(indexPoolSize + indexBytes, 16u);
+        }
+    };
+    collect(m_opaqueBatches);
+    collect(m_alphaBatches);
+
+    if (uploads.isEmpty())
+        return;
+
+    if (vertexPoolSize > quint32(m_vertexUploadPool.size()))
+        m_vertexUploadPool.resize(vertexPoolSize);
+    if (indexPoolSize > quint32(m_indexUploadPool.size()))
+        m_indexUploadPool.resize(indexPoolSize);
+    for (const Upload &upload : uploads) {
+        upload.batch->vbo.data = m_vertexUploadPool.data() + upload.vertexOffset;
+        upload.batch->ibo.data = m_indexUploadPool.data() + upload.indexOffset;
+    }
+
+    std::atomic<qsizetype> next = 0;
+    const auto fill = [&]() {
+        for (qsizetype i = next++; i < uploads.size(); i = next++)
+            fillBatchBuffers(uploads.at(i).batch);
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype helperCount = qMin(qMin(qsizetype(m_uploadThreadCount),
+                                            qsizetype(pool->maxThreadCount())),
+                                       qMin(uploads.size(),
+                                            qsizetype(vertexPoolSize) / MinBytesPerThread) - 1);
+    if (helperCount <= 0) {
+        fill();
+    } else {
+        QSemaphore finished;
+        std::vector<std::unique_ptr<QRunnable>> helpers;
+        helpers.reserve(helperCount);
+        for (qsizetype i = 0; i < helperCount; ++i) {
+            QRunnable *helper = QRunnable::create([&]() {
+                fill();
+                finished.release();
+            });
+            helper->setAutoDelete(false);
+            helpers.emplace_back(helper);
+            pool->start(helper);
+        }
+
+        fill();
+
+        int running = int(helperCount);
+        for (const std::unique_ptr<QRunnable> &helper : helpers) {
+            if (pool->tryTake(helper.get()))
+                --running;
+        }
+        finished.acquire(running);
+    }
+
+    for (const Upload &upload : uploads)
+        finishBatchUpload(upload.batch);
+}
+
 void Renderer::applyClipStateToGraphicsState()
 {
     m_gstate.usesScissor = (m_currentClipState.type & ClipState::ScissorClip);
@@ -3041,6 +3431,91 @@ void Renderer::updateMaterialStaticData(ShaderManager::Shader *sms,
     }
 }
 
+/*
+ * Returns true if the bounds of the element, mapped by matrix to normalized
+ * device coordinates, lie outside the viewport or, when a clip state is
+ * given, outside its scissor rect. Elements without bounds and elements
+ * transformed with perspective are never culled.
+ */
+bool Renderer::isElementCulled(Element *e, const QMatrix4x4 &matrix, const ClipState *clipState) const
+{
+    if (e->isRenderNode)
+        return false;
+
+    e->ensureBoundsValid();
+    const Rect &bounds = e->bounds;
+    if (e->boundsOutsideFloatRange
+            || bounds.tl.x == -FLT_MAX || bounds.tl.y == -FLT_MAX
+            || bounds.br.x == FLT_MAX || bounds.br.y == FLT_MAX) {
+        return false;
+    }
+
+    if (!qFuzzyIsNull(matrix(3, 0)) || !qFuzzyIsNull(matrix(3, 1)))
+        return false;
+
+    const QRectF r = matrix.mapRect(QRectF(QPointF(bounds.tl.x, bounds.tl.y),
+                                           QPointF(bounds.br.x, bounds.br.y)));
+    if (r.right() < -1 || r.left() > 1 || r.bottom() < -1 || r.top() > 1)
+        return true;
+
+    if (!clipState)
+        return false;
+
+    // Same mapping to device pixels as for the scissor rect in updateClipState()
+    const QRect deviceRect = this->deviceRect();
+    const qreal x1 = (r.left() + 1) * deviceRect.width() * qreal(0.5);
+    const qreal y1 = (r.top() + 1) * deviceRect.height() * qreal(0.5);
+    const qreal x2 = (r.right() + 1) * deviceRect.width() * qreal(0.5);
+    const qreal y2 = (r.bottom() + 1) * deviceRect.height() * qreal(0.5);
+    const std::array<int, 4> scissor = clipState->scissor.scissor();
+    return x2 <= scissor[0] || x1 >= scissor[0] + scissor[2]
+            || y2 <= scissor[1] || y1 >= scissor[1] + scissor[3];
+}
+
+/*
+ * Returns true if none of the elements in the batch intersect the viewport,
+ * in which case the batch does not need to be prepared or drawn. With
+ * checkScissor, which requires the batch's clip state to be up to date,
+ * the elements are also tested against the scissor rect. The culled elements
+ * of unmerged batches are flagged so that renderUnmergedBatch() skips them.
+ */
+bool Renderer::cullBatch(Batch *batch, bool checkScissor)
+{
+    if (batch->isRenderNode)
+        return false;
+
+    const ClipState *clipState = nullptr;
+    if (checkScissor) {
+        if (batch->clipState.type == ClipState::ScissorClip)
+            clipState = &batch->clipState;
+        else if (batch->merged)
+            return false;
+    }
+
+    QMatrix4x4 matrix = projectionMatrixWithNativeNDC();
+    if (batch->root)
+        matrix *= qsg_matrixForRoot(batch->root);
+
+    int elementCount = 0;
+    int culledCount = 0;
+    for (Element *e = batch->first; e; e = e->nextInBatch) {
+        e->culled = isElementCulled(e, matrix, clipState);
+        ++elementCount;
+        if (e->culled)
+            ++culledCount;
+    }
+
+    if (culledCount == elementCount) {
+        m_culledElementCount += elementCount;
+        ++m_culledBatchCount;
+        return true;
+    }
+
+    if (checkScissor && !batch->merged)
+        m_culledElementCount += culledCount;
+    return false;
+}
+
 bool Renderer::prepareRenderMergedBatch(Batch *batch, PreparedRenderBatch *renderBatch)
 {
     if (batch->vertexCount == 0 || batch->indexCount == 0)
@@ -3414,9 +3889,17 @@ void Renderer::renderUnmergedBatch(PreparedRenderBatch *renderBatch, bool depthP
 
     while (e) {
         QSGGeometry *g = e->node->geometry();
-        checkLineWidth(g);
         const int effectiveIndexSize = m_uint32IndexForRhi ? sizeof(quint32) : g->sizeOfIndex();
 
+        // Culled elements are still part of the uploaded buffers
+        if (m_cullingEnabled && e->culled) {
+            vOffset += g->sizeOfVertex() * g->vertexCount();
+            iOffset += g->indexCount() * effectiveIndexSize;
+            e = e->nextInBatch;
+            continue;
+        }
+
+        checkLineWidth(g);
         setGraphicsPipeline(cb, batch, e, depthPostPass);
 
         const QRhiCommandBuffer::VertexInput vbufBinding(batch->vbo.buf, vOffset);
@@ -3523,6 +4006,7 @@ void Renderer::render()
         return;
 
     prepareRenderPass(&m_mainRenderPassContext);
+    markPrepareDone();
     beginRenderPass(&m_mainRenderPassContext);
     recordRenderPass(&m_mainRenderPassContext);
     endRenderPass(&m_mainRenderPassContext);
@@ -3562,6 +4046,7 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     ctx->timeSorting = 0;
     ctx->timeUploadOpaque = 0;
     ctx->timeUploadAlpha = 0;
+    const qint64 passStart = passTime();
 
     if (Q_UNLIKELY(debug_render() || debug_build())) {
         QByteArray type("rebuild:");
@@ -3606,6 +4091,7 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
         }
     }
     if (Q_UNLIKELY(debug_render())) ctx->timeRenderLists = ctx->timer.restart();
+    const qint64 renderListsDone = passTime();
 
     for (int i=0; i<m_opaqueBatches.size(); ++i)
         m_opaqueBatches.at(i)->cleanupRemovedElements();
@@ -3663,31 +4149,44 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     }
 
     if (Q_UNLIKELY(debug_render())) ctx->timeSorting = ctx->timer.restart();
+    const qint64 batchingDone = passTime();
 
     quint32 largestVBO = 0;
     quint32 largestIBO = 0;
 
-    if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Opaque Batches:");
-    for (int i=0; i<m_opaqueBatches.size(); ++i) {
-        Batch *b = m_opaqueBatches.at(i);
-        largestVBO = qMax(b->vbo.size, largestVBO);
-        largestIBO = qMax(b->ibo.size, largestIBO);
-        uploadBatch(b);
-    }
-    if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timer.restart();
+    // The debug output of the uploads needs to come out in order, and the
+    // visualizer keeps a separate copy of the data of each batch.
+    if (m_uploadThreadCount > 0 && !debug_upload()
+            && m_visualizer->mode() == Visualizer::VisualizeNothing) {
+        uploadBatchesConcurrently(&largestVBO, &largestIBO);
+        if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timer.restart();
+    } else {
+        if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Opaque Batches:");
+        for (int i=0; i<m_opaqueBatches.size(); ++i) {
+            Batch *b = m_opaqueBatches.at(i);
+            largestVBO = qMax(b->vbo.size, largestVBO);
+            largestIBO = qMax(b->ibo.size, largestIBO);
+            uploadBatch(b);
+        }
+        if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timer.restart();
 
-    if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Alpha Batches:");
-    for (int i=0; i<m_alphaBatches.size(); ++i) {
-        Batch *b = m_alphaBatches.at(i);
-        uploadBatch(b);
-        largestVBO = qMax(b->vbo.size, largestVBO);
-        largestIBO = qMax(b->ibo.size, largestIBO);
+        if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Alpha Batches:");
+        for (int i=0; i<m_alphaBatches.size(); ++i) {
+            Batch *b = m_alphaBatches.at(i);
+            uploadBatch(b);
+            largestVBO = qMax(b->vbo.size, largestVBO);
+            largestIBO = qMax(b->ibo.size, largestIBO);
+        }
+        if (Q_UNLIKELY(debug_render())) ctx->timeUploadAlpha = ctx->timer.restart();
     }
-    if (Q_UNLIKELY(debug_render())) ctx->timeUploadAlpha = ctx->timer.restart();
 
     m_vertexUploadPool.resize(largestVBO);
     m_indexUploadPool.resize(largestIBO);
 
+    const qint64 uploadDone = passTime();
+    setPreparePhaseTimes(renderListsDone - passStart, batchingDone - renderListsDone,
+                         uploadDone - batchingDone);
+
     if (Q_UNLIKELY(debug_render())) {
         qDebug().nospace() << "Rendering:" << Qt::endl
                            << " -> Opaque: " << qsg_countNodesInBatches(m_opaqueBatches) << " nodes in " << m_opaqueBatches.size() << " batches..." << Qt::endl
@@ -3729,16 +4228,23 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
 
     m_gstate.sampleCount = renderTarget().rt->sampleCount();
 
+    m_culledElementCount = 0;
+    m_culledBatchCount = 0;
+
     ctx->opaqueRenderBatches.clear();
     if (Q_LIKELY(renderOpaque)) {
         for (int i = 0, ie = m_opaqueBatches.size(); i != ie; ++i) {
             Batch *b = m_opaqueBatches.at(i);
+            if (m_cullingEnabled && cullBatch(b, false))
+                continue;
             PreparedRenderBatch renderBatch;
             bool ok;
             if (b->merged)
                 ok = prepareRenderMergedBatch(b, &renderBatch);
             else
                 ok = prepareRenderUnmergedBatch(b, &renderBatch);
+            if (ok && m_cullingEnabled && cullBatch(b, true))
+                ok = false;
             if (ok)
                 ctx->opaqueRenderBatches.append(renderBatch);
         }
@@ -3763,6 +4269,8 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     if (Q_LIKELY(renderAlpha)) {
         for (int i = 0, ie = m_alphaBatches.size(); i != ie; ++i) {
             Batch *b = m_alphaBatches.at(i);
+            if (m_cullingEnabled && cullBatch(b, false))
+                continue;
             PreparedRenderBatch renderBatch;
             bool ok;
             if (b->merged)
@@ -3771,11 +4279,18 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
                 ok = prepareRhiRenderNode(b, &renderBatch);
             else
                 ok = prepareRenderUnmergedBatch(b, &renderBatch);
+            if (ok && m_cullingEnabled && cullBatch(b, true))
+                ok = false;
             if (ok)
                 ctx->alphaRenderBatches.append(renderBatch);
         }
     }
 
+    if (Q_UNLIKELY(debug_render()) && m_cullingEnabled) {
+        qDebug().nospace() << " -> Culled: " << m_culledElementCount << " nodes, "
+                           << m_culledBatchCount << " batches";
+    }
+
     m_rebuild = 0;
 
 #if defined(QSGBATCHRENDERER_INVALIDATE_WEDGED_NODES)
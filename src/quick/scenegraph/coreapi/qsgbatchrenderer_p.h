@@ -276,6 +276,7 @@ struct Element {
         , orphaned(false)
         , isRenderNode(false)
         , isMaterialBlended(false)
+        , culled(false)
     {
     }
 
@@ -309,6 +310,7 @@ struct Element {
     uint orphaned : 1;
     uint isRenderNode : 1;
     uint isMaterialBlended : 1;
+    uint culled : 1;
 };
 
 struct RenderNodeElement : public Element {
@@ -322,6 +324,44 @@ struct RenderNodeElement : public Element {
     QSGRenderNode *renderNode;
 };
 
+Q_QUICK_PRIVATE_EXPORT void qsg_mapPositions(char *positions, int count, int stride, const QMatrix4x4 &matrix);
+Q_QUICK_PRIVATE_EXPORT void qsg_mapPositionsScalar(char *positions, int count, int stride, const QMatrix4x4 &matrix);
+
+// Uniform grid over the bounds of the elements in a render list, used by
+// Renderer::checkOverlap() to find the elements in a range of the list that
+// intersect a rect without testing all of them. Each cell lists the indexes
+// of the elements overlapping it in increasing order. Elements without usable
+// bounds, or covering many cells, are kept in a separate list instead.
+struct OverlapGrid
+{
+    OverlapGrid()
+        : cellStart(0)
+        , cellIndexes(0)
+        , largeIndexes(0)
+    {
+    }
+
+    void build(const QDataBuffer<Element *> &list);
+    void invalidate() { valid = false; }
+    bool intersects(const QDataBuffer<Element *> &list, int first, int last, const Rect &bounds) const;
+
+    inline int column(float x) const;
+    inline int row(float y) const;
+
+    bool valid = false;
+    int columns = 0;
+    int rows = 0;
+    float left = 0;
+    float top = 0;
+    float cellWidth = 1;
+    float cellHeight = 1;
+
+    // Cell c holds cellIndexes[cellStart[c]] up to cellIndexes[cellStart[c + 1]]
+    QDataBuffer<int> cellStart;
+    QDataBuffer<int> cellIndexes;
+    QDataBuffer<int> largeIndexes;
+};
+
 struct BatchRootInfo {
     BatchRootInfo() {}
     QSet<Node *> subRoots;
@@ -729,6 +769,9 @@ public:
     Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMode renderMode = QSGRendererInterface::RenderMode2D);
     ~Renderer();
 
+    int culledElementCount() const { return m_culledElementCount; }
+    int culledBatchCount() const { return m_culledBatchCount; }
+
 protected:
     void nodeChanged(QSGNode *node, QSGNode::DirtyState state) override;
     void render() override;
@@ -793,6 +836,10 @@ private:
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
 
     void uploadBatch(Batch *b);
+    bool prepareBatchUpload(Batch *b, quint32 *vertexBytes, quint32 *indexBytes);
+    void fillBatchBuffers(Batch *b);
+    void finishBatchUpload(Batch *b);
+    void uploadBatchesConcurrently(quint32 *largestVBO, quint32 *largestIBO);
     void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, void *iBasePtr, int *indexCount);
 
     bool ensurePipelineState(Element *e, const ShaderManager::Shader *sms, bool depthPostPass = false);
@@ -802,6 +849,8 @@ private:
     void updateMaterialStaticData(ShaderManager::Shader *sms, QSGMaterialShader::RenderState &renderState,
                                   QSGMaterial *material, Batch *batch, bool *gstateChanged);
     void checkLineWidth(QSGGeometry *g);
+    bool isElementCulled(Element *e, const QMatrix4x4 &matrix, const ClipState *clipState) const;
+    bool cullBatch(Batch *batch, bool checkScissor);
     bool prepareRenderMergedBatch(Batch *batch, PreparedRenderBatch *renderBatch);
     void renderMergedBatch(PreparedRenderBatch *renderBatch, bool depthPostPass = false);
     bool prepareRenderUnmergedBatch(Batch *batch, PreparedRenderBatch *renderBatch);
@@ -857,6 +906,7 @@ private:
     QDataBuffer<Element *> m_elementsToDelete;
     QDataBuffer<Element *> m_tmpAlphaElements;
     QDataBuffer<Element *> m_tmpOpaqueElements;
+    OverlapGrid m_alphaOverlapGrid;
 
     uint m_rebuild;
     qreal m_zRange;
@@ -869,6 +919,11 @@ private:
     int m_batchVertexThreshold;
     int m_srbPoolThreshold;
 
+    bool m_cullingEnabled;
+    int m_culledElementCount = 0;
+    int m_culledBatchCount = 0;
+    int m_uploadThreadCount;
+
     Visualizer *m_visualizer;
 
     ShaderManager *m_shaderManager; // per rendercontext, shared
@@ -134,12 +134,22 @@ void QSGRenderer::renderScene()
 
     qint64 renderTime = 0;
 
+    if (m_record_pass_times)
+        m_pass_timer.start();
+
     preprocess();
 
+    // Renderers that prepare their render pass separately move this forward
+    // with markPrepareDone(), otherwise all of render() counts as recording.
+    if (m_record_pass_times)
+        m_prepare_time = m_pass_timer.nsecsElapsed();
+
     Q_TRACE(QSG_render_entry);
     render();
     if (profileFrames)
         renderTime = frameTimer.nsecsElapsed();
+    if (m_record_pass_times)
+        m_record_time = m_pass_timer.nsecsElapsed() - m_prepare_time;
     Q_TRACE(QSG_render_exit);
     Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphRendererFrame,
                            QQuickProfiler::SceneGraphRendererRender);
@@ -163,17 +173,29 @@ void QSGRenderer::prepareSceneInline()
     Q_ASSERT(!m_is_rendering);
     m_is_rendering = true;
 
+    if (m_record_pass_times)
+        m_pass_timer.start();
+
     preprocess();
 
     prepareInline();
+
+    if (m_record_pass_times)
+        m_prepare_time = m_pass_timer.nsecsElapsed();
 }
 
 void QSGRenderer::renderSceneInline()
 {
     Q_ASSERT(m_is_rendering);
 
+    if (m_record_pass_times)
+        m_pass_timer.start();
+
     renderInline();
 
+    if (m_record_pass_times)
+        m_record_time = m_pass_timer.nsecsElapsed();
+
     m_is_rendering = false;
     m_changed_emitted = false;
 }
@@ -206,6 +228,34 @@ void QSGRenderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
     }
 }
 
+/*!
+    \internal
+
+    Called by renderers from render() once the render pass is prepared, so
+    that the preparation is not counted as recording in lastRecordTime().
+ */
+void QSGRenderer::markPrepareDone()
+{
+    if (m_record_pass_times)
+        m_prepare_time = m_pass_timer.nsecsElapsed();
+}
+
+/*!
+    \internal
+
+    Called by renderers that know how their preparation splits into building
+    the render lists, batching and uploading, with the durations of these
+    parts in nanoseconds, as measured with passTime().
+ */
+void QSGRenderer::setPreparePhaseTimes(qint64 renderLists, qint64 batching, qint64 upload)
+{
+    if (!m_record_pass_times)
+        return;
+    m_render_list_time = renderLists;
+    m_batching_time = batching;
+    m_upload_time = upload;
+}
+
 void QSGRenderer::preprocess()
 {
     Q_TRACE(QSG_preprocess_entry);
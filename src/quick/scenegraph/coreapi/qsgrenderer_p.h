@@ -21,6 +21,8 @@
 
 #include <QtQuick/private/qsgcontext_p.h>
 
+#include <QtCore/qelapsedtimer.h>
+
 QT_BEGIN_NAMESPACE
 
 class QSGNodeUpdater;
@@ -87,6 +89,15 @@ public:
 
     void clearChangedFlag() { m_changed_emitted = false; }
 
+    // Measured while enabled, for QQuickFrameTimings. In nanoseconds.
+    void setRecordPassTimes(bool enabled) { m_record_pass_times = enabled; }
+    qint64 lastPrepareTime() const { return m_prepare_time; }
+    qint64 lastRecordTime() const { return m_record_time; }
+    // The parts of the preparation, for the renderers that report them
+    qint64 lastRenderListTime() const { return m_render_list_time; }
+    qint64 lastBatchingTime() const { return m_batching_time; }
+    qint64 lastUploadTime() const { return m_upload_time; }
+
     // Accessed by QSGMaterialShader::RenderState.
     QByteArray *currentUniformData() const { return m_current_uniform_data; }
     QRhiResourceUpdateBatch *currentResourceUpdateBatch() const { return m_current_resource_update_batch; }
@@ -111,6 +122,9 @@ protected:
     virtual void renderInline();
 
     virtual void preprocess();
+    void markPrepareDone();
+    qint64 passTime() const { return m_record_pass_times ? m_pass_timer.nsecsElapsed() : 0; }
+    void setPreparePhaseTimes(qint64 renderLists, qint64 batching, qint64 upload);
 
     void addNodesToPreprocess(QSGNode *node);
     void removeNodesToPreprocess(QSGNode *node);
@@ -128,6 +142,13 @@ protected:
     QRhiResourceUpdateBatch *m_current_resource_update_batch;
     QRhi *m_rhi;
     QSGRenderTarget m_rt;
+    QElapsedTimer m_pass_timer;
+    qint64 m_prepare_time = 0;
+    qint64 m_record_time = 0;
+    qint64 m_render_list_time = 0;
+    qint64 m_batching_time = 0;
+    qint64 m_upload_time = 0;
+    bool m_record_pass_times = false;
     struct {
         QSGRenderContext::RenderPassCallback start = nullptr;
         QSGRenderContext::RenderPassCallback end = nullptr;
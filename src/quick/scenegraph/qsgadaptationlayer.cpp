@@ -6,6 +6,7 @@
 #include <qmath.h>
 #include <QtQuick/private/qsgdistancefieldglyphnode_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsgdistancefielddiskcache_p.h>
 #include <private/qrawfont_p.h>
 #include <QtGui/qguiapplication.h>
 #include <qdir.h>
@@ -13,6 +14,12 @@
 
 #include <private/qquickprofiler_p.h>
 #include <QElapsedTimer>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+
+#include <atomic>
+#include <vector>
 
 #include <qtquick_tracepoints_p.h>
 
@@ -139,6 +146,63 @@ bool QSGDistanceFieldGlyphCache::isActive() const
     return true;
 }
 
+namespace {
+struct DistanceFieldJob
+{
+    QPainterPath path;
+    glyph_t glyph;
+    int index;
+};
+}
+
+// Generating a distance field only reads the path of the glyph, so helpers on
+// the global thread pool generate them alongside the calling thread. Helpers
+// that have not started by the time the calling thread runs out of glyphs are
+// taken back, so that a busy pool does not hold up the render thread.
+static void generateDistanceFields(const QList<DistanceFieldJob> &jobs, QDistanceField *results,
+                                   bool doubleGlyphResolution)
+{
+    static constexpr qsizetype MinGlyphsPerThread = 8;
+
+    std::atomic<qsizetype> next = 0;
+    const auto generate = [&]() {
+        for (qsizetype i = next++; i < jobs.size(); i = next++) {
+            const DistanceFieldJob &job = jobs.at(i);
+            results[job.index] = QDistanceField(job.path, job.glyph, doubleGlyphResolution);
+        }
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype helperCount = qMin(qsizetype(pool->maxThreadCount()),
+                                       jobs.size() / MinGlyphsPerThread - 1);
+    if (helperCount <= 0) {
+        generate();
+        return;
+    }
+
+    QSemaphore finished;
+    std::vector<std::unique_ptr<QRunnable>> helpers;
+    helpers.reserve(helperCount);
+    for (qsizetype i = 0; i < helperCount; ++i) {
+        QRunnable *helper = QRunnable::create([&]() {
+            generate();
+            finished.release();
+        });
+        helper->setAutoDelete(false);
+        helpers.emplace_back(helper);
+        pool->start(helper);
+    }
+
+    generate();
+
+    int running = int(helperCount);
+    for (const std::unique_ptr<QRunnable> &helper : helpers) {
+        if (pool->tryTake(helper.get()))
+            --running;
+    }
+    finished.acquire(running);
+}
+
 void QSGDistanceFieldGlyphCache::update()
 {
     m_populatingGlyphs.clear();
@@ -154,17 +218,27 @@ void QSGDistanceFieldGlyphCache::update()
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphAdaptationLayerFrame);
     Q_TRACE(QSGDistanceFieldGlyphCache_glyphRender_entry);
 
-    QList<QDistanceField> distanceFields;
     const int pendingGlyphsSize = m_pendingGlyphs.size();
-    distanceFields.reserve(pendingGlyphsSize);
+    QList<QDistanceField> distanceFields(pendingGlyphsSize);
+    QList<DistanceFieldJob> jobs;
     for (int i = 0; i < pendingGlyphsSize; ++i) {
-        GlyphData &gd = glyphData(m_pendingGlyphs.at(i));
-        distanceFields.append(QDistanceField(gd.path,
-                                             m_pendingGlyphs.at(i),
-                                             m_doubleGlyphResolution));
+        const glyph_t glyph = m_pendingGlyphs.at(i);
+        GlyphData &gd = glyphData(glyph);
+        if (!m_diskCache || !m_diskCache->lookup(glyph, gd.path.boundingRect(), &distanceFields[i]))
+            jobs.append({ gd.path, glyph, i });
         gd.path = QPainterPath(); // no longer needed, so release memory used by the painter path
     }
 
+    generateDistanceFields(jobs, distanceFields.data(), m_doubleGlyphResolution);
+
+    if (m_diskCache && !jobs.isEmpty()) {
+        QList<QDistanceField> generated;
+        generated.reserve(jobs.size());
+        for (const DistanceFieldJob &job : std::as_const(jobs))
+            generated.append(distanceFields.at(job.index));
+        m_diskCache->store(generated);
+    }
+
     qint64 renderTime = 0;
     int count = m_pendingGlyphs.size();
     if (profileFrames)
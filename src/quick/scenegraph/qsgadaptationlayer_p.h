@@ -36,6 +36,8 @@
 // ### remove
 #include <QtQuick/private/qquicktext_p.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QSGNode;
@@ -51,6 +53,7 @@ class QSGSpriteNode;
 class QSGRenderNode;
 class QSGRenderContext;
 class QRhiTexture;
+class QSGDistanceFieldDiskCache;
 
 class Q_QUICK_PRIVATE_EXPORT QSGNodeVisitorEx
 {
@@ -520,6 +523,7 @@ protected:
 
 protected:
     QRawFont m_referenceFont;
+    std::unique_ptr<QSGDistanceFieldDiskCache> m_diskCache;
 
 private:
     int m_glyphCount;
@@ -506,15 +506,34 @@ QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, Q
         m_textures.insert(factory, texture);
         m_mutex.unlock();
 
-        connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)), Qt::DirectConnection);
+        connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)),
+                Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
     }
     return texture;
 }
 
+/*!
+    Marks the texture of \a factory as about to be created and uploaded ahead
+    of the sync that needs it, so that textureForFactory() can return it
+    right away. Called on the GUI thread, before the render loop hands the
+    factory's image to the render thread.
+ */
+void QSGRenderContext::schedulePreupload(QQuickTextureFactory *factory)
+{
+    m_mutex.lock();
+    m_texturesToPreupload.insert(factory);
+    m_mutex.unlock();
+
+    connect(factory, SIGNAL(destroyed(QObject*)), this, SLOT(textureFactoryDestroyed(QObject*)),
+            Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+}
+
 void QSGRenderContext::textureFactoryDestroyed(QObject *o)
 {
     m_mutex.lock();
-    m_texturesToDelete << m_textures.take(o);
+    if (QSGTexture *texture = m_textures.take(o))
+        m_texturesToDelete << texture;
+    m_texturesToPreupload.remove(o);
     m_mutex.unlock();
 }
 
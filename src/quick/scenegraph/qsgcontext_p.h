@@ -159,6 +159,7 @@ public:
     virtual void invalidateGlyphCaches();
     virtual QSGDistanceFieldGlyphCache *distanceFieldGlyphCache(const QRawFont &font, int renderTypeQuality);
     QSGTexture *textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window);
+    void schedulePreupload(QQuickTextureFactory *factory);
 
     virtual QSGTexture *createTexture(const QImage &image, uint flags = CreateTexture_Alpha) const = 0;
     virtual QSGRenderer *createRenderer(QSGRendererInterface::RenderMode renderMode = QSGRendererInterface::RenderMode2D) = 0;
@@ -185,6 +186,7 @@ protected:
     QMutex m_mutex;
     QHash<QObject *, QSGTexture *> m_textures;
     QSet<QSGTexture *> m_texturesToDelete;
+    QSet<QObject *> m_texturesToPreupload;
     QHash<QString, QSGDistanceFieldGlyphCache *> m_glyphCaches;
 
     QSet<QFontEngine *> m_fontEnginesToClean;
@@ -27,6 +27,7 @@ QSGDefaultRenderContext::QSGDefaultRenderContext(QSGContext *context)
     , m_currentFrameRenderPass(nullptr)
     , m_useDepthBufferFor2D(true)
     , m_glyphCacheResourceUpdates(nullptr)
+    , m_preuploadResourceUpdates(nullptr)
 {
 }
 
@@ -121,6 +122,11 @@ void QSGDefaultRenderContext::invalidate()
 
     resetGlyphCacheResources();
 
+    if (m_preuploadResourceUpdates) {
+        m_preuploadResourceUpdates->release();
+        m_preuploadResourceUpdates = nullptr;
+    }
+
     m_rhi = nullptr;
 
     if (m_sg)
@@ -140,6 +146,13 @@ void QSGDefaultRenderContext::prepareSync(qreal devicePixelRatio,
     // an updatePaintNode() implementation that leads to needing it (for
     // example, an updateTexture() call on a QSGRhiLayer)
     m_currentFrameCommandBuffer = cb;
+
+    // Submit the uploads of the preuploaded textures before the sync can
+    // release any of them.
+    if (m_preuploadResourceUpdates && cb) {
+        cb->resourceUpdate(m_preuploadResourceUpdates);
+        m_preuploadResourceUpdates = nullptr;
+    }
 }
 
 void QSGDefaultRenderContext::beginNextFrame(QSGRenderer *renderer, const QSGRenderTarget &renderTarget,
@@ -164,6 +177,9 @@ void QSGDefaultRenderContext::endNextFrame(QSGRenderer *renderer)
     Q_UNUSED(renderer);
     m_currentFrameCommandBuffer = nullptr;
     m_currentFrameRenderPass = nullptr;
+
+    if (m_rhiAtlasManager)
+        m_rhiAtlasManager->releaseUnusedPages();
 }
 
 QSGTexture *QSGDefaultRenderContext::createTexture(const QImage &image, uint flags) const
@@ -190,6 +206,40 @@ QSGTexture *QSGDefaultRenderContext::createTexture(const QImage &image, uint fla
     return texture;
 }
 
+/*!
+    Creates the texture for \a factory from its \a image, and prepares its
+    upload, on the render thread between frames. The texture is then found by
+    textureForFactory() during the sync, which no longer has to create it,
+    and the upload is submitted at the start of the next sync.
+
+    Does nothing unless the factory was passed to schedulePreupload() and
+    still exists.
+ */
+void QSGDefaultRenderContext::preuploadTexture(QQuickTextureFactory *factory, const QImage &image)
+{
+    m_mutex.lock();
+    const bool wanted = m_texturesToPreupload.contains(factory) && !m_textures.contains(factory);
+    if (!wanted || !m_rhi)
+        m_texturesToPreupload.remove(factory);
+    m_mutex.unlock();
+    if (!wanted || !m_rhi)
+        return;
+
+    // The same texture as QQuickDefaultTextureFactory::createTexture() creates
+    QSGTexture *texture = createTexture(image, CreateTexture_Atlas | CreateTexture_Alpha);
+    if (!m_preuploadResourceUpdates)
+        m_preuploadResourceUpdates = m_rhi->nextResourceUpdateBatch();
+    texture->commitTextureOperations(m_rhi, m_preuploadResourceUpdates);
+
+    // The factory, which is never touched here, may have been destroyed
+    // on the GUI thread in the meantime.
+    QMutexLocker locker(&m_mutex);
+    if (m_texturesToPreupload.remove(factory))
+        m_textures.insert(factory, texture);
+    else
+        m_texturesToDelete << texture;
+}
+
 QSGRenderer *QSGDefaultRenderContext::createRenderer(QSGRendererInterface::RenderMode renderMode)
 {
     return new QSGBatchRenderer::Renderer(this, renderMode);
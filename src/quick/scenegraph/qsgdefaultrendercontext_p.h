@@ -72,12 +72,14 @@ public:
     QSGDistanceFieldGlyphCache *distanceFieldGlyphCache(const QRawFont &font, int renderTypeQuality) override;
 
     QSGTexture *createTexture(const QImage &image, uint flags) const override;
+    void preuploadTexture(QQuickTextureFactory *factory, const QImage &image);
     QSGRenderer *createRenderer(QSGRendererInterface::RenderMode renderMode = QSGRendererInterface::RenderMode2D) override;
     QSGTexture *compressedTextureForFactory(const QSGCompressedTextureFactory *factory) const override;
 
     virtual void initializeRhiShader(QSGMaterialShader *shader, QShader::Variant shaderVariant);
 
     int maxTextureSize() const override { return m_maxTextureSize; }
+    QSGRhiAtlasTexture::Manager *rhiAtlasManager() const { return m_rhiAtlasManager; }
     bool useDepthBufferFor2D() const { return m_useDepthBufferFor2D; }
     int msaaSampleCount() const { return m_initParams.sampleCount; }
 
@@ -119,6 +121,7 @@ protected:
     bool m_useDepthBufferFor2D;
     QRhiResourceUpdateBatch *m_glyphCacheResourceUpdates;
     QSet<QRhiTexture *> m_pendingGlyphCacheTextures;
+    QRhiResourceUpdateBatch *m_preuploadResourceUpdates;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,300 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qsgdistancefielddiskcache_p.h"
+#include "qsgcontext_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmath.h>
+#if QT_CONFIG(temporaryfile)
+#include <QtCore/qsavefile.h>
+#endif
+#include <QtGui/qpainterpath.h>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+    struct DiskCacheHeader
+    {
+        static constexpr char Magic[8] = { 'q', 's', 'g', 'd', 'f', 'c', 'h', '\0' };
+        static constexpr quint32 CurrentVersion = 2;
+
+        char magic[8];
+        quint32_le version;
+        // The generator lives in QtGui, so a different Qt version may produce different fields
+        quint32_le qtVersion;
+    };
+    static_assert(sizeof(DiskCacheHeader) == 16, "DiskCacheHeader structure needs to have the expected size");
+
+    // Records are appended to the file, each followed by width * height bytes of field data
+    struct DiskCacheGlyph
+    {
+        quint32_le glyph;
+        quint16_le width;
+        quint16_le height;
+        quint16_le checksum; // of the field data, to detect torn appends
+        quint16_le reserved;
+    };
+    static_assert(sizeof(DiskCacheGlyph) == 12, "DiskCacheGlyph structure needs to have the expected size");
+}
+
+enum { FlushThreshold = 256 * 1024 };
+
+static bool isCurrentHeader(const DiskCacheHeader &header)
+{
+    return memcmp(header.magic, DiskCacheHeader::Magic, sizeof(DiskCacheHeader::Magic)) == 0
+            && header.version == DiskCacheHeader::CurrentVersion
+            && header.qtVersion == quint32(QT_VERSION);
+}
+
+QSGDistanceFieldDiskCache::QSGDistanceFieldDiskCache(const QString &fileName, bool doubleGlyphResolution)
+    : m_fileName(fileName)
+    , m_doubleGlyphResolution(doubleGlyphResolution)
+{
+}
+
+QSGDistanceFieldDiskCache::~QSGDistanceFieldDiskCache()
+{
+    flush();
+}
+
+QString QSGDistanceFieldDiskCache::cacheDirectory()
+{
+    return qEnvironmentVariable("QSG_DISTANCEFIELD_CACHE_PATH");
+}
+
+/*!
+    \internal
+
+    Identifies the font file. The head table holds the checksum over the whole
+    file and its modification time, and the name table tells apart fonts that
+    differ only in their names. Returns an empty array for fonts without
+    these tables.
+*/
+QByteArray QSGDistanceFieldDiskCache::fontHash(const QRawFont &font)
+{
+    const QByteArray head = font.fontTable("head");
+    const QByteArray name = font.fontTable("name");
+    if (head.isEmpty() || name.isEmpty())
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(head);
+    hash.addData(name);
+    hash.addData(font.familyName().toUtf8());
+    hash.addData(font.styleName().toUtf8());
+    return hash.result().toHex();
+}
+
+std::unique_ptr<QSGDistanceFieldDiskCache> QSGDistanceFieldDiskCache::open(
+        const QRawFont &font, int renderTypeQuality, bool doubleGlyphResolution)
+{
+    const QString directory = cacheDirectory();
+    if (directory.isEmpty())
+        return nullptr;
+
+    const QByteArray hash = fontHash(font);
+    if (hash.isEmpty())
+        return nullptr;
+
+    if (!QDir().mkpath(directory)) {
+        qCWarning(QSG_LOG_INFO, "Cannot create distance field cache directory %s",
+                  qPrintable(directory));
+        return nullptr;
+    }
+
+    const QString fileName = QDir(directory).filePath(
+            QStringLiteral("%1-%2%3.qsgdfc").arg(QString::fromLatin1(hash))
+                                             .arg(renderTypeQuality)
+                                             .arg(doubleGlyphResolution ? QStringLiteral("-d") : QString()));
+
+    std::unique_ptr<QSGDistanceFieldDiskCache> cache(
+            new QSGDistanceFieldDiskCache(fileName, doubleGlyphResolution));
+    cache->load();
+    return cache;
+}
+
+void QSGDistanceFieldDiskCache::load()
+{
+    // Missing, outdated and damaged files are replaced by the next flush()
+    m_rewrite = true;
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QByteArray contents = file.readAll();
+    if (contents.size() < qsizetype(sizeof(DiskCacheHeader)))
+        return;
+
+    if (!isCurrentHeader(*reinterpret_cast<const DiskCacheHeader *>(contents.constData())))
+        return;
+
+    qsizetype offset = sizeof(DiskCacheHeader);
+    while (contents.size() - offset >= qsizetype(sizeof(DiskCacheGlyph))) {
+        const DiskCacheGlyph *record
+                = reinterpret_cast<const DiskCacheGlyph *>(contents.constData() + offset);
+        const qsizetype size = qsizetype(record->width) * record->height;
+        const qsizetype dataOffset = offset + qsizetype(sizeof(DiskCacheGlyph));
+        if (contents.size() - dataOffset < size)
+            return;
+
+        const QByteArrayView data(contents.constData() + dataOffset, size);
+        if (qChecksum(data) != record->checksum)
+            return;
+
+        Glyph &glyph = m_glyphs[record->glyph];
+        glyph.width = record->width;
+        glyph.height = record->height;
+        glyph.data = data.toByteArray();
+        offset = dataOffset + size;
+    }
+
+    // Appending after a torn record would make the following records unreadable
+    m_rewrite = offset != contents.size();
+}
+
+// The size QDistanceField gives the field of a path with these bounds. The
+// glyph cache allocates the same size for the glyph in its textures.
+static QSize distanceFieldSize(const QRectF &pathBoundingRect, bool doubleGlyphResolution)
+{
+    const qreal scale = QT_DISTANCEFIELD_SCALE(doubleGlyphResolution);
+    const qreal margin = QT_DISTANCEFIELD_RADIUS(doubleGlyphResolution) / scale;
+    return QSize(qCeil(pathBoundingRect.width() / scale + margin * 2),
+                 qCeil(pathBoundingRect.height() / scale + margin * 2));
+}
+
+/*!
+    \internal
+
+    Fills \a distanceField with the cached field of \a glyph. Returns \c false
+    if the size of the cached field does not match the size of a field for a
+    path spanning \a pathBoundingRect, for example because the glyph outlines
+    changed.
+
+    QDistanceField has no way to set the glyph of an empty field, so the field
+    is created from a path with the same bounds, and then overwritten. The
+    path consists of two points, so that nothing is rasterized.
+*/
+bool QSGDistanceFieldDiskCache::lookup(
+        glyph_t glyph, const QRectF &pathBoundingRect, QDistanceField *distanceField) const
+{
+    const auto it = m_glyphs.constFind(glyph);
+    if (it == m_glyphs.constEnd())
+        return false;
+
+    if (distanceFieldSize(pathBoundingRect, m_doubleGlyphResolution) != QSize(it->width, it->height))
+        return false;
+
+    QPainterPath bounds;
+    bounds.moveTo(pathBoundingRect.topLeft());
+    bounds.lineTo(pathBoundingRect.topLeft());
+    bounds.moveTo(pathBoundingRect.bottomRight());
+    bounds.lineTo(pathBoundingRect.bottomRight());
+    QDistanceField field(bounds, glyph, m_doubleGlyphResolution);
+    if (field.width() != it->width || field.height() != it->height)
+        return false;
+
+    memcpy(field.bits(), it->data.constData(), it->data.size());
+    *distanceField = field;
+    return true;
+}
+
+/*!
+    \internal
+
+    Adds the generated \a distanceFields to the cache. They are written to the file
+    by flush(), which happens once enough of them have been collected, and when the
+    cache is destroyed.
+*/
+void QSGDistanceFieldDiskCache::store(const QList<QDistanceField> &distanceFields)
+{
+    for (const QDistanceField &field : distanceFields) {
+        if (field.isNull() || m_glyphs.contains(field.glyph())
+                || field.width() > 0xffff || field.height() > 0xffff) {
+            continue;
+        }
+
+        Glyph &glyph = m_glyphs[field.glyph()];
+        glyph.width = field.width();
+        glyph.height = field.height();
+        glyph.data = QByteArray(reinterpret_cast<const char *>(field.constBits()),
+                                qsizetype(field.width()) * field.height());
+        m_pending.append(field.glyph());
+        m_pendingSize += sizeof(DiskCacheGlyph) + glyph.data.size();
+    }
+
+    if (m_pendingSize >= FlushThreshold)
+        flush();
+}
+
+static void appendRecord(QByteArray *contents, glyph_t glyph, int width, int height,
+                         const QByteArray &data)
+{
+    DiskCacheGlyph record;
+    record.glyph = glyph;
+    record.width = quint16(width);
+    record.height = quint16(height);
+    record.checksum = qChecksum(data);
+    record.reserved = 0;
+    contents->append(reinterpret_cast<const char *>(&record), sizeof(record));
+    contents->append(data);
+}
+
+/*!
+    \internal
+
+    Writes the glyphs stored since the last flush. They are appended to the file in
+    a single write, so that processes sharing the file keep each other's glyphs. A
+    file that is missing, outdated or damaged is replaced with all glyphs instead.
+*/
+void QSGDistanceFieldDiskCache::flush()
+{
+    if (m_pending.isEmpty())
+        return;
+
+    QByteArray contents;
+    if (m_rewrite) {
+        DiskCacheHeader header;
+        memcpy(header.magic, DiskCacheHeader::Magic, sizeof(DiskCacheHeader::Magic));
+        header.version = DiskCacheHeader::CurrentVersion;
+        header.qtVersion = quint32(QT_VERSION);
+        contents.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (auto it = m_glyphs.cbegin(), end = m_glyphs.cend(); it != end; ++it)
+            appendRecord(&contents, it.key(), it->width, it->height, it->data);
+    } else {
+        contents.reserve(m_pendingSize);
+        for (glyph_t glyph : std::as_const(m_pending)) {
+            const Glyph &g = m_glyphs[glyph];
+            appendRecord(&contents, glyph, g.width, g.height, g.data);
+        }
+    }
+    m_pending.clear();
+    m_pendingSize = 0;
+
+    if (m_rewrite) {
+        // Replaced once it is complete, so that readers never see a partial header
+#if QT_CONFIG(temporaryfile)
+        QSaveFile file(m_fileName);
+        if (file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size()
+                && file.commit()) {
+            m_rewrite = false;
+            return;
+        }
+#endif
+    } else {
+        QFile file(m_fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)
+                && file.write(contents) == contents.size()) {
+            return;
+        }
+    }
+    qCDebug(QSG_LOG_INFO, "Cannot write distance field cache %s", qPrintable(m_fileName));
+}
+
+QT_END_NAMESPACE
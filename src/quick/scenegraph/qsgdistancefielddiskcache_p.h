@@ -0,0 +1,79 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSGDISTANCEFIELDDISKCACHE_P_H
+#define QSGDISTANCEFIELDDISKCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/private/qtquickglobal_p.h>
+#include <QtGui/private/qdistancefield_p.h>
+#include <QtGui/qrawfont.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Keeps the distance fields generated for the glyphs of one font, at one
+    render type quality, in a file in the directory given by
+    QSG_DISTANCEFIELD_CACHE_PATH. The file is named after a hash of the font's
+    head and name tables, so it is shared by all processes using the same font
+    file. All glyphs are read when the file is opened. Newly generated glyphs are
+    collected in memory and appended to the file in batches, and when the cache
+    is destroyed.
+*/
+class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldDiskCache
+{
+    Q_DISABLE_COPY_MOVE(QSGDistanceFieldDiskCache)
+public:
+    ~QSGDistanceFieldDiskCache();
+
+    static std::unique_ptr<QSGDistanceFieldDiskCache> open(
+            const QRawFont &font, int renderTypeQuality, bool doubleGlyphResolution);
+
+    static QString cacheDirectory();
+    static QByteArray fontHash(const QRawFont &font);
+
+    QString fileName() const { return m_fileName; }
+    int size() const { return int(m_glyphs.size()); }
+    bool contains(glyph_t glyph) const { return m_glyphs.contains(glyph); }
+
+    bool lookup(glyph_t glyph, const QRectF &pathBoundingRect, QDistanceField *distanceField) const;
+    void store(const QList<QDistanceField> &distanceFields);
+    void flush();
+
+private:
+    struct Glyph
+    {
+        int width = 0;
+        int height = 0;
+        QByteArray data;
+    };
+
+    QSGDistanceFieldDiskCache(const QString &fileName, bool doubleGlyphResolution);
+    void load();
+
+    const QString m_fileName;
+    const bool m_doubleGlyphResolution;
+    QHash<glyph_t, Glyph> m_glyphs;
+    QList<glyph_t> m_pending; // stored, but not written yet
+    qsizetype m_pendingSize = 0;
+    bool m_rewrite = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSGDISTANCEFIELDDISKCACHE_P_H
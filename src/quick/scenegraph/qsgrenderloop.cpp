@@ -565,7 +565,9 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     QElapsedTimer renderTimer;
     qint64 renderTime = 0, syncTime = 0, polishTime = 0;
     const bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
-    if (profileFrames)
+    QQuickFrameTimings *frameTimings = cd->frameTimings.data();
+    const bool recordFrameTimings = frameTimings->isEnabled();
+    if (profileFrames || recordFrameTimings)
         renderTimer.start();
     Q_TRACE(QSG_polishItems_entry);
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishFrame);
@@ -574,7 +576,7 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     cd->polishItems();
     m_inPolish = false;
 
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         polishTime = renderTimer.nsecsElapsed();
 
     Q_TRACE(QSG_polishItems_exit);
@@ -641,7 +643,7 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     if (lastDirtyWindow)
         data.rc->endSync();
 
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         syncTime = renderTimer.nsecsElapsed();
 
     Q_TRACE(QSG_sync_exit);
@@ -651,7 +653,7 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
 
     cd->renderSceneGraph();
 
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         renderTime = renderTimer.nsecsElapsed();
     Q_TRACE(QSG_render_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -677,9 +679,18 @@ void QSGGuiThreadRenderLoop::renderWindow(QQuickWindow *window)
     emit window->afterFrameEnd();
 
     qint64 swapTime = 0;
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         swapTime = renderTimer.nsecsElapsed();
 
+    // The animations are advanced by the animation driver outside of this
+    // function, and are not measured.
+    if (recordFrameTimings) {
+        frameTimings->recordGuiThreadPhases(polishTime, 0);
+        frameTimings->addPhaseTime(QQuickFrameTimings::Sync, syncTime - polishTime);
+        frameTimings->addPhaseTime(QQuickFrameTimings::Present, swapTime - renderTime);
+        frameTimings->commitFrame();
+    }
+
     Q_TRACE(QSG_swap_exit);
     Q_QUICK_SG_PROFILE_END(QQuickProfiler::SceneGraphRenderLoopFrame,
                            QQuickProfiler::SceneGraphRenderLoopSwap);
@@ -29,6 +29,7 @@ class QSGContext;
 class QSGRenderContext;
 class QAnimationDriver;
 class QRunnable;
+class QQuickTextureFactory;
 
 class Q_QUICK_PRIVATE_EXPORT QSGRenderLoop : public QObject
 {
@@ -61,6 +62,7 @@ public:
 
     virtual void releaseResources(QQuickWindow *window) = 0;
     virtual void postJob(QQuickWindow *window, QRunnable *job);
+    virtual void preuploadTexture(QQuickWindow *, QQuickTextureFactory *) { }
 
     void addWindow(QQuickWindow *win) { m_windows.insert(win); }
     void removeWindow(QQuickWindow *win) { m_windows.remove(win); }
@@ -74,6 +76,10 @@ public:
 
     virtual bool interleaveIncubation() const { return false; }
 
+    // The time the GUI thread spent on the frame for which timeToIncubate()
+    // was emitted last, in nanoseconds, or -1 if it was not measured.
+    qint64 lastGuiFrameTime() const { return m_lastGuiFrameTime; }
+
     virtual int flags() const { return 0; }
 
     static void cleanup();
@@ -83,9 +89,14 @@ public:
 Q_SIGNALS:
     void timeToIncubate();
 
+protected:
+    void setLastGuiFrameTime(qint64 nsecs) { m_lastGuiFrameTime = nsecs; }
+
 private:
     static QSGRenderLoop *s_instance;
 
+    qint64 m_lastGuiFrameTime = -1;
+
     QSet<QQuickWindow *> m_windows;
 };
 
@@ -120,6 +131,10 @@ WM_PostJob           = QEvent::User + 6,
 // the event filter installed on the QQuickWindow.
 WM_ReleaseSwapchain  = QEvent::User + 7,
 
+// Passed by the RL to the RT when an image has been loaded for a window, so
+// that its texture can be uploaded before the next sync.
+WM_PreuploadTexture  = QEvent::User + 8,
+
 };
 
 QT_END_NAMESPACE
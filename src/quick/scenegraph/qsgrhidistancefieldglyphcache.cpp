@@ -4,6 +4,7 @@
 #include "qsgrhidistancefieldglyphcache_p.h"
 #include "qsgcontext_p.h"
 #include "qsgdefaultrendercontext_p.h"
+#include "qsgdistancefielddiskcache_p.h"
 #include <QtGui/private/qdistancefield_p.h>
 #include <QtCore/qelapsedtimer.h>
 #include <QtQml/private/qqmlglobal_p.h>
@@ -26,8 +27,15 @@ QSGRhiDistanceFieldGlyphCache::QSGRhiDistanceFieldGlyphCache(QSGDefaultRenderCon
     , m_rc(rc)
     , m_rhi(rc->rhi())
 {
-    // Load a pregenerated cache if the font contains one
-    loadPregeneratedCache(font);
+    // Load a pregenerated cache if the font contains one, otherwise the
+    // distance fields generated for this font before, if there is a disk cache
+    if (!loadPregeneratedCache(font)) {
+        m_diskCache = QSGDistanceFieldDiskCache::open(font, renderTypeQuality, m_doubleGlyphResolution);
+        if (m_diskCache) {
+            qCDebug(QSG_LOG_TIME_GLYPH, "distancefield: %d cached glyphs loaded from %s",
+                    m_diskCache->size(), qPrintable(m_diskCache->fileName()));
+        }
+    }
 }
 
 QSGRhiDistanceFieldGlyphCache::~QSGRhiDistanceFieldGlyphCache()
@@ -18,6 +18,7 @@
 #include <QtQuick/QQuickWindow>
 #include <private/qquickwindow_p.h>
 #include <private/qquickitem_p.h>
+#include <private/qquickpixmapcache_p.h>
 
 #include <QtQuick/private/qsgrenderer_p.h>
 
@@ -165,6 +166,15 @@ public:
         WMWindowEvent(c, QEvent::Type(WM_ReleaseSwapchain)) { }
 };
 
+class WMPreuploadTextureEvent : public WMWindowEvent
+{
+public:
+    WMPreuploadTextureEvent(QQuickWindow *c, QQuickTextureFactory *textureFactory, const QImage &textureImage)
+        : WMWindowEvent(c, QEvent::Type(WM_PreuploadTexture)), factory(textureFactory), image(textureImage) { }
+    QQuickTextureFactory *factory; // only a key, it lives and dies on the GUI thread
+    QImage image;
+};
+
 class QSGRenderThreadEventQueue : public QQueue<QEvent *>
 {
 public:
@@ -423,6 +433,16 @@ bool QSGRenderThread::event(QEvent *e)
         return true;
     }
 
+    case WM_PreuploadTexture: {
+        qCDebug(QSG_LOG_RENDERLOOP, QSG_RT_PAD, "WM_PreuploadTexture");
+        WMPreuploadTextureEvent *ce = static_cast<WMPreuploadTextureEvent *>(e);
+        // Without a QRhi this only forgets about the factory
+        if (rhi)
+            rhi->makeThreadLocalNativeContextCurrent();
+        sgrc->preuploadTexture(ce->factory, ce->image);
+        return true;
+    }
+
     case WM_ReleaseSwapchain: {
         qCDebug(QSG_LOG_RENDERLOOP, QSG_RT_PAD, "WM_ReleaseSwapchain");
         WMReleaseSwapchainEvent *ce = static_cast<WMReleaseSwapchainEvent *>(e);
@@ -585,9 +605,11 @@ void QSGRenderThread::handleDeviceLoss()
 void QSGRenderThread::syncAndRender()
 {
     const bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
+    QQuickFrameTimings *frameTimings = QQuickWindowPrivate::get(window)->frameTimings.data();
+    const bool recordFrameTimings = frameTimings->isEnabled();
     QElapsedTimer threadTimer;
     qint64 syncTime = 0, renderTime = 0;
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         threadTimer.start();
     Q_TRACE_SCOPE(QSG_syncAndRender);
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphRenderLoopFrame);
@@ -679,9 +701,11 @@ void QSGRenderThread::syncAndRender()
         sync(exposeRequested);
     }
 #ifndef QSG_NO_RENDER_TIMING
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         syncTime = threadTimer.nsecsElapsed();
 #endif
+    if (recordFrameTimings && syncRequested)
+        frameTimings->addPhaseTime(QQuickFrameTimings::Sync, syncTime);
     Q_TRACE(QSG_sync_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
                               QQuickProfiler::SceneGraphRenderLoopSync);
@@ -724,7 +748,7 @@ void QSGRenderThread::syncAndRender()
 
         d->renderSceneGraph();
 
-        if (profileFrames)
+        if (profileFrames || recordFrameTimings)
             renderTime = threadTimer.nsecsElapsed();
         Q_TRACE(QSG_render_exit);
         Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphRenderLoopFrame,
@@ -740,6 +764,10 @@ void QSGRenderThread::syncAndRender()
             if (frameResult == QRhi::FrameOpDeviceLost || frameResult == QRhi::FrameOpSwapChainOutOfDate)
                 QCoreApplication::postEvent(window, new QEvent(QEvent::Type(QQuickWindowPrivate::FullUpdateRequest)));
         }
+        if (recordFrameTimings) {
+            frameTimings->addPhaseTime(QQuickFrameTimings::Present, threadTimer.nsecsElapsed() - renderTime);
+            frameTimings->commitFrame();
+        }
         d->fireFrameSwapped();
     } else {
         Q_TRACE(QSG_render_exit);
@@ -1556,9 +1584,12 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
         }
     }
 
+    QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
     const bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled();
+    const bool recordFrameTimings = d->frameTimings->isEnabled();
+    // Always measured, the incubation controller budgets with it
+    timer.start();
     if (profileFrames) {
-        timer.start();
         qCDebug(QSG_LOG_TIME_RENDERLOOP, "[window %p][gui thread] polishAndSync: start, elapsed since last call: %d ms",
                 window,
                 int(elapsedSinceLastMs));
@@ -1566,12 +1597,11 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphPolishAndSync);
     Q_TRACE(QSG_polishItems_entry);
 
-    QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
     m_inPolish = true;
     d->polishItems();
     m_inPolish = false;
 
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         polishTime = timer.nsecsElapsed();
     Q_TRACE(QSG_polishItems_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphPolishAndSync,
@@ -1604,7 +1634,7 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     w->thread->mutex.unlock();
     qCDebug(QSG_LOG_RENDERLOOP, "- unlock after sync");
 
-    if (profileFrames)
+    if (profileFrames || recordFrameTimings)
         syncTime = timer.nsecsElapsed();
     Q_TRACE(QSG_sync_exit);
     Q_QUICK_SG_PROFILE_RECORD(QQuickProfiler::SceneGraphPolishAndSync,
@@ -1637,11 +1667,17 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
         // however). Sadly, there is nothing that can be done about it.
         postUpdateRequest(w);
 
+        setLastGuiFrameTime(timer.nsecsElapsed());
         emit timeToIncubate();
     } else if (w->updateDuringSync) {
         postUpdateRequest(w);
     }
 
+    // The render thread may already have completed the frame, so the
+    // animations count towards the next one.
+    if (recordFrameTimings)
+        d->frameTimings->recordGuiThreadPhases(polishTime, timer.nsecsElapsed() - syncTime);
+
     if (profileFrames) {
         qCDebug(QSG_LOG_TIME_RENDERLOOP, "[window %p][gui thread] Frame prepared, polish=%d ms, lock=%d ms, blockedForSync=%d ms, animations=%d ms",
                 window,
@@ -1666,6 +1702,7 @@ bool QSGThreadedRenderLoop::event(QEvent *e)
         if (te->timerId() == m_animation_timer) {
             qCDebug(QSG_LOG_RENDERLOOP, "- ticking non-render thread timer");
             m_animation_driver->advance();
+            setLastGuiFrameTime(-1);
             emit timeToIncubate();
             return true;
         }
@@ -1736,6 +1773,32 @@ void QSGThreadedRenderLoop::postJob(QQuickWindow *window, QRunnable *job)
         delete job;
 }
 
+/*
+ * Hands the image of a newly loaded texture factory to the render thread,
+ * which creates and uploads its texture while the GUI thread goes on, so
+ * that the sync only has to pick it up. Only the textures of plain images
+ * are created this way, as other factories may not be used off the GUI
+ * thread.
+ */
+void QSGThreadedRenderLoop::preuploadTexture(QQuickWindow *window, QQuickTextureFactory *factory)
+{
+    static const bool enabled = !qEnvironmentVariableIsSet("QSG_NO_TEXTURE_PREUPLOAD")
+            && !qEnvironmentVariableIsSet("QSG_TRANSIENT_IMAGES");
+    if (!enabled || !qobject_cast<QQuickDefaultTextureFactory *>(factory))
+        return;
+
+    const QImage image = factory->image();
+    if (image.isNull())
+        return;
+
+    Window *w = windowFor(window);
+    if (!w || !w->thread || !w->thread->window)
+        return;
+
+    w->thread->sgrc->schedulePreupload(factory);
+    w->thread->postEvent(new WMPreuploadTextureEvent(window, factory, image));
+}
+
 QT_END_NAMESPACE
 
 #include "qsgthreadedrenderloop.moc"
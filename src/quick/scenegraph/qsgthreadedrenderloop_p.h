@@ -54,6 +54,7 @@ public:
 
     bool event(QEvent *) override;
     void postJob(QQuickWindow *window, QRunnable *job) override;
+    void preuploadTexture(QQuickWindow *window, QQuickTextureFactory *factory) override;
 
     bool interleaveIncubation() const override;
 
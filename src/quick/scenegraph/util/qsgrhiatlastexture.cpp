@@ -9,6 +9,8 @@
 
 #include <QtGui/QWindow>
 
+#include <algorithm>
+
 #include <private/qqmlglobal_p.h>
 #include <private/qsgdefaultrendercontext_p.h>
 #include <private/qsgtexture_p.h>
@@ -50,23 +52,26 @@ Manager::Manager(QSGDefaultRenderContext *rc, const QSize &surfacePixelSize, QSu
 
     m_atlas_size_limit = qt_sg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
+    m_atlas_max_pages = qMax(1, qt_sg_envInt("QSG_ATLAS_MAX_PAGES", 4));
+    m_atlas_page_idle_frames = qt_sg_envInt("QSG_ATLAS_PAGE_IDLE_FRAMES", 120);
 
-    qCDebug(QSG_LOG_INFO, "rhi texture atlas dimensions: %dx%d", w, h);
+    qCDebug(QSG_LOG_INFO, "rhi texture atlas dimensions: %dx%d, up to %d pages",
+            w, h, m_atlas_max_pages);
 }
 
 Manager::~Manager()
 {
-    Q_ASSERT(m_atlas == nullptr);
+    Q_ASSERT(m_atlas_pages.isEmpty());
     Q_ASSERT(m_atlases.isEmpty());
 }
 
 void Manager::invalidate()
 {
-    if (m_atlas) {
-        m_atlas->invalidate();
-        m_atlas->deleteLater();
-        m_atlas = nullptr;
+    for (Atlas *page : std::as_const(m_atlas_pages)) {
+        page->invalidate();
+        page->deleteLater();
     }
+    m_atlas_pages.clear();
 
     QHash<unsigned int, QSGCompressedAtlasTexture::Atlas*>::iterator i = m_atlases.begin();
     while (i != m_atlases.end()) {
@@ -81,15 +86,57 @@ QSGTexture *Manager::create(const QImage &image, bool hasAlphaChannel)
 {
     Texture *t = nullptr;
     if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
-        if (!m_atlas)
-            m_atlas = new Atlas(m_rc, m_atlas_size);
-        t = m_atlas->create(image);
+        t = createInPages(image);
         if (t && !hasAlphaChannel && t->hasAlphaChannel())
             t->setHasAlphaChannel(false);
     }
     return t;
 }
 
+Texture *Manager::createInPages(const QImage &image)
+{
+    // Filling up the fullest page first leaves the others to drain as their
+    // images are released, so that they can be released as a whole. Images
+    // cannot be moved between pages, as their nodes keep the texture
+    // coordinates in their vertex data.
+    QVarLengthArray<Atlas *, 8> pages(m_atlas_pages.cbegin(), m_atlas_pages.cend());
+    std::stable_sort(pages.begin(), pages.end(), [](const Atlas *a, const Atlas *b) {
+        return a->usedArea() > b->usedArea();
+    });
+    for (Atlas *page : pages) {
+        if (Texture *t = page->create(image))
+            return t;
+    }
+
+    if (m_atlas_pages.size() >= m_atlas_max_pages)
+        return nullptr;
+
+    Atlas *page = new Atlas(m_rc, m_atlas_size);
+    m_atlas_pages.append(page);
+    qCDebug(QSG_LOG_INFO, "rhi texture atlas page %d created", int(m_atlas_pages.size()));
+    return page->create(image);
+}
+
+/*
+    Releases the pages, other than the first one, that have held no images
+    for a while. Called at the end of each frame.
+*/
+void Manager::releaseUnusedPages()
+{
+    for (qsizetype i = m_atlas_pages.size() - 1; i > 0; --i) {
+        Atlas *page = m_atlas_pages.at(i);
+        if (page->usedArea() > 0) {
+            page->m_unused_frames = 0;
+        } else if (++page->m_unused_frames > m_atlas_page_idle_frames) {
+            page->invalidate();
+            page->deleteLater();
+            m_atlas_pages.removeAt(i);
+            qCDebug(QSG_LOG_INFO, "rhi texture atlas page released, %d left",
+                    int(m_atlas_pages.size()));
+        }
+    }
+}
+
 QSGTexture *Manager::create(const QSGCompressedTextureFactory *factory)
 {
     QSGTexture *t = nullptr;
@@ -150,10 +197,19 @@ void AtlasBase::commitTextureOperations(QRhiResourceUpdateBatch *resourceUpdates
     m_pending_uploads.clear();
 }
 
+QRect AtlasBase::allocate(const QSize &size)
+{
+    const QRect rect = m_allocator.allocate(size);
+    if (rect.width() > 0 && rect.height() > 0)
+        m_used_area += qint64(rect.width()) * rect.height();
+    return rect;
+}
+
 void AtlasBase::remove(TextureBase *t)
 {
     QRect atlasRect = t->atlasSubRect();
-    m_allocator.deallocate(atlasRect);
+    if (m_allocator.deallocate(atlasRect))
+        m_used_area -= qint64(atlasRect.width()) * atlasRect.height();
     m_pending_uploads.removeOne(t);
 }
 
@@ -178,7 +234,7 @@ Atlas::~Atlas()
 Texture *Atlas::create(const QImage &image)
 {
     // No need to lock, as manager already locked it.
-    QRect rect = m_allocator.allocate(QSize(image.width() + 2, image.height() + 2));
+    QRect rect = allocate(QSize(image.width() + 2, image.height() + 2));
     if (rect.width() > 0 && rect.height() > 0) {
         Texture *t = new Texture(this, rect, image);
         m_pending_uploads << t;
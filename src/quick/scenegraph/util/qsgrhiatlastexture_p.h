@@ -37,7 +37,7 @@ class Texture;
 class TextureBase;
 class Atlas;
 
-class Manager : public QObject
+class Q_QUICK_PRIVATE_EXPORT Manager : public QObject
 {
     Q_OBJECT
 
@@ -48,11 +48,19 @@ public:
     QSGTexture *create(const QImage &image, bool hasAlphaChannel);
     QSGTexture *create(const QSGCompressedTextureFactory *factory);
     void invalidate();
+    void releaseUnusedPages();
+
+    int pageCount() const { return int(m_atlas_pages.size()); }
 
 private:
+    Texture *createInPages(const QImage &image);
+
     QSGDefaultRenderContext *m_rc;
     QRhi *m_rhi;
-    Atlas *m_atlas = nullptr;
+    // Pages of the RGBA atlas, in the order they were created
+    QList<Atlas *> m_atlas_pages;
+    int m_atlas_max_pages;
+    int m_atlas_page_idle_frames;
     // set of atlases for different compressed formats
     QHash<unsigned int, QSGCompressedAtlasTexture::Atlas*> m_atlases;
 
@@ -75,11 +83,14 @@ public:
     QRhi *rhi() const { return m_rhi; }
     QRhiTexture *texture() const { return m_texture; }
     QSize size() const { return m_size; }
+    qint64 usedArea() const { return m_used_area; }
 
 protected:
     virtual bool generateTexture() = 0;
     virtual void enqueueTextureUpload(TextureBase *t, QRhiResourceUpdateBatch *resourceUpdates) = 0;
 
+    QRect allocate(const QSize &size);
+
 protected:
     QSGDefaultRenderContext *m_rc;
     QRhi *m_rhi;
@@ -87,6 +98,9 @@ protected:
     QRhiTexture *m_texture = nullptr;
     QSize m_size;
     QVector<TextureBase *> m_pending_uploads;
+    qint64 m_used_area = 0;
+    int m_unused_frames = 0;
+    friend class Manager;
     friend class TextureBase;
     friend class TextureBasePrivate;
 
@@ -306,6 +306,10 @@ void tst_QQmlProfilerService::checkJsHeap()
             used += amount;
             seen_large = true;
             break;
+        case GCMarkStep:
+        case GCSweepStep:
+            QVERIFY(amount >= 0);
+            break;
         }
 
         QVERIFY(message.timestamp() >= lastTimestamp);
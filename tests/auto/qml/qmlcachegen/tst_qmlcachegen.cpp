@@ -13,6 +13,8 @@
 #include <private/qqmlcomponent_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <private/qv4compileddata_p.h>
+#include <private/qv4compilationunitbundle_p.h>
+#include <private/qqmlmetatype_p.h>
 #include <qtranslator.h>
 #include <qqmlscriptstring.h>
 #include <QString>
@@ -37,6 +39,7 @@ private slots:
     void signalHandlerParameters();
     void errorOnArgumentsInSignalHandler();
     void aheadOfTimeCompilation();
+    void compilationUnitBundle();
     void functionExpressions();
     void versionChecksForAheadOfTimeUnits();
     void retainedResources();
@@ -420,6 +423,100 @@ void tst_qmlcachegen::aheadOfTimeCompilation()
     QCOMPARE(result.toInt(), 42);
 }
 
+void tst_qmlcachegen::compilationUnitBundle()
+{
+#if defined(QTEST_CROSS_COMPILED)
+    QSKIP("Cannot call qmlcachegen on cross-compiled target.");
+#endif
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const auto writeTempFile = [&tempDir](const QString &fileName, const char *contents) {
+        QFile f(tempDir.path() + '/' + fileName);
+        const bool ok = f.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        Q_ASSERT(ok);
+        f.write(contents);
+        return f.fileName();
+    };
+
+    QStringList arguments;
+    const QString bundlePath = tempDir.filePath("app.qmlcbundle");
+    arguments << QStringLiteral("-o") << bundlePath;
+    arguments << writeTempFile("main.qml", "import QtQml\n"
+                                           "import \"util.js\" as Util\n"
+                                           "QtObject {\n"
+                                           "    property int value: Util.value() + other.value\n"
+                                           "    property QtObject other: Other {}\n"
+                                           "}");
+    arguments << writeTempFile("util.js", "function value() { return 40; }");
+    for (int i = 0; i < 20; ++i) {
+        arguments << writeTempFile(
+                QStringLiteral("Filler%1.qml").arg(i).toUtf8().constData(),
+                "import QtQml\nQtObject {}");
+    }
+    arguments << writeTempFile("Other.qml", "import QtQml\nQtObject { property int value: 2 }");
+
+    QProcess proc;
+    proc.setProcessChannelMode(QProcess::ForwardedChannels);
+    proc.setProgram(QLibraryInfo::path(QLibraryInfo::LibraryExecutablesPath)
+                    + QLatin1String("/qmlcachegen"));
+    proc.setArguments(arguments);
+    proc.start();
+    QVERIFY(proc.waitForFinished());
+    QCOMPARE(proc.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(proc.exitCode(), 0);
+
+    QString errorString;
+    const auto bundle = QV4::CompilationUnitBundle::open(bundlePath, &errorString);
+    QVERIFY2(bundle, qPrintable(errorString));
+    QCOMPARE(bundle->size(), 23);
+    for (const QString &file : arguments.mid(2)) {
+        const QUrl url = QUrl::fromLocalFile(file);
+        QVERIFY2(bundle->find(url), qPrintable(url.toString()));
+    }
+    QVERIFY(!bundle->find(QUrl::fromLocalFile(tempDir.filePath("missing.qml"))));
+
+    const QUrl mainUrl = QUrl::fromLocalFile(arguments.at(2));
+    const QUrl otherUrl = QUrl::fromLocalFile(arguments.last());
+    QDateTime sourceTimeStamp;
+    const QQmlPrivate::CachedQmlUnit *otherUnit = bundle->find(otherUrl, &sourceTimeStamp);
+    QVERIFY(otherUnit);
+    QCOMPARE(sourceTimeStamp, QFileInfo(arguments.last()).lastModified());
+    QCOMPARE(sourceTimeStamp.toMSecsSinceEpoch(), otherUnit->qmlData->sourceTimeStamp);
+
+    // An edited source file must not be shadowed by the outdated unit in the bundle.
+    // The sources are checked when the bundle is opened.
+    writeTempFile("Other.qml", "import QtQml\nQtObject { property int value: 3 }");
+    {
+        QFile other(arguments.last());
+        QVERIFY(other.open(QIODevice::ReadWrite));
+        QVERIFY(other.setFileTime(other.fileTime(QFileDevice::FileModificationTime).addSecs(10),
+                                  QFileDevice::FileModificationTime));
+    }
+    QVERIFY(bundle->find(otherUrl, &sourceTimeStamp));
+    QCOMPARE(sourceTimeStamp.toMSecsSinceEpoch(), otherUnit->qmlData->sourceTimeStamp);
+
+    QVERIFY2(QQmlMetaType::addCompilationUnitBundle(bundlePath, &errorString),
+             qPrintable(errorString));
+
+    QQmlMetaType::CachedUnitLookupError lookupError
+            = QQmlMetaType::CachedUnitLookupError::NoUnitFound;
+    QVERIFY(QQmlMetaType::findCachedCompilationUnit(
+            mainUrl, QQmlMetaType::AcceptUntyped, &lookupError));
+    QCOMPARE(lookupError, QQmlMetaType::CachedUnitLookupError::NoError);
+    QVERIFY(!QQmlMetaType::findCachedCompilationUnit(
+            otherUrl, QQmlMetaType::AcceptUntyped, &lookupError));
+    QCOMPARE(lookupError, QQmlMetaType::CachedUnitLookupError::VersionMismatch);
+
+    QQmlEngine engine;
+    CleanlyLoadingComponent component(&engine, mainUrl);
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QObject> obj(component.create());
+    QVERIFY(!obj.isNull());
+    QCOMPARE(obj->property("value").toInt(), 43);
+}
+
 static QQmlPrivate::CachedQmlUnit *temporaryModifiedCachedUnit = nullptr;
 
 static const char *versionCheckErrorString(QQmlMetaType::CachedUnitLookupError error)
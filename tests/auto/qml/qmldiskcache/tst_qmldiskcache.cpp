@@ -41,6 +41,8 @@ private slots:
     void cacheModuleScripts();
     void reuseStaticMappings();
     void invalidateSaveLoadCache();
+    void jitProfileFormat();
+    void jitProfileSaveAndLoad();
 
     void inlineComponentDoesNotCauseConstantInvalidation_data();
     void inlineComponentDoesNotCauseConstantInvalidation();
@@ -1120,6 +1122,168 @@ void tst_qmldiskcache::invalidateSaveLoadCache()
     QVERIFY(unit->unitData() != oldUnit->unitData());
 }
 
+void tst_qmldiskcache::jitProfileFormat()
+{
+    using QV4::ExecutableCompilationUnit;
+
+    QTemporaryDir tempDir;
+    const QString path = tempDir.filePath(QLatin1String("test.qmlc.jitprofile"));
+    const char checksum[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    char otherChecksum[16];
+    memcpy(otherChecksum, checksum, sizeof(checksum));
+    otherChecksum[15] = 0;
+
+    QList<quint32> indices;
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+
+    const QList<quint32> written = { 0, 2, 5 };
+    QVERIFY(ExecutableCompilationUnit::writeJitProfile(path, checksum, written));
+    QVERIFY(ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+    QCOMPARE(indices, written);
+
+    // Profiles of a different unit, or of a unit with fewer functions, are rejected
+    indices.clear();
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, otherChecksum, 6, &indices));
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 5, &indices));
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 2, &indices));
+    QVERIFY(indices.isEmpty());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+    file.close();
+
+    const auto rewrite = [&](const QByteArray &data) {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                && file.write(data) == data.size();
+    };
+
+    // Truncated in the header, or in the list of functions
+    QVERIFY(rewrite(contents.left(10)));
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+    QVERIFY(rewrite(contents.chopped(2)));
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+
+    // Wrong magic, and wrong version
+    QByteArray corrupted = contents;
+    corrupted[0] = corrupted[0] ^ 0xff;
+    QVERIFY(rewrite(corrupted));
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+    corrupted = contents;
+    corrupted[4] = corrupted[4] + 1;
+    QVERIFY(rewrite(corrupted));
+    QVERIFY(!ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+    QVERIFY(indices.isEmpty());
+
+    QVERIFY(rewrite(contents));
+    QVERIFY(ExecutableCompilationUnit::readJitProfile(path, checksum, 6, &indices));
+    QCOMPARE(indices, written);
+}
+
+void tst_qmldiskcache::jitProfileSaveAndLoad()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = writeTempFile(
+                tempDir, QLatin1String("jit.qml"),
+                "import QtQml\n"
+                "QtObject {\n"
+                "    function hot(x) { return x + 1 }\n"
+                "    function cold(x) { return x - 1 }\n"
+                "    function listed(x) { return x * 2 }\n"
+                "}\n");
+    const QUrl url = QUrl::fromLocalFile(fileName);
+
+    const auto functionIndex = [](QV4::ExecutableCompilationUnit *unit, const QString &name) {
+        for (int i = 0; i < unit->runtimeFunctions.size(); ++i) {
+            if (unit->runtimeFunctions[i]->name()->toQString() == name)
+                return quint32(i);
+        }
+        return quint32(-1);
+    };
+
+    quint32 hot = 0;
+    quint32 cold = 0;
+    quint32 listed = 0;
+    {
+        QQmlEngine engine;
+        if (!engine.handle()->canJIT())
+            QSKIP("The JIT is not available");
+
+        QQmlComponent component(&engine, url);
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY2(object, qPrintable(component.errorString()));
+        QV4::ExecutableCompilationUnit *unit
+                = QQmlComponentPrivate::get(&component)->compilationUnit.data();
+        hot = functionIndex(unit, QLatin1String("hot"));
+        cold = functionIndex(unit, QLatin1String("cold"));
+        listed = functionIndex(unit, QLatin1String("listed"));
+        QVERIFY(hot < quint32(unit->runtimeFunctions.size()));
+        QVERIFY(cold < quint32(unit->runtimeFunctions.size()));
+        QVERIFY(listed < quint32(unit->runtimeFunctions.size()));
+
+        // As if loaded from an earlier run
+        unit->jitProfile = { listed };
+
+        for (int i = 0; i < 10; ++i)
+            QVERIFY(QMetaObject::invokeMethod(object.data(), "hot", Q_ARG(QVariant, i)));
+        QVERIFY(unit->runtimeFunctions[hot]->codeRef);
+        QVERIFY(!unit->runtimeFunctions[cold]->codeRef);
+
+        // The functions compiled in this run are merged with the loaded ones
+        unit->saveJitProfile();
+        QList<quint32> indices;
+        QVERIFY(QV4::ExecutableCompilationUnit::readJitProfile(
+                    QV4::ExecutableCompilationUnit::jitProfileFilePath(url),
+                    unit->unitData()->md5Checksum, quint32(unit->runtimeFunctions.size()),
+                    &indices));
+        QVERIFY(indices.contains(hot));
+        QVERIFY(indices.contains(listed));
+        QVERIFY(!indices.contains(cold));
+    }
+
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, url);
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY2(object, qPrintable(component.errorString()));
+        QV4::ExecutableCompilationUnit *unit
+                = QQmlComponentPrivate::get(&component)->compilationUnit.data();
+        QV4::ExecutionEngine *v4 = engine.handle();
+        QVERIFY(!v4->canJIT(unit->runtimeFunctions[hot]));
+
+        // The listed functions are compiled on their first call
+        unit->loadJitProfile();
+        QVERIFY(v4->canJIT(unit->runtimeFunctions[hot]));
+        QVERIFY(v4->canJIT(unit->runtimeFunctions[listed]));
+        QVERIFY(!v4->canJIT(unit->runtimeFunctions[cold]));
+    }
+
+    // A profile for a different version of the document is not used
+    QFile::remove(fileName);
+    writeTempFile(tempDir, QLatin1String("jit.qml"),
+                  "import QtQml\n"
+                  "QtObject {\n"
+                  "    property int added: 1\n"
+                  "    function hot(x) { return x + 1 }\n"
+                  "    function cold(x) { return x - 1 }\n"
+                  "    function listed(x) { return x * 2 }\n"
+                  "}\n");
+    waitForFileSystem();
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, url);
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY2(object, qPrintable(component.errorString()));
+        QV4::ExecutableCompilationUnit *unit
+                = QQmlComponentPrivate::get(&component)->compilationUnit.data();
+        unit->loadJitProfile();
+        QVERIFY(unit->jitProfile.isEmpty());
+        QVERIFY(!engine.handle()->canJIT(
+                    unit->runtimeFunctions[functionIndex(unit, QLatin1String("hot"))]));
+    }
+}
+
 void tst_qmldiskcache::inlineComponentDoesNotCauseConstantInvalidation_data()
 {
     QTest::addColumn<QByteArray>("code");
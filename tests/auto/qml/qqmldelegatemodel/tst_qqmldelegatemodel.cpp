@@ -7,6 +7,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtQml/qqmlapplicationengine.h>
 #include <QtQmlModels/private/qqmldelegatemodel_p.h>
+#include <QtQml/private/qqmlincubator_p.h>
 #include <QtQuick/qquickview.h>
 #include <QtQuick/qquickitem.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
@@ -30,6 +31,7 @@ private slots:
     void nestedDelegates();
     void universalModelData();
     void deleteRace();
+    void incubationPriority();
 };
 
 class AbstractItemModel : public QAbstractItemModel
@@ -371,6 +373,52 @@ void tst_QQmlDelegateModel::deleteRace()
     QTRY_COMPARE(o->property("count").toInt(), 0);
 }
 
+void tst_QQmlDelegateModel::incubationPriority()
+{
+    QQmlEngine engine;
+    QQmlIncubationController controller;
+    engine.setIncubationController(&controller);
+    QQmlComponent component(&engine, testFileUrl("integerModel.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QQmlDelegateModel *model = qobject_cast<QQmlDelegateModel *>(root.data());
+    QVERIFY(model);
+
+    const auto incubateWhileLoading = [&](int index) {
+        while (model->incubationStatus(index) == QQmlIncubator::Loading) {
+            std::atomic<bool> b{false};
+            controller.incubateWhile(&b);
+        }
+    };
+
+    // An asynchronous request, as made by an asynchronous Instantiator, is not
+    // held up by the buffer of a view requested after it
+    QVERIFY(!model->object(0, QQmlIncubator::Asynchronous));
+    QVERIFY(!model->prioritizedObject(1, QQmlIncubator::Asynchronous,
+                                      QQmlIncubatorPrivate::SpeculativePriority));
+    QCOMPARE(model->incubationStatus(0), QQmlIncubator::Loading);
+    QCOMPARE(model->incubationStatus(1), QQmlIncubator::Loading);
+    incubateWhileLoading(0);
+    QCOMPARE(model->incubationStatus(0), QQmlIncubator::Ready);
+    QCOMPARE(model->incubationStatus(1), QQmlIncubator::Loading);
+
+    // An item of the buffer that is requested again with a normal priority
+    // is raised to that priority, ahead of the buffer items requested later
+    QVERIFY(!model->prioritizedObject(2, QQmlIncubator::Asynchronous,
+                                      QQmlIncubatorPrivate::SpeculativePriority));
+    QVERIFY(!model->prioritizedObject(3, QQmlIncubator::Asynchronous,
+                                      QQmlIncubatorPrivate::SpeculativePriority));
+    QVERIFY(!model->object(2, QQmlIncubator::Asynchronous));
+    incubateWhileLoading(2);
+    QCOMPARE(model->incubationStatus(2), QQmlIncubator::Ready);
+    QCOMPARE(model->incubationStatus(1), QQmlIncubator::Loading);
+    QCOMPARE(model->incubationStatus(3), QQmlIncubator::Loading);
+
+    incubateWhileLoading(1);
+    incubateWhileLoading(3);
+    QCOMPARE(model->incubationStatus(1), QQmlIncubator::Ready);
+    QCOMPARE(model->incubationStatus(3), QQmlIncubator::Ready);
+}
+
 QTEST_MAIN(tst_QQmlDelegateModel)
 
 #include "tst_qqmldelegatemodel.moc"
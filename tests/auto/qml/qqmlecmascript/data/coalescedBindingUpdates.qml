@@ -0,0 +1,13 @@
+import QtQml
+
+QtObject {
+    property int source: 0
+    property int doubled: source * 2
+    property int squared: source * source
+
+    // Depends on source both directly and through doubled
+    property int mixed: { evaluations.mixed++; return source + doubled }
+    property int sum: { evaluations.sum++; return doubled + squared }
+
+    property var evaluations: ({ mixed: 0, sum: 0 })
+}
@@ -0,0 +1,8 @@
+import QtQml
+
+QtObject {
+    id: root
+    property int source: 0
+    property int value: source + 1
+    property QtObject target: QtObject { property int value: root.source * 3 }
+}
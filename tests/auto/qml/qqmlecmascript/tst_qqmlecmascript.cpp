@@ -79,6 +79,8 @@ private slots:
     void contextPropertiesTriggerReeval();
     void objectPropertiesTriggerReeval();
     void dependenciesWithFunctions();
+    void coalescedBindingUpdates();
+    void coalescedBindingUpdatesDeletedTarget();
     void immediateProperties();
     void deferredProperties();
     void deferredPropertiesParent();
@@ -1206,6 +1208,70 @@ void tst_qqmlecmascript::dependenciesWithFunctions()
     QVERIFY(object->property("success").toBool());
 }
 
+void tst_qqmlecmascript::coalescedBindingUpdates()
+{
+    QQmlEngine engine;
+    QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(&engine);
+    enginePrivate->setCoalesceBindingUpdates(true);
+    QQmlComponent component(&engine, testFileUrl("coalescedBindingUpdates.qml"));
+
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY2(object, qPrintable(component.errorString()));
+    enginePrivate->flushBindingUpdates();
+
+    const auto evaluations = [&](const char *name) {
+        return object->property("evaluations").value<QJSValue>().property(name).toInt();
+    };
+    const int mixedEvaluations = evaluations("mixed");
+    const int sumEvaluations = evaluations("sum");
+
+    // The bindings are updated once control returns to the event loop, each
+    // of them once, and after the bindings they depend on
+    object->setProperty("source", 3);
+    QCOMPARE(object->property("sum").toInt(), 0);
+    QTRY_COMPARE(object->property("sum").toInt(), 15);
+    QCOMPARE(object->property("mixed").toInt(), 9);
+    QCOMPARE(evaluations("mixed"), mixedEvaluations + 1);
+    QCOMPARE(evaluations("sum"), sumEvaluations + 1);
+
+    // Flushing updates the queued bindings right away
+    object->setProperty("source", 4);
+    enginePrivate->flushBindingUpdates();
+    QCOMPARE(object->property("sum").toInt(), 24);
+    QCOMPARE(object->property("mixed").toInt(), 12);
+    QCOMPARE(evaluations("mixed"), mixedEvaluations + 2);
+    QCOMPARE(evaluations("sum"), sumEvaluations + 2);
+}
+
+void tst_qqmlecmascript::coalescedBindingUpdatesDeletedTarget()
+{
+    QQmlEngine engine;
+    QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(&engine);
+    enginePrivate->setCoalesceBindingUpdates(true);
+    QQmlComponent component(&engine, testFileUrl("coalescedBindingUpdatesDeletedTarget.qml"));
+
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY2(object, qPrintable(component.errorString()));
+    enginePrivate->flushBindingUpdates();
+
+    QPointer<QObject> target = object->property("target").value<QObject *>();
+    QVERIFY(target);
+    QCOMPARE(target->property("value").toInt(), 0);
+
+    // Deleting the target of a queued binding drops its update
+    object->setProperty("source", 2);
+    QCOMPARE(enginePrivate->pendingBindingUpdates.size(), 2);
+    delete target.data();
+    QVERIFY(!target);
+    enginePrivate->flushBindingUpdates();
+    QVERIFY(enginePrivate->pendingBindingUpdates.isEmpty());
+    QCOMPARE(object->property("value").toInt(), 3);
+
+    // The queued update posted to the event loop finds nothing left to do
+    QCoreApplication::processEvents();
+    QCOMPARE(object->property("value").toInt(), 3);
+}
+
 void tst_qqmlecmascript::immediateProperties()
 {
     QQmlEngine engine;
@@ -32,6 +32,7 @@ private slots:
     void clear();
     void noIncubationController();
     void forceCompletion();
+    void priority();
     void setInitialState();
     void clearDuringCompletion();
     void objectDeletionAfterInit();
@@ -333,6 +334,46 @@ void tst_qqmlincubator::forceCompletion()
     }
 }
 
+void tst_qqmlincubator::priority()
+{
+    QQmlComponent component(&engine, testFileUrl("forceCompletion.qml"));
+    QVERIFY(component.isReady());
+
+    // Of incubators with the same priority, the one created last goes first
+    QQmlIncubator normal;
+    component.create(normal);
+    QVERIFY(normal.isLoading());
+
+    QQmlIncubator promoted;
+    QQmlIncubatorPrivate::get(&promoted)->setPriority(QQmlIncubatorPrivate::SpeculativePriority);
+    component.create(promoted);
+    QVERIFY(promoted.isLoading());
+
+    QQmlIncubator speculative;
+    QQmlIncubatorPrivate::get(&speculative)->setPriority(QQmlIncubatorPrivate::SpeculativePriority);
+    component.create(speculative);
+    QVERIFY(speculative.isLoading());
+
+    // Raising the priority of a queued incubator moves it ahead of the speculative ones
+    QQmlIncubatorPrivate::get(&promoted)->setPriority(QQmlIncubatorPrivate::NormalPriority);
+
+    while (normal.isLoading() || promoted.isLoading()) {
+        std::atomic<bool> b{false};
+        controller.incubateWhile(&b);
+    }
+
+    QVERIFY(normal.isReady());
+    QVERIFY(promoted.isReady());
+    QVERIFY(speculative.isLoading());
+
+    speculative.forceCompletion();
+    QVERIFY(speculative.isReady());
+
+    delete normal.object();
+    delete promoted.object();
+    delete speculative.object();
+}
+
 void tst_qqmlincubator::setInitialState()
 {
     QQmlComponent component(&engine, testFileUrl("setInitialState.qml"));
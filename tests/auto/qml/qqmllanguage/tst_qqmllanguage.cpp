@@ -35,6 +35,7 @@
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QtQuickTestUtils/private/testhttpserver_p.h>
 
+#include <algorithm>
 #include <deque>
 
 #if defined(Q_OS_MAC)
@@ -409,6 +410,7 @@ private slots:
     void asValueType();
 
     void longConversion();
+    void convertedLiteralsAreCached();
 
 private:
     QQmlEngine engine;
@@ -7924,6 +7926,53 @@ void tst_qqmllanguage::asValueType()
     QCOMPARE(point.y(), 20.0);
 }
 
+void tst_qqmllanguage::convertedLiteralsAreCached()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("assignValueTypes.qml"));
+    VERIFY_ERRORS(0);
+
+    QScopedPointer<MyTypeObject> first(qobject_cast<MyTypeObject *>(component.create()));
+    QVERIFY(first);
+
+    auto compilationUnit = QQmlComponentPrivate::get(&component)->compilationUnit;
+    QVERIFY(compilationUnit);
+    const auto &literals = compilationUnit->convertedLiterals;
+
+    const QUrl url = QUrl::fromEncoded("main.qml?with%3cencoded%3edata", QUrl::TolerantMode);
+    const auto isCached = [&](const QVariant &value) {
+        return std::find(literals.cbegin(), literals.cend(), value) != literals.cend();
+    };
+    QVERIFY(isCached(QVariant(QColor("red"))));
+    QVERIFY(isCached(QVariant(QDate(1982, 11, 25))));
+    QVERIFY(isCached(QVariant(QPoint(99, 13))));
+    if (!QQmlPropertyPrivate::resolveUrlsOnAssignment())
+        QVERIFY(isCached(QVariant(url)));
+
+    // The second object gets the same values, without converting them again
+    const qsizetype cachedCount = literals.size();
+    QScopedPointer<MyTypeObject> second(qobject_cast<MyTypeObject *>(component.create()));
+    QVERIFY(second);
+    QCOMPARE(literals.size(), cachedCount);
+    QCOMPARE(second->colorProperty(), first->colorProperty());
+    QCOMPARE(second->dateProperty(), first->dateProperty());
+    QCOMPARE(second->pointProperty(), first->pointProperty());
+    QCOMPARE(second->urlProperty(), first->urlProperty());
+    QCOMPARE(second->colorProperty(), QColor("red"));
+    QCOMPARE(second->dateProperty(), QDate(1982, 11, 25));
+    QCOMPARE(second->pointProperty(), QPoint(99, 13));
+
+    // The values really come from the cache
+    for (auto it = compilationUnit->convertedLiterals.begin();
+         it != compilationUnit->convertedLiterals.end(); ++it) {
+        if (it.value() == QVariant(QColor("red")))
+            it.value() = QVariant(QColor("blue"));
+    }
+    QScopedPointer<MyTypeObject> third(qobject_cast<MyTypeObject *>(component.create()));
+    QVERIFY(third);
+    QCOMPARE(third->colorProperty(), QColor("blue"));
+}
+
 QTEST_MAIN(tst_qqmllanguage)
 
 #include "tst_qqmllanguage.moc"
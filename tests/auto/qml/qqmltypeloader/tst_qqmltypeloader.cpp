@@ -47,6 +47,8 @@ private slots:
     void circularDependency();
     void declarativeCppAndQmlDir();
     void signalHandlersAreCompatible();
+    void parallelParse();
+    void startupProfile();
 
 private:
     void checkSingleton(const QString & dataDirectory);
@@ -724,6 +726,136 @@ void tst_QQMLTypeLoader::signalHandlersAreCompatible()
     QVERIFY(unitFromCachegen->url() != unitFromTypeCompiler->url());
 }
 
+void tst_QQMLTypeLoader::parallelParse()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const auto writeFile = [&](const QString &name, const QByteArray &contents) {
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+    };
+
+    QByteArray main = "import QtQml\nimport \"util.js\" as Util\nQtObject {\n";
+    QByteArray sum = "0";
+    for (int i = 0; i < 8; ++i) {
+        writeFile(QStringLiteral("Dep%1.qml").arg(i),
+                  "import QtQml\nQtObject { property int value: " + QByteArray::number(i) + " }\n");
+        main += "    property QtObject dep" + QByteArray::number(i) + ": Dep"
+                + QByteArray::number(i) + " {}\n";
+        sum += " + dep" + QByteArray::number(i) + ".value";
+    }
+    main += "    property int sum: Util.twice(" + sum + ")\n}\n";
+    writeFile(QStringLiteral("Main.qml"), main);
+    writeFile(QStringLiteral("util.js"), "function twice(x) { return 2 * x; }\n");
+    writeFile(QStringLiteral("Broken.qml"), "import QtQml\nQtObject {\n    property int : 5\n}\n");
+    writeFile(QStringLiteral("UsesBroken.qml"), "import QtQml\nQtObject { property QtObject b: Broken {} }\n");
+
+    qputenv("QML_TYPELOADER_PARSE_THREADS", "2");
+    QQmlEngine engine;
+    qunsetenv("QML_TYPELOADER_PARSE_THREADS");
+    QVERIFY(QQmlEnginePrivate::get(&engine)->typeLoader.canPrefetch());
+
+    QQmlComponent component(&engine, QUrl::fromLocalFile(dir.filePath(QStringLiteral("Main.qml"))));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY(root);
+    QCOMPARE(root->property("sum").toInt(), 56);
+
+    // Errors in prefetched documents are still reported with their location
+    QQmlComponent broken(&engine, QUrl::fromLocalFile(dir.filePath(QStringLiteral("UsesBroken.qml"))));
+    QVERIFY(broken.isError());
+    const QList<QQmlError> errors = broken.errors();
+    QVERIFY(std::any_of(errors.begin(), errors.end(), [](const QQmlError &error) {
+        return error.url().fileName() == QLatin1String("Broken.qml") && error.line() == 3;
+    }));
+}
+
+void tst_QQMLTypeLoader::startupProfile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const auto writeFile = [&](const QString &name, const QByteArray &contents) {
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+    };
+    writeFile(QStringLiteral("Main.qml"),
+              "import QtQml\nimport \"util.js\" as Util\n"
+              "QtObject { property QtObject dep: Dep {}\n property int value: Util.value() }\n");
+    writeFile(QStringLiteral("Dep.qml"), "import QtQml\nQtObject {}\n");
+    writeFile(QStringLiteral("util.js"), "function value() { return 5; }\n");
+    writeFile(QStringLiteral("Other.qml"), "import QtQml\nQtObject {}\n");
+
+    const QString profilePath = dir.filePath(QStringLiteral("startup.profile"));
+    const QUrl mainUrl = QUrl::fromLocalFile(dir.filePath(QStringLiteral("Main.qml")));
+    qputenv("QML_STARTUP_PROFILE", profilePath.toLocal8Bit());
+    const auto cleanup = qScopeGuard([]() { qunsetenv("QML_STARTUP_PROFILE"); });
+
+    const QUrl otherUrl = QUrl::fromLocalFile(dir.filePath(QStringLiteral("Other.qml")));
+
+    // Without a profile file, the first run records one. Engines alive at the same
+    // time share it, and it is written when the last one is destroyed.
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, mainUrl);
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        QScopedPointer<QObject> root(component.create());
+        QVERIFY(root);
+
+        {
+            QQmlEngine otherEngine;
+            QCOMPARE(QQmlEnginePrivate::get(&otherEngine)->typeLoader.startupProfile(),
+                     QQmlEnginePrivate::get(&engine)->typeLoader.startupProfile());
+            QQmlComponent otherComponent(&otherEngine, otherUrl);
+            QVERIFY2(otherComponent.isReady(), qPrintable(otherComponent.errorString()));
+        }
+        QVERIFY(!QFile::exists(profilePath));
+    }
+
+    const QList<QQmlStartupProfile::Entry> entries = QQmlStartupProfile::load(profilePath);
+    const auto indexOf = [&](QQmlStartupProfile::Kind kind, const QString &location) {
+        for (qsizetype i = 0; i < entries.size(); ++i) {
+            if (entries[i].kind == kind && entries[i].location == location)
+                return i;
+        }
+        return qsizetype(-1);
+    };
+    const qsizetype mainIndex = indexOf(QQmlStartupProfile::Document, mainUrl.toString());
+    const qsizetype depIndex = indexOf(
+            QQmlStartupProfile::Document,
+            QUrl::fromLocalFile(dir.filePath(QStringLiteral("Dep.qml"))).toString());
+    const qsizetype scriptIndex = indexOf(
+            QQmlStartupProfile::Script,
+            QUrl::fromLocalFile(dir.filePath(QStringLiteral("util.js"))).toString());
+    QVERIFY(mainIndex >= 0);
+    QVERIFY(depIndex > mainIndex);
+    QVERIFY(scriptIndex > mainIndex);
+    QVERIFY(indexOf(QQmlStartupProfile::Document, otherUrl.toString()) >= 0);
+
+    // The second run replays it before loading anything
+    {
+        QQmlEngine engine;
+        QQmlStartupProfile *profile = QQmlEnginePrivate::get(&engine)->typeLoader.startupProfile();
+        QVERIFY(profile);
+        QCOMPARE(profile->mode(), QQmlStartupProfile::Replay);
+
+        // The replay never takes the type loader's lock, which this holds
+        engine.clearComponentCache();
+
+        profile->waitForReplay();
+        QCOMPARE(profile->replayedEntries(), int(entries.size()));
+
+        QQmlComponent component(&engine, mainUrl);
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        QScopedPointer<QObject> root(component.create());
+        QVERIFY(root);
+        QCOMPARE(root->property("value").toInt(), 5);
+    }
+}
+
 QTEST_MAIN(tst_QQMLTypeLoader)
 
 #include "tst_qqmltypeloader.moc"
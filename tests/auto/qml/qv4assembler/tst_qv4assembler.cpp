@@ -6,10 +6,15 @@
 #include <QtCore/qprocess.h>
 #endif
 #include <QtCore/qtemporaryfile.h>
+#include <QtQml/qjsengine.h>
 #include <QtQml/qqml.h>
 #include <QtQml/qqmlapplicationengine.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
+#include <private/qjsvalue_p.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4function_p.h>
+#include <private/qv4functionobject_p.h>
 #include <private/qv4global_p.h>
 
 #ifdef Q_OS_WIN
@@ -28,6 +33,7 @@ private slots:
     void perfMapFile();
     void functionTable();
     void jitEnabled();
+    void optimizingTier();
 };
 
 tst_QV4Assembler::tst_QV4Assembler()
@@ -143,6 +149,98 @@ void tst_QV4Assembler::jitEnabled()
 #endif
 }
 
+void tst_QV4Assembler::optimizingTier()
+{
+    QJSEngine engine;
+    QV4::ExecutionEngine *v4 = engine.handle();
+    if (!v4->canJIT())
+        QSKIP("The JIT is not available");
+
+    // The second call of each function runs the specialized code. Feed it objects of the shape
+    // it was specialized for, and then others that need to take the generic path.
+    const int threshold = QV4::ExecutionEngine::jitOptimizeCallCountThreshold();
+    QV4::ExecutionEngine::setJitOptimizeCallCountThreshold(0);
+    const auto restoreThreshold = qScopeGuard([threshold]() {
+        QV4::ExecutionEngine::setJitOptimizeCallCountThreshold(threshold);
+    });
+
+    QJSValue result = engine.evaluate(QStringLiteral(R"(
+        function getX(o) { return o.x; }
+        function getLast(o) { return o.p19; }
+        function add(a, b) { return a + b; }
+
+        var results = [];
+        var small = { x: 1, y: 2 };
+        for (var i = 0; i < 10; ++i)
+            results.push(getX(small));
+        results.push(getX({ y: 3, x: 4 }));
+        results.push(getX({ x: "five" }));
+        results.push(getX(6));
+        results.push(getX("seven"));
+        small.x = 8;
+        results.push(getX(small));
+        delete small.y;
+        results.push(getX(small));
+
+        var big = {};
+        for (var i = 0; i < 20; ++i)
+            big["p" + i] = i * 10;
+        for (var i = 0; i < 10; ++i)
+            results.push(getLast(big));
+        results.push(getLast({ p19: 9 }));
+
+        try {
+            getX(undefined);
+            results.push("no exception");
+        } catch (e) {
+            results.push(e instanceof TypeError);
+        }
+        for (var i = 0; i < 3; ++i)
+            add(i, 1);
+        results.join(",");
+    )"));
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+
+    QStringList expected;
+    for (int i = 0; i < 10; ++i)
+        expected.append(QStringLiteral("1"));
+    expected << QStringLiteral("4") << QStringLiteral("five") << QString() << QString()
+             << QStringLiteral("8") << QStringLiteral("8");
+    for (int i = 0; i < 10; ++i)
+        expected.append(QStringLiteral("190"));
+    expected << QStringLiteral("9") << QStringLiteral("true");
+    QCOMPARE(result.toString(), expected.join(QLatin1Char(',')));
+
+    const auto function = [&](const QString &name) -> QV4::Function * {
+        const QJSValue value = engine.globalObject().property(name);
+        const QV4::FunctionObject *object = QJSValuePrivate::asManagedType<QV4::FunctionObject>(&value);
+        return object ? object->function() : nullptr;
+    };
+
+    // The lookups were specialized, and the optimized code replaced the baseline code
+    for (const QString &name : { QStringLiteral("getX"), QStringLiteral("getLast") }) {
+        const QV4::Function *f = function(name);
+        QVERIFY(f);
+        QVERIFY2(f->isOptimized, qPrintable(name));
+#if QT_CONFIG(qml_jit) && QT_POINTER_SIZE == 8
+        // Same condition as the 64bit assembler uses to inline object lookups
+        if (QV4::Value::Top1Shift == 0 && QV4::Value::Upper3Shift == 0
+                && QV4::Value::Lower5Shift == 0) {
+            QVERIFY2(f->baselineCodeRef, qPrintable(name));
+            QVERIFY(f->codeRef);
+            QVERIFY(f->codeRef != f->baselineCodeRef);
+            QVERIFY(f->jittedCode);
+        }
+#endif
+    }
+
+    // Nothing to specialize here, so the baseline code is kept
+    const QV4::Function *add = function(QStringLiteral("add"));
+    QVERIFY(add);
+    QVERIFY(add->isOptimized);
+    QVERIFY(!add->baselineCodeRef);
+}
+
 QTEST_MAIN(tst_QV4Assembler)
 
 #include "tst_qv4assembler.moc"
@@ -9,6 +9,7 @@
 #include <private/qv4mm_p.h>
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qjsvalue_p.h>
+#include <private/qv4profiling_p.h>
 
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
@@ -27,6 +28,12 @@ private slots:
     void accessParentOnDestruction();
     void cleanInternalClasses();
     void createObjectsOnDestruction();
+    void incrementalGC();
+    void incrementalGCProfiling();
+    void incrementalGCMarkStackOverflow();
+    void parallelSweep();
+    void generationalGC();
+    void parallelMark();
 };
 
 tst_qv4mm::tst_qv4mm()
@@ -206,6 +213,219 @@ void tst_qv4mm::createObjectsOnDestruction()
     QCOMPARE(obj->property("ok").toBool(), true);
 }
 
+void tst_qv4mm::incrementalGC()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->setGCTimeLimit(1);
+
+    engine.evaluate(QStringLiteral("var a = { value: 'a' }; var b = { next: null };"));
+    QJSValue allocate = engine.evaluate(QStringLiteral(
+            "(function() { var garbage = []; "
+            "for (var i = 0; i < 1000; ++i) garbage.push({ index: i }); })"));
+
+    for (int i = 0; i < 10000 && mm->gcState() != QV4::MemoryManager::GCMarking; ++i)
+        allocate.call();
+    QCOMPARE(mm->gcState(), QV4::MemoryManager::GCMarking);
+
+    // Move references around behind the marker's back.
+    engine.evaluate(QStringLiteral("b.next = a; a = null;"));
+    engine.evaluate(QStringLiteral("var c = { value: 'c' + b.next.value };"));
+
+    while (!mm->gcStep(QDeadlineTimer(1))) {}
+    QCOMPARE(mm->gcState(), QV4::MemoryManager::GCIdle);
+
+    QCOMPARE(engine.evaluate(QStringLiteral("b.next.value")).toString(), QStringLiteral("a"));
+    QCOMPARE(engine.evaluate(QStringLiteral("c.value")).toString(), QStringLiteral("ca"));
+
+    mm->runGC();
+    QCOMPARE(engine.evaluate(QStringLiteral("b.next.value + c.value")).toString(),
+             QStringLiteral("aca"));
+}
+
+void tst_qv4mm::incrementalGCMarkStackOverflow()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+
+    // More objects than fit on the mark stack, all referenced from one array
+    const int count = engine.handle()->maxGCStackSize() / int(sizeof(void *)) + 1000;
+    engine.evaluate(QStringLiteral("var wide = []; for (var i = 0; i < %1; ++i) wide.push({ index: i });")
+                            .arg(count));
+
+    mm->setGCTimeLimit(1);
+    QJSValue allocate = engine.evaluate(QStringLiteral(
+            "(function() { var garbage = []; "
+            "for (var i = 0; i < 1000; ++i) garbage.push({ index: i }); })"));
+    for (int i = 0; i < 10000 && mm->gcState() != QV4::MemoryManager::GCMarking; ++i)
+        allocate.call();
+    QCOMPARE(mm->gcState(), QV4::MemoryManager::GCMarking);
+
+    // An expired deadline lets each step mark only a few objects, even once the
+    // array fills the mark stack.
+    int markSteps = 0;
+    while (mm->gcState() == QV4::MemoryManager::GCMarking) {
+        mm->gcStep(QDeadlineTimer(0));
+        ++markSteps;
+    }
+    QVERIFY2(markSteps > count / 128, qPrintable(QString::number(markSteps)));
+    while (!mm->gcStep(QDeadlineTimer::Forever)) {}
+
+    mm->runGC();
+    QCOMPARE(engine.evaluate(QStringLiteral(
+                     "var sum = 0; for (var i = 0; i < wide.length; ++i) sum += wide[i].index; sum"))
+                     .toNumber(),
+             double(count) * (count - 1) / 2);
+}
+
+void tst_qv4mm::incrementalGCProfiling()
+{
+#if QT_CONFIG(qml_debug)
+    QJSEngine engine;
+    QV4::ExecutionEngine *v4 = engine.handle();
+    QV4::MemoryManager *mm = v4->memoryManager;
+    mm->setGCTimeLimit(1);
+
+    v4->setProfiler(new QV4::Profiling::Profiler(v4));
+    QV4::Profiling::Profiler *profiler = v4->profiler();
+    QVector<QV4::Profiling::MemoryAllocationProperties> memoryData;
+    connect(profiler, &QV4::Profiling::Profiler::dataReady, this,
+            [&](const QV4::Profiling::FunctionLocationHash &,
+                const QVector<QV4::Profiling::FunctionCallProperties> &,
+                const QVector<QV4::Profiling::MemoryAllocationProperties> &data) {
+        memoryData.append(data);
+    });
+    profiler->startProfiling(1 << QV4::Profiling::FeatureMemoryAllocation);
+
+    QJSValue allocate = engine.evaluate(QStringLiteral(
+            "(function() { var garbage = []; "
+            "for (var i = 0; i < 1000; ++i) garbage.push({ index: i }); })"));
+    for (int i = 0; i < 10000 && mm->gcState() != QV4::MemoryManager::GCMarking; ++i)
+        allocate.call();
+    QCOMPARE(mm->gcState(), QV4::MemoryManager::GCMarking);
+
+    // With an expired deadline, each step only marks or sweeps a little
+    while (!mm->gcStep(QDeadlineTimer(0))) {}
+
+    profiler->stopProfiling();
+
+    // Each step reports its pause, in the order of the other memory events
+    int markSteps = 0;
+    int sweepSteps = 0;
+    qint64 lastTimestamp = 0;
+    for (const QV4::Profiling::MemoryAllocationProperties &props : std::as_const(memoryData)) {
+        QVERIFY(props.timestamp >= lastTimestamp);
+        lastTimestamp = props.timestamp;
+        if (props.type == QV4::Profiling::GCMarkStep)
+            ++markSteps;
+        else if (props.type == QV4::Profiling::GCSweepStep)
+            ++sweepSteps;
+        else
+            continue;
+        QVERIFY(props.size >= 0);
+        QVERIFY(props.size < 1000 * 1000 * 1000);
+    }
+    QVERIFY(markSteps > 0);
+    QVERIFY(sweepSteps > 0);
+#else
+    QSKIP("The V4 profiler is only available with qml_debug");
+#endif
+}
+
+void tst_qv4mm::parallelSweep()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->setSweepThreadCount(3);
+    QCOMPARE(mm->sweepThreadCount(), 3);
+
+    engine.evaluate(QStringLiteral(
+            "var kept = []; "
+            "for (var i = 0; i < 20000; ++i) { "
+            "    var sparse = []; sparse[i * 1000] = 'x' + i; "
+            "    var o = { text: 'item' + i, sparse: sparse, map: new Map() }; "
+            "    if (i % 7 == 0) kept.push(o); "
+            "}"));
+    mm->runGC();
+
+    QJSValue result = engine.evaluate(QStringLiteral(
+            "var ok = kept.length; "
+            "for (var j = 0; j < kept.length; ++j) { "
+            "    var i = j * 7; "
+            "    if (kept[j].text !== 'item' + i || kept[j].sparse[i * 1000] !== 'x' + i) "
+            "        ok = -1; "
+            "} ok"));
+    QCOMPARE(result.toInt(), 2858);
+
+    mm->setSweepThreadCount(0);
+    QCOMPARE(mm->sweepThreadCount(), 0);
+}
+
+void tst_qv4mm::generationalGC()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->setGenerational(true);
+    QVERIFY(mm->isGenerational());
+
+    // Promote the objects to the old generation.
+    engine.evaluate(QStringLiteral(
+            "var old = { next: null }; var oldArray = []; var oldMap = new Map(); "
+            "function local() { var captured = null; "
+            "    return { set: function(v) { captured = v; }, get: function() { return captured; } }; }"
+            "var closure = local();"));
+    mm->runGC();
+    QVERIFY(mm->m_rememberedSet.empty());
+
+    // Store young objects into the old ones. They are only reachable through the old
+    // objects, so the minor collections need the remembered set to find them.
+    engine.evaluate(QStringLiteral(
+            "old.next = { value: 'property' }; oldArray[0] = { value: 'element' }; "
+            "oldMap.set('key', { value: 'map' }); closure.set({ value: 'local' });"));
+    QVERIFY(!mm->m_rememberedSet.empty());
+
+    QJSValue allocate = engine.evaluate(QStringLiteral(
+            "(function() { var garbage = []; "
+            "for (var i = 0; i < 1000; ++i) garbage.push({ index: i }); })"));
+    for (int i = 0; i < 1000; ++i)
+        allocate.call();
+
+    QCOMPARE(engine.evaluate(QStringLiteral(
+                     "old.next.value + oldArray[0].value + oldMap.get('key').value "
+                     "+ closure.get().value")).toString(),
+             QStringLiteral("propertyelementmaplocal"));
+
+    mm->setGenerational(false);
+    QVERIFY(mm->m_rememberedSet.empty());
+    mm->runGC();
+    QCOMPARE(engine.evaluate(QStringLiteral("old.next.value")).toString(),
+             QStringLiteral("property"));
+}
+
+void tst_qv4mm::parallelMark()
+{
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->setMarkThreadCount(3);
+    QCOMPARE(mm->markThreadCount(), 3);
+
+    // A long list keeps the mark stacks deep, a wide array gives the workers
+    // something to share.
+    engine.evaluate(QStringLiteral(
+            "var list = null; for (var i = 0; i < 50000; ++i) list = { index: i, next: list }; "
+            "var wide = []; for (var j = 0; j < 50000; ++j) wide.push({ text: 'item' + j });"));
+    mm->runGC();
+    mm->runGC();
+
+    QJSValue result = engine.evaluate(QStringLiteral(
+            "var n = 0; for (var l = list; l; l = l.next) ++n; "
+            "for (var k = 0; k < wide.length; ++k) { if (wide[k].text !== 'item' + k) n = -1; } n"));
+    QCOMPARE(result.toInt(), 50000);
+
+    mm->setMarkThreadCount(0);
+    QCOMPARE(mm->markThreadCount(), 0);
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"
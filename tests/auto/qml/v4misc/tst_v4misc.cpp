@@ -3,6 +3,7 @@
 
 #include <qtest.h>
 #include <private/qv4instr_moth_p.h>
+#include <private/qv4lookup_p.h>
 #include <private/qv4script_p.h>
 
 class tst_v4misc: public QObject
@@ -20,6 +21,8 @@ private slots:
     void subClassing();
 
     void nestingDepth();
+
+    void polymorphicLookups();
 };
 
 void tst_v4misc::tdzOptimizations_data()
@@ -172,6 +175,49 @@ void tst_v4misc::nestingDepth()
     }
 }
 
+void tst_v4misc::polymorphicLookups()
+{
+    QJSEngine engine;
+    engine.installExtensions(QJSEngine::GarbageCollectionExtension);
+    QJSValue result = engine.evaluate(QStringLiteral(R"(
+        function get(o) { return o.v; }
+
+        // Objects of 16 different layouts, with v stored inline or in the member data.
+        var objects = [];
+        for (var i = 0; i < 16; ++i) {
+            var o = {};
+            for (var j = 0; j < i; ++j)
+                o["p" + i + "_" + j] = j;
+            o.v = i;
+            objects.push(o);
+        }
+
+        var sum = 0;
+        for (var round = 0; round < 10; ++round) {
+            // First only a few layouts, then all of them
+            var n = round < 5 ? 4 : objects.length;
+            for (var i = 0; i < n; ++i)
+                sum += get(objects[i]);
+            if (round == 7)
+                gc();
+        }
+
+        // Properties that are not own data properties still work
+        var proto = { v: 100 };
+        sum += get(Object.create(proto));
+        sum += get({ get v() { return 1000; } });
+        sum += get("string") === undefined ? 10000 : 0;
+        sum;
+    )"));
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.toInt(), 5 * 6 + 5 * 120 + 100 + 1000 + 10000);
+
+    const QV4::MegamorphicLookupCache::Statistics &statistics
+            = engine.handle()->megamorphicLookupCache->statistics;
+    QVERIFY(statistics.polymorphicHits > 0);
+    QVERIFY(statistics.megamorphicHits > 0);
+}
+
 QTEST_MAIN(tst_v4misc);
 
 #include "tst_v4misc.moc"
@@ -0,0 +1,33 @@
+import QtQuick
+
+Window {
+    id: window
+    width: 100
+    height: 100
+    visible: true
+
+    property FrameTimings timings: content.Window.frameTimings
+
+    Rectangle {
+        id: content
+        width: 50
+        height: 50
+        color: "red"
+        Component.onCompleted: Window.frameTimings.enabled = true
+
+        NumberAnimation on rotation {
+            from: 0
+            to: 360
+            duration: 1000
+            loops: Animation.Infinite
+        }
+    }
+
+    function intervalPercentile(percentile) {
+        return timings.percentile(FrameTimings.FrameInterval, percentile)
+    }
+
+    function recentFrameCount() {
+        return timings.recentFrames().length
+    }
+}
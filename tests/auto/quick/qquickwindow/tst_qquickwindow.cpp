@@ -19,6 +19,7 @@
 #include <QtQuickTestUtils/private/viewtestutils_p.h>
 #include <QSignalSpy>
 #include <private/qquickwindow_p.h>
+#include <private/qqmlengine_p.h>
 #include <private/qguiapplication_p.h>
 #include <QtGui/qpa/qplatformintegration.h>
 #include <QRunnable>
@@ -547,6 +548,13 @@ private slots:
 
     void graphicsConfiguration();
 
+    void frameTimingsHistogram();
+    void frameTimings();
+
+    void coalescedBindingUpdatesBeforePolish();
+
+    void incubationFrameBudget();
+
 private:
     QPointingDevice *touchDevice; // TODO make const after fixing QTBUG-107864
     const QPointingDevice *touchDeviceWithVelocity;
@@ -4083,6 +4091,144 @@ void tst_qquickwindow::graphicsConfiguration()
 #endif
 }
 
+void tst_qquickwindow::frameTimingsHistogram()
+{
+    QQuickWindow window;
+    QQuickFrameTimings *timings = QQuickWindowPrivate::get(&window)->frameTimings.data();
+    QVERIFY(timings);
+    QCOMPARE(timings->frameCount(), 0);
+    QCOMPARE(timings->percentile(QQuickFrameTimings::Sync, 50), 0.0);
+
+    // 1 to 100 milliseconds of sync, and 2 microseconds of polish
+    for (int i = 1; i <= 100; ++i) {
+        timings->addPhaseTime(QQuickFrameTimings::Sync, qint64(i) * 1000000);
+        timings->recordGuiThreadPhases(2000, 0);
+        timings->commitFrame();
+    }
+    QCOMPARE(timings->frameCount(), 100);
+
+    // The histogram buckets span an eighth of their lower bound
+    for (qreal percentile : { 10.0, 50.0, 90.0, 99.0 }) {
+        const qreal sync = timings->percentile(QQuickFrameTimings::Sync, percentile);
+        QVERIFY2(sync >= percentile && sync <= percentile * 1.125,
+                 qPrintable(QString::number(sync)));
+    }
+    QCOMPARE(timings->percentile(QQuickFrameTimings::Sync, 100),
+             timings->percentile(QQuickFrameTimings::Sync, 99.5));
+    QCOMPARE(timings->percentile(QQuickFrameTimings::Polish, 50), 0.002);
+    QCOMPARE(timings->percentile(QQuickFrameTimings::GarbageCollection, 100), 0.0);
+
+    // Only the most recent frames are kept
+    for (int i = 0; i < timings->capacity(); ++i)
+        timings->commitFrame();
+    const QList<QQuickFrameTimings::Frame> frames = timings->frames();
+    QCOMPARE(frames.size(), timings->capacity());
+    QCOMPARE(frames.first().number, quint64(100));
+    QCOMPARE(frames.last().number, quint64(100 + timings->capacity() - 1));
+    QCOMPARE(frames.last().durations[QQuickFrameTimings::Sync], 0);
+
+    timings->reset();
+    QCOMPARE(timings->frameCount(), 0);
+    QVERIFY(timings->frames().isEmpty());
+}
+
+void tst_qquickwindow::frameTimings()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.loadUrl(testFileUrl("frameTimings.qml"));
+    QScopedPointer<QObject> created(component.create());
+    QQuickWindow *window = qobject_cast<QQuickWindow *>(created.data());
+    QVERIFY(window);
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+
+    QQuickFrameTimings *timings = QQuickWindowPrivate::get(window)->frameTimings.data();
+    QCOMPARE(window->property("timings").value<QQuickFrameTimings *>(), timings);
+    QVERIFY(timings->isEnabled());
+
+    QTRY_VERIFY(timings->frameCount() > 10);
+
+    const QList<QQuickFrameTimings::Frame> frames = timings->frames();
+    QVERIFY(frames.size() > 10);
+    for (qsizetype i = 1; i < frames.size(); ++i) {
+        QCOMPARE(frames.at(i).number, frames.at(i - 1).number + 1);
+        QVERIFY(frames.at(i).timestamp >= frames.at(i - 1).timestamp);
+        QVERIFY(frames.at(i).durations[QQuickFrameTimings::FrameInterval] > 0);
+    }
+
+    QVariant interval;
+    QVERIFY(QMetaObject::invokeMethod(window, "intervalPercentile",
+                                      Q_RETURN_ARG(QVariant, interval), Q_ARG(QVariant, 50)));
+    QVERIFY(interval.toReal() > 0);
+    QVariant recentFrameCount;
+    QVERIFY(QMetaObject::invokeMethod(window, "recentFrameCount",
+                                      Q_RETURN_ARG(QVariant, recentFrameCount)));
+    QVERIFY(recentFrameCount.toInt() > 10);
+
+    timings->setEnabled(false);
+    QCOMPARE(timings->frameCount(), 0);
+    QTest::qWait(100);
+    QCOMPARE(timings->frameCount(), 0);
+}
+
+void tst_qquickwindow::coalescedBindingUpdatesBeforePolish()
+{
+    QQmlEngine engine;
+    QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(&engine);
+    enginePrivate->setCoalesceBindingUpdates(true);
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick\n"
+                      "Item { property int source: 0; property int doubled: source * 2 }", QUrl());
+
+    // The window is created from C++, so its engine is found through its items
+    QQuickWindow window;
+    QScopedPointer<QQuickItem> item(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(item, qPrintable(component.errorString()));
+    item->setParentItem(window.contentItem());
+    enginePrivate->flushBindingUpdates();
+
+    item->setProperty("source", 5);
+    QCOMPARE(item->property("doubled").toInt(), 0);
+    QQuickWindowPrivate::get(&window)->polishItems();
+    QVERIFY(enginePrivate->pendingBindingUpdates.isEmpty());
+    QCOMPARE(item->property("doubled").toInt(), 10);
+
+    // Without coalescing, the binding is updated right away
+    enginePrivate->setCoalesceBindingUpdates(false);
+    item->setProperty("source", 6);
+    QCOMPARE(item->property("doubled").toInt(), 12);
+}
+
+void tst_qquickwindow::incubationFrameBudget()
+{
+    constexpr qint64 ms = 1000000;
+    QQuickIncubationBudget budget(16 * ms, 5);
+
+    // Without a measurement of the frame, the fallback is used
+    QCOMPARE(budget.frameBudget(-1, -1), 5);
+
+    // The frame interval, less the GUI thread's time and a quarter frame
+    QCOMPARE(budget.frameBudget(4 * ms, -1), 8);
+    QCOMPARE(budget.frameBudget(4 * ms, 16 * ms), 8);
+    QCOMPARE(budget.frameBudget(10 * ms, 16 * ms), 2);
+    QCOMPARE(budget.frameBudget(20 * ms, 16 * ms), 1);
+
+    // Late frames halve the budget, down to an eighth
+    QCOMPARE(budget.frameBudget(4 * ms, 30 * ms), 4);
+    QCOMPARE(budget.frameBudget(4 * ms, 30 * ms), 2);
+    QCOMPARE(budget.frameBudget(4 * ms, 30 * ms), 1);
+    QCOMPARE(budget.frameBudget(4 * ms, 30 * ms), 1);
+    QCOMPARE(budget.scale(), 0.125);
+
+    // Frames on time, and pauses in rendering, let it recover gradually
+    QCOMPARE(budget.frameBudget(4 * ms, 16 * ms), 2);
+    QCOMPARE(budget.frameBudget(4 * ms, 100 * ms), 3);
+    for (int i = 0; i < 8; ++i)
+        budget.frameBudget(4 * ms, 16 * ms);
+    QCOMPARE(budget.scale(), 1.0);
+    QCOMPARE(budget.frameBudget(4 * ms, 16 * ms), 8);
+}
+
 QTEST_MAIN(tst_qquickwindow)
 
 #include "tst_qquickwindow.moc"
@@ -0,0 +1,50 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick
+
+Rectangle {
+    width: 200
+    height: 200
+    color: "white"
+
+    // Visible
+    Item {
+        width: 100
+        height: 100
+        clip: true
+        Rectangle {
+            width: 50
+            height: 50
+            color: "red"
+        }
+    }
+
+    // Outside of the window
+    Item {
+        y: 250
+        width: 100
+        height: 100
+        clip: true
+        Rectangle {
+            width: 100
+            height: 100
+            color: "blue"
+        }
+    }
+
+    // Inside the window, but outside of the clip
+    Item {
+        x: 100
+        y: 100
+        width: 50
+        height: 50
+        clip: true
+        Rectangle {
+            x: 60
+            width: 40
+            height: 40
+            color: "green"
+        }
+    }
+}
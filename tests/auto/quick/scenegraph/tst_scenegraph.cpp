@@ -20,6 +20,12 @@
 #include <private/qsgrenderloop_p.h>
 #include <private/qsgrhisupport_p.h>
 #include <private/qsgplaintexture_p.h>
+#include <private/qsgdefaultrendercontext_p.h>
+#include <private/qsgrhiatlastexture_p.h>
+#include <private/qsgdistancefielddiskcache_p.h>
+#include <private/qsgbatchrenderer_p.h>
+#include <private/qquickwindow_p.h>
+#include <private/qquickimagebase_p.h>
 
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QtQuickTestUtils/private/visualtestutils_p.h>
@@ -96,12 +102,38 @@ private slots:
     void createTextureFromImage();
     void withAdoptedRhi();
     void resizeTextureFromImage();
+    void atlasPages();
+    void preuploadTexture();
+    void preuploadTextureFactoryDestroyed();
+    void preuploadTextureFallback();
+    void distanceFieldDiskCache();
+    void culling();
 
 private:
     QQuickView *createView(const QString &file, QWindow *parent = nullptr, int x = -1, int y = -1, int w = -1, int h = -1);
     bool isRunningOnRhi();
 };
 
+class CountingTextureFactory : public QQuickTextureFactory
+{
+public:
+    CountingTextureFactory(const QImage &image) : m_image(image) { }
+
+    QSGTexture *createTexture(QQuickWindow *window) const override
+    {
+        ++createCount;
+        return window->createTextureFromImage(m_image, QQuickWindow::TextureCanUseAtlas);
+    }
+    QSize textureSize() const override { return m_image.size(); }
+    int textureByteCount() const override { return int(m_image.sizeInBytes()); }
+    QImage image() const override { return m_image; }
+
+    mutable int createCount = 0;
+
+private:
+    QImage m_image;
+};
+
 template <typename T> class ScopedList : public QList<T> {
 public:
     ~ScopedList() { qDeleteAll(*this); }
@@ -783,6 +815,204 @@ void tst_SceneGraph::resizeTextureFromImage()
     TestOffscreenScene::cleanup();
 }
 
+void tst_SceneGraph::atlasPages()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    // A 40x40 image, with its padding, fills a whole 64x64 page
+    qputenv("QSG_ATLAS_WIDTH", "64");
+    qputenv("QSG_ATLAS_HEIGHT", "64");
+    qputenv("QSG_ATLAS_SIZE_LIMIT", "64");
+    qputenv("QSG_ATLAS_MAX_PAGES", "2");
+    qputenv("QSG_ATLAS_PAGE_IDLE_FRAMES", "2");
+    auto cleanup = qScopeGuard([] {
+        for (const char *name : { "QSG_ATLAS_WIDTH", "QSG_ATLAS_HEIGHT", "QSG_ATLAS_SIZE_LIMIT",
+                                  "QSG_ATLAS_MAX_PAGES", "QSG_ATLAS_PAGE_IDLE_FRAMES" }) {
+            qunsetenv(name);
+        }
+    });
+
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("renderControl_rect.qml"))));
+        QVERIFY(scene->renderControl && scene->window && scene->rootItem);
+
+        auto *rc = static_cast<QSGDefaultRenderContext *>(QQuickWindowPrivate::get(scene->window)->context);
+        QSGRhiAtlasTexture::Manager *manager = rc->rhiAtlasManager();
+        QVERIFY(manager);
+        QCOMPARE(manager->pageCount(), 0);
+
+        const QImage image(40, 40, QImage::Format_RGBA8888_Premultiplied);
+        const auto create = [&]() {
+            return scene->window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas);
+        };
+
+        QScopedPointer<QSGTexture> first(create());
+        QVERIFY(first->isAtlasTexture());
+        QCOMPARE(manager->pageCount(), 1);
+
+        // The first page is full, so a second one is created
+        QScopedPointer<QSGTexture> second(create());
+        QVERIFY(second->isAtlasTexture());
+        QCOMPARE(manager->pageCount(), 2);
+
+        // At the page limit, images get standalone textures
+        QScopedPointer<QSGTexture> standalone(create());
+        QVERIFY(!standalone->isAtlasTexture());
+        QCOMPARE(manager->pageCount(), 2);
+
+        // A page that holds images is kept
+        for (int frame = 0; frame < 4; ++frame)
+            manager->releaseUnusedPages();
+        QCOMPARE(manager->pageCount(), 2);
+
+        // Once empty, the second page is released after the idle frames have passed
+        second.reset();
+        manager->releaseUnusedPages();
+        manager->releaseUnusedPages();
+        QCOMPARE(manager->pageCount(), 2);
+        manager->releaseUnusedPages();
+        QCOMPARE(manager->pageCount(), 1);
+
+        // The first page is never released
+        first.reset();
+        for (int frame = 0; frame < 4; ++frame)
+            manager->releaseUnusedPages();
+        QCOMPARE(manager->pageCount(), 1);
+    }
+
+    TestOffscreenScene::cleanup();
+}
+
+void tst_SceneGraph::preuploadTexture()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("renderControl_rect.qml"))));
+        QVERIFY(scene->renderControl && scene->window && scene->rootItem);
+
+        auto *rc = static_cast<QSGDefaultRenderContext *>(QQuickWindowPrivate::get(scene->window)->context);
+        QSGRhiAtlasTexture::Manager *manager = rc->rhiAtlasManager();
+        QVERIFY(manager);
+        QCOMPARE(manager->pageCount(), 0);
+
+        QImage image(32, 32, QImage::Format_RGBA8888_Premultiplied);
+        image.fill(Qt::red);
+        CountingTextureFactory factory(image);
+
+        // What the threaded render loop does on either thread
+        rc->schedulePreupload(&factory);
+        rc->preuploadTexture(&factory, image);
+        QCOMPARE(manager->pageCount(), 1);
+
+        // The sync picks up the texture created ahead of time
+        QSGTexture *texture = rc->textureForFactory(&factory, scene->window);
+        QVERIFY(texture);
+        QCOMPARE(factory.createCount, 0);
+        QVERIFY(texture->isAtlasTexture());
+        QCOMPARE(texture->textureSize(), image.size());
+        QCOMPARE(rc->textureForFactory(&factory, scene->window), texture);
+        QCOMPARE(factory.createCount, 0);
+    }
+
+    TestOffscreenScene::cleanup();
+}
+
+void tst_SceneGraph::preuploadTextureFactoryDestroyed()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("renderControl_rect.qml"))));
+        QVERIFY(scene->renderControl && scene->window && scene->rootItem);
+
+        auto *rc = static_cast<QSGDefaultRenderContext *>(QQuickWindowPrivate::get(scene->window)->context);
+        QSGRhiAtlasTexture::Manager *manager = rc->rhiAtlasManager();
+        QVERIFY(manager);
+
+        QImage image(32, 32, QImage::Format_RGBA8888_Premultiplied);
+        image.fill(Qt::red);
+
+        // The factory is destroyed on the GUI thread before the render thread gets to it.
+        // The render thread only uses it as a key, and must not create a texture for it.
+        auto *factory = new CountingTextureFactory(image);
+        rc->schedulePreupload(factory);
+        delete factory;
+        rc->preuploadTexture(factory, image);
+        QCOMPARE(manager->pageCount(), 0);
+
+        // A new factory, possibly at the same address, gets its own texture
+        CountingTextureFactory other(image);
+        QVERIFY(rc->textureForFactory(&other, scene->window));
+        QCOMPARE(other.createCount, 1);
+    }
+
+    TestOffscreenScene::cleanup();
+}
+
+void tst_SceneGraph::preuploadTextureFallback()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    QImage image(32, 32, QImage::Format_RGBA8888_Premultiplied);
+    image.fill(Qt::red);
+
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("renderControl_rect.qml"))));
+        QVERIFY(scene->renderControl && scene->window && scene->rootItem);
+
+        auto *rc = static_cast<QSGDefaultRenderContext *>(QQuickWindowPrivate::get(scene->window)->context);
+        QSGRhiAtlasTexture::Manager *manager = rc->rhiAtlasManager();
+        QVERIFY(manager);
+
+        // Without a preupload, the factory creates its texture during the sync
+        CountingTextureFactory factory(image);
+        QVERIFY(rc->textureForFactory(&factory, scene->window));
+        QCOMPARE(factory.createCount, 1);
+
+        // If the sync gets there first, the preupload arriving later does nothing
+        CountingTextureFactory late(image);
+        rc->schedulePreupload(&late);
+        QSGTexture *texture = rc->textureForFactory(&late, scene->window);
+        QVERIFY(texture);
+        QCOMPARE(late.createCount, 1);
+        const int pages = manager->pageCount();
+        rc->preuploadTexture(&late, image);
+        QCOMPARE(rc->textureForFactory(&late, scene->window), texture);
+        QCOMPARE(manager->pageCount(), pages);
+    }
+
+    TestOffscreenScene::cleanup();
+
+    // An asynchronously loaded image shows up with whichever render loop is in use. Only the
+    // threaded one uploads it ahead of the sync, the basic one leaves it to the factory.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("red.png"));
+    QVERIFY(image.save(fileName));
+
+    QQuickWindow window;
+    window.resize(64, 64);
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(QStringLiteral("import QtQuick\nImage { asynchronous: true; source: \"%1\" }")
+                      .arg(QUrl::fromLocalFile(fileName).toString()).toUtf8(), QUrl());
+    QScopedPointer<QQuickItem> item(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(item, qPrintable(component.errorString()));
+    item->setParentItem(window.contentItem());
+
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QTRY_COMPARE(item->property("status").toInt(), int(QQuickImageBase::Ready));
+
+    const QImage content = window.grabWindow();
+    QCOMPARE(content.pixelColor(16, 16), QColor(Qt::red));
+}
+
 bool tst_SceneGraph::isRunningOnRhi()
 {
     static bool retval = false;
@@ -802,6 +1032,123 @@ bool tst_SceneGraph::isRunningOnRhi()
     return retval;
 }
 
+void tst_SceneGraph::distanceFieldDiskCache()
+{
+    const QRawFont font = QRawFont::fromFont(QGuiApplication::font());
+    if (!font.isValid() || QSGDistanceFieldDiskCache::fontHash(font).isEmpty())
+        QSKIP("Needs a font with head and name tables");
+
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    qputenv("QSG_DISTANCEFIELD_CACHE_PATH", cacheDir.path().toLocal8Bit());
+    auto cleanup = qScopeGuard([] { qunsetenv("QSG_DISTANCEFIELD_CACHE_PATH"); });
+
+    const QList<quint32> glyphs = font.glyphIndexesForString(QStringLiteral("Qt"));
+    QCOMPARE(glyphs.size(), 2);
+
+    QList<QDistanceField> fields;
+    for (quint32 glyph : glyphs)
+        fields.append(QDistanceField(font.pathForGlyph(glyph), glyph, false));
+
+    {
+        auto cache = QSGDistanceFieldDiskCache::open(font, 0, false);
+        QVERIFY(cache);
+        QCOMPARE(cache->size(), 0);
+        cache->store(fields);
+        QCOMPARE(cache->size(), 2);
+    }
+
+    // The same font at a different quality uses a different file
+    QCOMPARE(QSGDistanceFieldDiskCache::open(font, 32, false)->size(), 0);
+
+    auto cache = QSGDistanceFieldDiskCache::open(font, 0, false);
+    QVERIFY(cache);
+    QCOMPARE(cache->size(), 2);
+    for (int i = 0; i < glyphs.size(); ++i) {
+        QDistanceField loaded;
+        QVERIFY(cache->lookup(glyphs.at(i), font.pathForGlyph(glyphs.at(i)).boundingRect(), &loaded));
+        QCOMPARE(loaded.glyph(), glyphs.at(i));
+        QCOMPARE(loaded.width(), fields.at(i).width());
+        QCOMPARE(loaded.height(), fields.at(i).height());
+        QCOMPARE(memcmp(loaded.constBits(), fields.at(i).constBits(), loaded.width() * loaded.height()), 0);
+    }
+
+    QDistanceField missing;
+    QVERIFY(!cache->lookup(qMax(glyphs.at(0), glyphs.at(1)) + 1, QRectF(0, 0, 10, 10), &missing));
+
+    // Outlines with other bounds don't match the cached field
+    QDistanceField resized;
+    const QRectF bounds = font.pathForGlyph(glyphs.at(0)).boundingRect();
+    QVERIFY(!cache->lookup(glyphs.at(0), bounds.adjusted(0, 0, 100, 100), &resized));
+
+    // Stored glyphs are only written when flushed
+    auto first = QSGDistanceFieldDiskCache::open(font, 48, false);
+    QVERIFY(first);
+    first->store({ fields.at(0) });
+    QCOMPARE(QSGDistanceFieldDiskCache::open(font, 48, false)->size(), 0);
+    first->flush();
+    QCOMPARE(QSGDistanceFieldDiskCache::open(font, 48, false)->size(), 1);
+
+    // Two caches writing the same file, like two processes would, keep each other's glyphs
+    auto second = QSGDistanceFieldDiskCache::open(font, 48, false);
+    QVERIFY(second);
+    QCOMPARE(second->size(), 1);
+    second->store({ fields.at(1) });
+    first->store({ fields.at(1) });
+    second.reset();
+    first.reset();
+    QCOMPARE(QSGDistanceFieldDiskCache::open(font, 48, false)->size(), 2);
+
+    // A torn record at the end is dropped, and the file is replaced on the next flush
+    const QString fileName = QSGDistanceFieldDiskCache::open(font, 48, false)->fileName();
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("torn");
+    }
+    {
+        auto cache = QSGDistanceFieldDiskCache::open(font, 48, false);
+        QCOMPARE(cache->size(), 2);
+        cache->store({ QDistanceField(font.pathForGlyph(glyphs.at(0)), glyphs.at(0) + 1, false) });
+    }
+    QCOMPARE(QSGDistanceFieldDiskCache::open(font, 48, false)->size(), 3);
+
+    // No temporary files are left behind
+    QCOMPARE(QDir(cacheDir.path()).entryList(QDir::Files).size(), 2);
+}
+
+void tst_SceneGraph::culling()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    QImage reference;
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("culling.qml"))));
+        QVERIFY(scene && scene->renderControl && scene->window && scene->rootItem);
+        reference = scene->window->grabWindow();
+        QVERIFY(!reference.isNull());
+    }
+
+    qputenv("QSG_RENDERER_CULLING", "1");
+    auto cleanup = qScopeGuard([] { qunsetenv("QSG_RENDERER_CULLING"); });
+    {
+        QScopedPointer<TestOffscreenScene> scene(createOffscreenScene(testFileUrl(QLatin1String("culling.qml"))));
+        QVERIFY(scene && scene->renderControl && scene->window && scene->rootItem);
+        const QImage image = scene->window->grabWindow();
+        QCOMPARE(image, reference);
+
+        auto *renderer = static_cast<QSGBatchRenderer::Renderer *>(
+                QQuickWindowPrivate::get(scene->window)->renderer);
+        QVERIFY(renderer);
+        // The rectangle below the window and the one outside of its clip
+        QCOMPARE(renderer->culledBatchCount(), 2);
+        QCOMPARE(renderer->culledElementCount(), 2);
+    }
+
+    TestOffscreenScene::cleanup();
+}
+
 #include "tst_scenegraph.moc"
 
 QTEST_MAIN(tst_SceneGraph)
@@ -22,6 +22,7 @@ private slots:
     void initTestCase() override;
 
     void renderTarget();
+    void tiledRendering();
 };
 
 tst_SoftwareRenderer::tst_SoftwareRenderer()
@@ -93,6 +94,66 @@ void tst_SoftwareRenderer::renderTarget()
              qPrintable(errorMessage));
 }
 
+static QImage renderScene(bool tiled)
+{
+    if (tiled) {
+        qputenv("QSG_SOFTWARE_RENDER_THREADS", "4");
+        qputenv("QSG_SOFTWARE_RENDER_TILE_SIZE", "16");
+    }
+    auto cleanup = qScopeGuard([] {
+        qunsetenv("QSG_SOFTWARE_RENDER_THREADS");
+        qunsetenv("QSG_SOFTWARE_RENDER_TILE_SIZE");
+    });
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick\n"
+                      "Item {\n"
+                      "    width: 100; height: 100\n"
+                      "    Rectangle { x: 5; y: 7; width: 60; height: 50; color: 'green'; radius: 8; border.width: 2 }\n"
+                      "    Rectangle { x: 30; y: 30; width: 65; height: 60; color: '#80ff0000'; rotation: 15 }\n"
+                      "    Text { x: 10; y: 70; text: 'Tiles' }\n"
+                      "}", QUrl());
+
+    QQuickRenderControl rc;
+    QScopedPointer<QQuickWindow> window(new QQuickWindow(&rc));
+    window->setWidth(100);
+    window->setHeight(100);
+    window->setColor(Qt::blue);
+
+    QScopedPointer<QQuickItem> item(qobject_cast<QQuickItem *>(component.create()));
+    if (!item)
+        return QImage();
+    item->setParentItem(window->contentItem());
+
+    QImage renderTarget(window->size(), QImage::Format_ARGB32_Premultiplied);
+    renderTarget.fill(Qt::transparent);
+    window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&renderTarget));
+
+    rc.polishItems();
+    rc.beginFrame();
+    rc.sync();
+    rc.render();
+    rc.endFrame();
+
+    return renderTarget;
+}
+
+void tst_SoftwareRenderer::tiledRendering()
+{
+    if (QQuickWindow::sceneGraphBackend() != "software")
+        QSKIP("Skipping complex rendering tests due to not running with software");
+
+    const QImage serial = renderScene(false);
+    QVERIFY(!serial.isNull());
+    const QImage tiled = renderScene(true);
+    QVERIFY(!tiled.isNull());
+
+    QString errorMessage;
+    QVERIFY2(QQuickVisualTestUtils::compareImages(tiled, serial, &errorMessage),
+             qPrintable(errorMessage));
+}
+
 #include "tst_softwarerenderer.moc"
 
 QTEST_MAIN(tst_SoftwareRenderer)
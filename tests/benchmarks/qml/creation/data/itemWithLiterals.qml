@@ -0,0 +1,18 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    property color fillColor: "steelblue"
+    property color borderColor: "#80ff0000"
+    property point origin: "10,20"
+    property size extent: "100x50"
+    property rect frame: "0,0,100x50"
+    property vector3d axis: "0,1,0"
+    property url icon: "images/icon.png"
+    property date day: "2023-05-17"
+
+    Rectangle { color: "red"; border.color: "blue"; width: 10; height: 10 }
+    Rectangle { color: "#00ff00"; border.color: "#0000ff"; width: 10; height: 10 }
+}
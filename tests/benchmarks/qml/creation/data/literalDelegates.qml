@@ -0,0 +1,19 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    Repeater {
+        model: 100
+        Rectangle {
+            property point origin: "4,4"
+            property size extent: "12x12"
+            property url icon: "images/icon.png"
+            color: "steelblue"
+            border.color: "#80ff0000"
+            width: 16
+            height: 16
+        }
+    }
+}
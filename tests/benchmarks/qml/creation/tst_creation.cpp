@@ -9,6 +9,10 @@
 #include <QQuickItem>
 #include <QQmlContext>
 #include <private/qobject_p.h>
+#include <private/qqmlbindingarena_p.h>
+#include <private/qqmlcontextdata_p.h>
+
+#include <memory>
 
 class tst_creation : public QObject
 {
@@ -43,6 +47,11 @@ private slots:
 
     void bindings_parent_qml();
 
+    void bindings_arena_data();
+    void bindings_arena();
+    void bindings_arena_allocations_data();
+    void bindings_arena_allocations();
+
     void anchors_creation();
     void anchors_heightChange();
 
@@ -286,6 +295,8 @@ void tst_creation::itemtests_qml_data()
     QTest::newRow("itemWithPropertyBindingsTest3") << "itemWithPropertyBindingsTest3.qml";
     QTest::newRow("itemWithPropertyBindingsTest4") << "itemWithPropertyBindingsTest4.qml";
     QTest::newRow("itemWithPropertyBindingsTest5") << "itemWithPropertyBindingsTest5.qml";
+    QTest::newRow("itemWithLiterals") << "itemWithLiterals.qml";
+    QTest::newRow("literalDelegates") << "literalDelegates.qml";
 }
 
 void tst_creation::itemtests_qml()
@@ -387,6 +398,69 @@ void tst_creation::bindings_parent_qml()
     delete obj;
 }
 
+// An item with objectCount children, each with two bindings and a signal handler
+static QByteArray itemWithBindings(int objectCount)
+{
+    QByteArray data = "import QtQuick 2.0\nItem {\n    id: root\n    property real value: 0\n";
+    for (int i = 0; i < objectCount; ++i) {
+        data += "    Item { property real a: root.value + " + QByteArray::number(i)
+                + "; property real b: a * 2; onBChanged: {} }\n";
+    }
+    return data + "}\n";
+}
+
+void tst_creation::bindings_arena_data()
+{
+    QTest::addColumn<int>("objectCount");
+
+    QTest::newRow("20 objects") << 20;
+    QTest::newRow("200 objects") << 200;
+}
+
+void tst_creation::bindings_arena()
+{
+    QFETCH(int, objectCount);
+
+    QQmlComponent component(&engine);
+    component.setData(itemWithBindings(objectCount), QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    delete component.create();
+    QBENCHMARK { delete component.create(); }
+}
+
+void tst_creation::bindings_arena_allocations_data()
+{
+    QTest::addColumn<int>("objectCount");
+    QTest::addColumn<bool>("countBlocks");
+
+    QTest::newRow("20 objects, allocations") << 20 << false;
+    QTest::newRow("20 objects, blocks") << 20 << true;
+    QTest::newRow("200 objects, allocations") << 200 << false;
+    QTest::newRow("200 objects, blocks") << 200 << true;
+}
+
+// Reports the number of bindings and signal handlers of one instance that
+// were allocated from the arena, or the number of blocks that back them.
+void tst_creation::bindings_arena_allocations()
+{
+    QFETCH(int, objectCount);
+    QFETCH(bool, countBlocks);
+
+    QQmlComponent component(&engine);
+    component.setData(itemWithBindings(objectCount), QUrl());
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    std::unique_ptr<QObject> object(component.create());
+    QVERIFY(object);
+    const QQmlBindingArena *arena = QQmlContextData::get(qmlContext(object.get()))->bindingArena();
+    if (!arena)
+        QSKIP("Binding arenas are disabled with QML_NO_BINDING_ARENA");
+
+    QTest::setBenchmarkResult(countBlocks ? arena->blockCount() : arena->allocationCount(),
+                              QTest::Events);
+}
+
 void tst_creation::anchors_creation()
 {
     QQmlComponent component(&engine);
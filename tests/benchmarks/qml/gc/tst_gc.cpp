@@ -0,0 +1,55 @@
+// Copyright (C) 2022 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QJSEngine>
+
+#include <private/qv4engine_p.h>
+#include <private/qv4mm_p.h>
+
+class tst_gc : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mark_data();
+    void mark();
+};
+
+void tst_gc::mark_data()
+{
+    QTest::addColumn<int>("markThreads");
+
+    QTest::newRow("serial") << 0;
+    QTest::newRow("1 helper thread") << 1;
+    QTest::newRow("3 helper threads") << 3;
+    QTest::newRow("7 helper threads") << 7;
+}
+
+void tst_gc::mark()
+{
+    QFETCH(int, markThreads);
+
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    mm->setMarkThreadCount(markThreads);
+
+    // Roughly what a big JSON payload looks like: many small objects, held by a few
+    // large arrays.
+    engine.evaluate(QStringLiteral(
+            "var payload = []; "
+            "for (var i = 0; i < 200; ++i) { "
+            "    var rows = []; "
+            "    for (var j = 0; j < 2000; ++j) "
+            "        rows.push({ id: j, name: 'row' + j, tags: [i, j], child: { value: i * j } }); "
+            "    payload.push(rows); "
+            "}"));
+
+    QBENCHMARK {
+        mm->runGC();
+    }
+}
+
+QTEST_MAIN(tst_gc)
+
+#include "tst_gc.moc"
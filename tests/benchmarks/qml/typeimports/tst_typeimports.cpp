@@ -5,6 +5,11 @@
 #include <QQmlEngine>
 #include <QQmlComponent>
 #include <QDebug>
+#include <QThread>
+#include <private/qqmlmetatype_p.h>
+
+#include <memory>
+#include <vector>
 
 class tst_typeimports : public QObject
 {
@@ -15,6 +20,8 @@ public:
 private slots:
     void cpp();
     void qml();
+    void concurrentLookups_data();
+    void concurrentLookups();
 
 private:
     QQmlEngine engine;
@@ -92,6 +99,47 @@ void tst_typeimports::qml()
     }
 }
 
+void tst_typeimports::concurrentLookups_data()
+{
+    QTest::addColumn<int>("threadCount");
+    for (int threadCount : { 1, 2, 4, 8 })
+        QTest::addRow("%d threads", threadCount) << threadCount;
+}
+
+// Looks types up the ways the type loader and the engine do, from several
+// threads at once.
+void tst_typeimports::concurrentLookups()
+{
+    QFETCH(int, threadCount);
+
+    static constexpr int LookupCount = 20000;
+    const QString url = TEST_FILE("QmlTestType1.qml").toString();
+    const QString typeName = QStringLiteral("QmlTestType1");
+    const QString elementName = QStringLiteral("TestType3");
+    const QString module = QStringLiteral("Qt.test");
+    QVERIFY(QQmlMetaType::typeForUrl(url, QHashedStringRef(typeName), false, nullptr).isValid());
+
+    auto lookup = [&]() {
+        for (int i = 0; i < LookupCount; ++i) {
+            QQmlMetaType::qmlType(&TestType2::staticMetaObject);
+            QQmlMetaType::qmlType(QMetaType::fromType<TestType4 *>());
+            QQmlMetaType::qmlType(QHashedStringRef(elementName), QHashedStringRef(module),
+                                  QTypeRevision::fromVersion(2, 0));
+            QQmlMetaType::typeForUrl(url, QHashedStringRef(typeName), false, nullptr);
+        }
+    };
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(QThread::create(lookup));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+}
+
 QTEST_MAIN(tst_typeimports)
 
 #include "tst_typeimports.moc"
@@ -0,0 +1,316 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+
+#include <QtQuick/qsgnode.h>
+#include <QtQuick/qsgflatcolormaterial.h>
+#include <QtQuick/private/qsgbatchrenderer_p.h>
+#include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsgdefaultrendercontext_p.h>
+#include <QtQuick/private/qsgrenderloop_p.h>
+
+#include <QtGui/private/qrhi_p.h>
+#include <QtGui/private/qrhinull_p.h>
+
+#include <cmath>
+#include <memory>
+
+// Renders scene graphs with the batch renderer on the Null QRhi backend, so
+// that only the CPU side of the renderer is measured.
+class HeadlessRenderer
+{
+public:
+    bool initialize(const QSize &size)
+    {
+        QRhiNullInitParams params;
+        m_rhi.reset(QRhi::create(QRhi::Null, &params));
+        if (!m_rhi)
+            return false;
+
+        QSGRenderLoop *renderLoop = QSGRenderLoop::instance();
+        QSGRendererInterface *rif = renderLoop->sceneGraphContext()->rendererInterface(nullptr);
+        if (!QSGRendererInterface::isApiRhiBased(rif->graphicsApi()))
+            return false;
+        m_renderContext = static_cast<QSGDefaultRenderContext *>(
+                renderLoop->createRenderContext(renderLoop->sceneGraphContext()));
+
+        QSGDefaultRenderContext::InitParams rcParams;
+        rcParams.rhi = m_rhi.get();
+        rcParams.initialSurfacePixelSize = size;
+        m_renderContext->initialize(&rcParams);
+        if (!m_renderContext->isValid())
+            return false;
+
+        m_texture.reset(m_rhi->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget));
+        m_depthStencil.reset(m_rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size, 1));
+        if (!m_texture->create() || !m_depthStencil->create())
+            return false;
+
+        QRhiTextureRenderTargetDescription description { QRhiColorAttachment(m_texture.get()) };
+        description.setDepthStencilBuffer(m_depthStencil.get());
+        m_renderTarget.reset(m_rhi->newTextureRenderTarget(description));
+        m_renderPass.reset(m_renderTarget->newCompatibleRenderPassDescriptor());
+        m_renderTarget->setRenderPassDescriptor(m_renderPass.get());
+        if (!m_renderTarget->create())
+            return false;
+
+        m_renderer.reset(static_cast<QSGBatchRenderer::Renderer *>(m_renderContext->createRenderer()));
+        m_renderer->setDeviceRect(size);
+        m_renderer->setViewportRect(size);
+        m_renderer->setProjectionMatrixToRect(QRectF(QPointF(), size));
+        return true;
+    }
+
+    ~HeadlessRenderer()
+    {
+        m_renderer.reset();
+        m_renderTarget.reset();
+        m_renderPass.reset();
+        m_depthStencil.reset();
+        m_texture.reset();
+        if (m_renderContext) {
+            m_renderContext->invalidate();
+            delete m_renderContext;
+        }
+    }
+
+    QSGBatchRenderer::Renderer *renderer() const { return m_renderer.get(); }
+
+    void renderFrame()
+    {
+        QRhiCommandBuffer *cb = nullptr;
+        m_rhi->beginOffscreenFrame(&cb);
+        m_renderer->setRenderTarget({ m_renderTarget.get(), m_renderPass.get(), cb });
+        m_renderer->renderScene();
+        m_rhi->endOffscreenFrame();
+    }
+
+private:
+    std::unique_ptr<QRhi> m_rhi;
+    QSGDefaultRenderContext *m_renderContext = nullptr;
+    std::unique_ptr<QRhiTexture> m_texture;
+    std::unique_ptr<QRhiRenderBuffer> m_depthStencil;
+    std::unique_ptr<QRhiTextureRenderTarget> m_renderTarget;
+    std::unique_ptr<QRhiRenderPassDescriptor> m_renderPass;
+    std::unique_ptr<QSGBatchRenderer::Renderer> m_renderer;
+};
+
+class tst_BatchRenderer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void alphaBatching_data();
+    void alphaBatching();
+    void batchUpload_data();
+    void batchUpload();
+    void mapPositions_data();
+    void mapPositions();
+};
+
+static QSGGeometryNode *createRectNode(const QRectF &rect, const QColor &color)
+{
+    QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 4);
+    QSGGeometry::updateRectGeometry(geometry, rect);
+
+    QSGFlatColorMaterial *material = new QSGFlatColorMaterial;
+    material->setColor(color);
+
+    QSGGeometryNode *node = new QSGGeometryNode;
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(material);
+    node->setFlag(QSGNode::OwnsMaterial);
+    return node;
+}
+
+void tst_BatchRenderer::alphaBatching_data()
+{
+    QTest::addColumn<int>("elementCount");
+
+    QTest::newRow("250") << 250;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("4000") << 4000;
+    QTest::newRow("16000") << 16000;
+}
+
+// Translucent elements of two incompatible materials, interleaved like the
+// glyphs and images of a page of rich text. None of them overlap, but the
+// elements skipped by a batch soon cover the whole scene, so every element
+// added to a batch needs an overlap check against the elements before it.
+void tst_BatchRenderer::alphaBatching()
+{
+    QFETCH(int, elementCount);
+
+    const QSize size(1024, 1024);
+    HeadlessRenderer headless;
+    if (!headless.initialize(size))
+        QSKIP("Cannot render with the Null QRhi backend");
+
+    const QColor first(255, 0, 0, 128);
+    const QColor second(0, 0, 255, 128);
+    const int columns = int(std::ceil(std::sqrt(double(elementCount))));
+    const qreal cell = qreal(size.width()) / columns;
+
+    QSGRootNode root;
+    for (int i = 0; i < elementCount; ++i) {
+        const QRectF rect((i % columns) * cell, (i / columns) * cell, cell * 0.75, cell * 0.75);
+        root.appendChildNode(createRectNode(rect, i % 2 ? second : first));
+    }
+    headless.renderer()->setRootNode(&root);
+    headless.renderFrame();
+
+    // Changing the material of the first element invalidates all batches
+    QSGGeometryNode *changing = static_cast<QSGGeometryNode *>(root.firstChild());
+    QSGFlatColorMaterial *material = static_cast<QSGFlatColorMaterial *>(changing->material());
+    bool flip = false;
+    QBENCHMARK {
+        flip = !flip;
+        material->setColor(flip ? QColor(0, 255, 0, 128) : first);
+        changing->markDirty(QSGNode::DirtyMaterial);
+        headless.renderFrame();
+    }
+
+    headless.renderer()->setRootNode(nullptr);
+}
+
+void tst_BatchRenderer::batchUpload_data()
+{
+    QTest::addColumn<int>("elementCount");
+    QTest::addColumn<int>("uploadThreads");
+
+    for (int elementCount : { 4000, 16000, 64000 }) {
+        for (int uploadThreads : { 0, 4 }) {
+            QTest::addRow("%d elements, %d threads", elementCount, uploadThreads)
+                    << elementCount << uploadThreads;
+        }
+    }
+}
+
+// Opaque elements of many different colors, all of which move in each frame,
+// so that every batch is merged and uploaded again.
+void tst_BatchRenderer::batchUpload()
+{
+    QFETCH(int, elementCount);
+    QFETCH(int, uploadThreads);
+
+    static constexpr int ColorCount = 64;
+
+    const QByteArray previousThreads = qgetenv("QSG_RENDERER_UPLOAD_THREADS");
+    qputenv("QSG_RENDERER_UPLOAD_THREADS", QByteArray::number(uploadThreads));
+    const QSize size(1024, 1024);
+    HeadlessRenderer headless;
+    const bool initialized = headless.initialize(size);
+    if (previousThreads.isNull())
+        qunsetenv("QSG_RENDERER_UPLOAD_THREADS");
+    else
+        qputenv("QSG_RENDERER_UPLOAD_THREADS", previousThreads);
+    if (!initialized)
+        QSKIP("Cannot render with the Null QRhi backend");
+
+    const int columns = int(std::ceil(std::sqrt(double(elementCount))));
+    const qreal cell = qreal(size.width()) / columns;
+
+    QSGRootNode root;
+    QList<QSGGeometryNode *> nodes;
+    nodes.reserve(elementCount);
+    for (int i = 0; i < elementCount; ++i) {
+        const QRectF rect((i % columns) * cell, (i / columns) * cell, cell * 0.75, cell * 0.75);
+        QSGGeometryNode *node = createRectNode(rect, QColor::fromHsv(i % ColorCount * 360 / ColorCount, 255, 255));
+        root.appendChildNode(node);
+        nodes.append(node);
+    }
+    headless.renderer()->setRootNode(&root);
+    headless.renderFrame();
+
+    qreal offset = 0;
+    QBENCHMARK {
+        offset = offset > 0 ? 0 : cell * 0.25;
+        for (int i = 0; i < elementCount; ++i) {
+            QSGGeometryNode *node = nodes.at(i);
+            QSGGeometry::updateRectGeometry(node->geometry(),
+                                            QRectF((i % columns) * cell + offset, (i / columns) * cell,
+                                                   cell * 0.75, cell * 0.75));
+            node->markDirty(QSGNode::DirtyGeometry);
+        }
+        headless.renderFrame();
+    }
+
+    headless.renderer()->setRootNode(nullptr);
+}
+
+void tst_BatchRenderer::mapPositions_data()
+{
+    QTest::addColumn<int>("stride");
+    QTest::addColumn<bool>("translateOnly");
+    QTest::addColumn<bool>("vectorized");
+
+    const struct {
+        const char *name;
+        int stride;
+    } layouts[] = {
+        { "Point2D", int(sizeof(QSGGeometry::Point2D)) },
+        { "ColoredPoint2D", int(sizeof(QSGGeometry::ColoredPoint2D)) },
+        { "TexturedPoint2D", int(sizeof(QSGGeometry::TexturedPoint2D)) },
+    };
+    for (const auto &layout : layouts) {
+        for (bool translateOnly : { true, false }) {
+            for (bool vectorized : { false, true }) {
+                QTest::addRow("%s, %s, %s", layout.name,
+                              translateOnly ? "translate" : "rotate",
+                              vectorized ? "vectorized" : "scalar")
+                        << layout.stride << translateOnly << vectorized;
+            }
+        }
+    }
+}
+
+// The vertex transform of uploading merged batches, for the vertex count of
+// a screen full of text.
+void tst_BatchRenderer::mapPositions()
+{
+    QFETCH(int, stride);
+    QFETCH(bool, translateOnly);
+    QFETCH(bool, vectorized);
+
+    const int count = 100000;
+    QByteArray vertices(count * stride, Qt::Uninitialized);
+    for (int i = 0; i < count; ++i) {
+        float *position = reinterpret_cast<float *>(vertices.data() + i * stride);
+        position[0] = float(i % 1000);
+        position[1] = float(i / 1000);
+    }
+
+    QMatrix4x4 matrix;
+    matrix.translate(10, 20);
+    if (!translateOnly)
+        matrix.rotate(30, 0, 0, 1);
+    QCOMPARE(matrix.flags() == QMatrix4x4::Translation, translateOnly);
+
+    // Both paths give the same result
+    QByteArray scalar = vertices;
+    QByteArray vector = vertices;
+    QSGBatchRenderer::qsg_mapPositionsScalar(scalar.data(), count, stride, matrix);
+    QSGBatchRenderer::qsg_mapPositions(vector.data(), count, stride, matrix);
+    for (int i = 0; i < count; ++i) {
+        const float *s = reinterpret_cast<const float *>(scalar.constData() + i * stride);
+        const float *v = reinterpret_cast<const float *>(vector.constData() + i * stride);
+        QVERIFY(qAbs(s[0] - v[0]) < 0.001f && qAbs(s[1] - v[1]) < 0.001f);
+    }
+
+    char *data = vertices.data();
+    if (vectorized) {
+        QBENCHMARK {
+            QSGBatchRenderer::qsg_mapPositions(data, count, stride, matrix);
+        }
+    } else {
+        QBENCHMARK {
+            QSGBatchRenderer::qsg_mapPositionsScalar(data, count, stride, matrix);
+        }
+    }
+}
+
+QTEST_MAIN(tst_BatchRenderer)
+
+#include "tst_batchrenderer.moc"
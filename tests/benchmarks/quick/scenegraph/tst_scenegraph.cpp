@@ -0,0 +1,287 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+#include <QtQuick/qquickimageprovider.h>
+#include <QtQuick/qquickitem.h>
+#include <QtQuick/qquickrendercontrol.h>
+#include <QtQuick/qquickrendertarget.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/private/qquickframetimings_p.h>
+#include <QtQuick/private/qquickrendercontrol_p.h>
+#include <QtQuick/private/qquickwindow_p.h>
+#include <QtQuick/private/qsgrenderer_p.h>
+
+#include <QtGui/private/qrhi_p.h>
+
+#include <memory>
+
+// Renders Qt Quick scenes through QQuickRenderControl, either with the
+// default adaptation on the Null QRhi backend, or with the software
+// adaptation into an image. The adaptation cannot change within a process,
+// so the software variant is a separate benchmark built from this file.
+class SceneRenderer
+{
+public:
+    bool initialize(QQuickItem *rootItem)
+    {
+        const QSize size = rootItem->size().toSize();
+        m_window.reset(new QQuickWindow(&m_renderControl));
+        m_window->setGeometry(0, 0, size.width(), size.height());
+        m_window->contentItem()->setSize(size);
+        rootItem->setParentItem(m_window->contentItem());
+
+        if (QQuickWindow::graphicsApi() == QSGRendererInterface::Software) {
+            m_image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+            m_window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&m_image));
+        } else {
+            if (!m_renderControl.initialize())
+                return false;
+            QRhi *rhi = QQuickRenderControlPrivate::get(&m_renderControl)->rhi;
+            m_texture.reset(rhi->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget));
+            m_depthStencil.reset(rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size, 1));
+            if (!m_texture->create() || !m_depthStencil->create())
+                return false;
+
+            QRhiTextureRenderTargetDescription description { QRhiColorAttachment(m_texture.get()) };
+            description.setDepthStencilBuffer(m_depthStencil.get());
+            m_renderTarget.reset(rhi->newTextureRenderTarget(description));
+            m_renderPass.reset(m_renderTarget->newCompatibleRenderPassDescriptor());
+            m_renderTarget->setRenderPassDescriptor(m_renderPass.get());
+            if (!m_renderTarget->create())
+                return false;
+            m_window->setRenderTarget(QQuickRenderTarget::fromRhiRenderTarget(m_renderTarget.get()));
+        }
+
+        // Makes the renderer measure the parts of each frame
+        QQuickWindowPrivate::get(m_window.get())->frameTimings->setEnabled(true);
+        return true;
+    }
+
+    ~SceneRenderer()
+    {
+        m_renderTarget.reset();
+        m_renderPass.reset();
+        m_depthStencil.reset();
+        m_texture.reset();
+        m_window.reset();
+    }
+
+    void renderFrame()
+    {
+        m_renderControl.polishItems();
+        m_renderControl.beginFrame();
+        QElapsedTimer timer;
+        timer.start();
+        m_renderControl.sync();
+        m_syncTime = timer.nsecsElapsed();
+        m_renderControl.render();
+        m_renderControl.endFrame();
+    }
+
+    // In nanoseconds
+    qint64 lastSyncTime() const { return m_syncTime; }
+    const QSGRenderer *renderer() const { return QQuickWindowPrivate::get(m_window.get())->renderer; }
+
+private:
+    QQuickRenderControl m_renderControl;
+    std::unique_ptr<QQuickWindow> m_window;
+    QImage m_image;
+    std::unique_ptr<QRhiTexture> m_texture;
+    std::unique_ptr<QRhiRenderBuffer> m_depthStencil;
+    std::unique_ptr<QRhiTextureRenderTarget> m_renderTarget;
+    std::unique_ptr<QRhiRenderPassDescriptor> m_renderPass;
+    qint64 m_syncTime = 0;
+};
+
+// Small opaque images in a few colors, so that they share an atlas
+class ImageProvider : public QQuickImageProvider
+{
+public:
+    ImageProvider() : QQuickImageProvider(QQuickImageProvider::Image) { }
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &) override
+    {
+        QImage image(32, 32, QImage::Format_RGB32);
+        image.fill(QColor::fromHsv(id.toInt() * 360 / ColorCount, 255, 255));
+        *size = image.size();
+        return image;
+    }
+
+    static constexpr int ColorCount = 64;
+};
+
+class tst_SceneGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Phase {
+        Frame,
+        Sync,
+        RenderLists,
+        Batching,
+        Upload,
+        Record
+    };
+    Q_ENUM(Phase)
+
+private slots:
+    void initTestCase();
+    void render_data();
+    void render();
+};
+
+void tst_SceneGraph::initTestCase()
+{
+#ifdef SCENEGRAPH_BENCHMARK_SOFTWARE
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+#else
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Null);
+#endif
+}
+
+// Each scene is a 1024x1024 item with a shift property that moves all of its
+// content when changed.
+static QByteArray sceneSource(const QByteArray &scene)
+{
+    QByteArray delegate;
+    QByteArray count;
+    if (scene == "rectangles") {
+        count = "4096";
+        delegate = "Rectangle { x: (index % 64) * 16 + root.shift; y: Math.floor(index / 64) * 16;"
+                   " width: 12; height: 12; color: Qt.hsva((index % 64) / 64, 1, 1, 1) }";
+    } else if (scene == "images") {
+        count = "4096";
+        delegate = "Image { x: (index % 64) * 16 + root.shift; y: Math.floor(index / 64) * 16;"
+                   " width: 12; height: 12; source: 'image://bench/' + (index % 64) }";
+    } else if (scene == "text") {
+        count = "400";
+        delegate = "Text { x: (index % 4) * 256 + root.shift; y: Math.floor(index / 4) * 10;"
+                   " font.pixelSize: 9; text: 'The quick brown fox jumps over the lazy dog' }";
+    } else if (scene == "clips") {
+        count = "256";
+        delegate = "Item { x: (index % 16) * 64 + root.shift; y: Math.floor(index / 16) * 64;"
+                   " width: 60; height: 60; clip: true;"
+                   " Repeater { model: 16; Rectangle { x: (index % 4) * 16 - 4; y: Math.floor(index / 4) * 16 - 4;"
+                   " width: 20; height: 20; color: Qt.hsva(index / 16, 1, 1, 1) } } }";
+    } else if (scene == "opacity") {
+        // Chains of nested translucent items, each with a rectangle
+        count = "256";
+        QByteArray chain = "Rectangle { width: 8; height: 8; color: 'blue' }";
+        for (int depth = 0; depth < 8; ++depth) {
+            chain = "Item { x: 4; y: 4; opacity: 0.9;"
+                    " Rectangle { width: 8; height: 8; color: Qt.hsva(" + QByteArray::number(depth) + " / 8, 1, 1, 1) } "
+                    + chain + " }";
+        }
+        delegate = "Item { x: (index % 16) * 64 + root.shift; y: Math.floor(index / 16) * 64; " + chain + " }";
+    }
+
+    return "import QtQuick\n"
+           "Item {\n"
+           "    id: root\n"
+           "    property real shift: 0\n"
+           "    width: 1024; height: 1024\n"
+           "    Repeater { model: " + count + "; " + delegate + " }\n"
+           "}\n";
+}
+
+void tst_SceneGraph::render_data()
+{
+    QTest::addColumn<QByteArray>("scene");
+    QTest::addColumn<bool>("moving");
+    QTest::addColumn<Phase>("phase");
+
+    const QMetaEnum phases = QMetaEnum::fromType<Phase>();
+    for (const char *scene : { "rectangles", "images", "text", "clips", "opacity" }) {
+        for (bool moving : { false, true }) {
+            for (int phase = Frame; phase <= Record; ++phase) {
+                QTest::addRow("%s, %s, %s", scene, moving ? "moving" : "static", phases.valueToKey(phase))
+                        << QByteArray(scene) << moving << Phase(phase);
+            }
+        }
+    }
+}
+
+// Frame measures polishing, synchronizing and rendering whole frames. The
+// other phases report the average time a part of the frame took over a fixed
+// number of frames, as measured by the scene graph. Building the render lists,
+// batching and uploading are parts of the preparation of the render pass,
+// while Record covers recording the draw calls, or painting with the software
+// adaptation.
+void tst_SceneGraph::render()
+{
+    QFETCH(QByteArray, scene);
+    QFETCH(bool, moving);
+    QFETCH(Phase, phase);
+
+    static constexpr int FrameCount = 100;
+
+    const bool software = QQuickWindow::graphicsApi() == QSGRendererInterface::Software;
+    if (software && phase == Upload)
+        QSKIP("The software adaptation uploads nothing");
+
+    QQmlEngine engine;
+    engine.addImageProvider(QStringLiteral("bench"), new ImageProvider);
+    QQmlComponent component(&engine);
+    component.setData(sceneSource(scene), QUrl());
+    std::unique_ptr<QQuickItem> rootItem(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(rootItem, qPrintable(component.errorString()));
+
+    SceneRenderer sceneRenderer;
+    if (!sceneRenderer.initialize(rootItem.get()))
+        QSKIP("Cannot render with the Null QRhi backend");
+    sceneRenderer.renderFrame();
+
+    bool shifted = false;
+    auto advance = [&] {
+        if (moving) {
+            shifted = !shifted;
+            rootItem->setProperty("shift", shifted ? 2 : 0);
+        }
+    };
+
+    if (phase == Frame) {
+        QBENCHMARK {
+            advance();
+            sceneRenderer.renderFrame();
+        }
+    } else {
+        qint64 total = 0;
+        for (int frame = 0; frame < FrameCount; ++frame) {
+            advance();
+            sceneRenderer.renderFrame();
+            const QSGRenderer *renderer = sceneRenderer.renderer();
+            switch (phase) {
+            case Sync:
+                total += sceneRenderer.lastSyncTime();
+                break;
+            case RenderLists:
+                total += renderer->lastRenderListTime();
+                break;
+            case Batching:
+                total += renderer->lastBatchingTime();
+                break;
+            case Upload:
+                total += renderer->lastUploadTime();
+                break;
+            case Record:
+                total += renderer->lastRecordTime();
+                break;
+            default:
+                break;
+            }
+        }
+        QTest::setBenchmarkResult(qreal(total) / FrameCount, QTest::WalltimeNanoseconds);
+    }
+
+    rootItem->setParentItem(nullptr);
+}
+
+QTEST_MAIN(tst_SceneGraph)
+
+#include "tst_scenegraph.moc"
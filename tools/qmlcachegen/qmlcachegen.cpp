@@ -21,6 +21,7 @@
 #include <private/qqmljsloadergenerator_p.h>
 #include <private/qqmljscompiler_p.h>
 #include <private/qresourcerelocater_p.h>
+#include <private/qv4compilationunitbundle_p.h>
 
 #include <algorithm>
 
@@ -53,6 +54,69 @@ static bool argumentsFromCommandLineAndFile(QStringList& allArguments, const QSt
     return true;
 }
 
+static QString bundleUrl(const QString &inputFile, const QQmlJSResourceFileMapper &fileMapper)
+{
+    const QStringList resourcePaths = fileMapper.resourcePaths(
+                QQmlJSResourceFileMapper::localFileFilter(inputFile));
+    if (!resourcePaths.isEmpty())
+        return QUrl(QStringLiteral("qrc:") + resourcePaths.first()).toString();
+    return QUrl::fromLocalFile(QFileInfo(inputFile).absoluteFilePath()).toString();
+}
+
+static bool generateBundle(const QStringList &sources, const QQmlJSResourceFileMapper &fileMapper,
+                           const QString &outputFileName)
+{
+    QList<QV4::CompilationUnitBundle::Unit> units;
+    for (const QString &inputFile : sources) {
+        QV4::CompilationUnitBundle::Unit unit;
+        unit.url = bundleUrl(inputFile, fileMapper);
+
+        const QQmlJSSaveFunction saveFunction = [&unit](
+                const QV4::CompiledData::SaveableUnitPointer &saveable,
+                const QQmlJSAotFunctionMap &, QString *) {
+            return saveable.saveToDisk<char>([&unit](const char *data, quint32 size) {
+                unit.data = QByteArray(data, size);
+                return true;
+            });
+        };
+
+        QQmlJSCompileError error;
+        if (inputFile.endsWith(QLatin1String(".qml"))) {
+            if (!qCompileQmlFile(inputFile, saveFunction, nullptr, &error,
+                                 /* storeSourceLocation */ false)) {
+                error.augment(QStringLiteral("Error compiling qml file: ")).print();
+                return false;
+            }
+        } else if (inputFile.endsWith(QLatin1String(".js"))
+                   || inputFile.endsWith(QLatin1String(".mjs"))) {
+            if (!qCompileJSFile(inputFile, unit.url, saveFunction, &error)) {
+                error.augment(QLatin1String("Error compiling js file: ")).print();
+                return false;
+            }
+        } else {
+            fprintf(stderr, "Ignoring %s input file as it is not QML source code\n",
+                    qPrintable(inputFile));
+            continue;
+        }
+
+        // Units of local files are checked against the time stamp of their source when
+        // loaded, so that an outdated bundle does not shadow edited files.
+        if (QUrl(unit.url).isLocalFile()) {
+            auto *header = reinterpret_cast<QV4::CompiledData::Unit *>(unit.data.data());
+            header->sourceTimeStamp = QFileInfo(inputFile).lastModified().toMSecsSinceEpoch();
+        }
+        units.append(std::move(unit));
+    }
+
+    QString errorString;
+    if (!QV4::CompilationUnitBundle::write(outputFileName, units, &errorString)) {
+        fprintf(stderr, "Error writing bundle %s: %s\n", qPrintable(outputFileName),
+                qPrintable(errorString));
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char **argv)
 {
     // Produce reliably the same output for the same input by disabling QHash's random seeding.
@@ -99,7 +163,7 @@ int main(int argc, char **argv)
                     "main", "Generate only byte code for bindings and functions, no C++ code"));
     parser.addOption(onlyBytecode);
 
-    QCommandLineOption outputFileOption(QStringLiteral("o"), QCoreApplication::translate("main", "Output file name"), QCoreApplication::translate("main", "file name"));
+    QCommandLineOption outputFileOption(QStringLiteral("o"), QCoreApplication::translate("main", "Output file name. If it ends with .qmlcbundle, all input files are compiled into one compilation unit bundle"), QCoreApplication::translate("main", "file name"));
     parser.addOption(outputFileOption);
 
     parser.addPositionalArgument(QStringLiteral("[qml file]"),
@@ -119,6 +183,7 @@ int main(int argc, char **argv)
         GenerateCacheFile,
         GenerateLoader,
         GenerateLoaderStandAlone,
+        GenerateBundle,
     } target = GenerateCacheFile;
 
     QString outputFileName;
@@ -134,10 +199,14 @@ int main(int argc, char **argv)
     if (target == GenerateLoader && parser.isSet(resourceNameOption))
         target = GenerateLoaderStandAlone;
 
+    if (outputFileName.endsWith(QLatin1String(".qmlcbundle")))
+        target = GenerateBundle;
+
     const QStringList sources = parser.positionalArguments();
     if (sources.isEmpty()){
         parser.showHelp();
-    } else if (sources.size() > 1 && (target != GenerateLoader && target != GenerateLoaderStandAlone)) {
+    } else if (sources.size() > 1 && (target != GenerateLoader && target != GenerateLoaderStandAlone
+                                      && target != GenerateBundle)) {
         fprintf(stderr, "%s\n", qPrintable(QStringLiteral("Too many input files specified: '") + sources.join(QStringLiteral("' '")) + QLatin1Char('\'')));
         return EXIT_FAILURE;
     }
@@ -162,6 +231,11 @@ int main(int argc, char **argv)
         return EXIT_SUCCESS;
     }
 
+    if (target == GenerateBundle) {
+        const QQmlJSResourceFileMapper fileMapper(parser.values(resourceOption));
+        return generateBundle(sources, fileMapper, outputFileName) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     if (target == GenerateLoaderStandAlone) {
         QQmlJSCompileError error;
         if (!qQmlJSGenerateLoader(sources, outputFileName,